@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdarg.h>
 
 // SIMD includes on supported platforms
 #if !defined(CLAY_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
@@ -49,6 +50,34 @@
 #define CLAY_DLL_EXPORT
 #endif
 
+// Holds the context passed to the Ctx variants of the API and the CLAY() element latch, so that threads never share either of them.
+// CLAY_DISABLE_THREAD_LOCAL is for targets without thread local storage, where the Ctx variants can't be used concurrently.
+#if defined(CLAY_DISABLE_THREAD_LOCAL)
+#define CLAY__THREAD_LOCAL_STORAGE
+#elif defined(__cplusplus)
+#define CLAY__THREAD_LOCAL_STORAGE thread_local
+#elif defined(_MSC_VER)
+#define CLAY__THREAD_LOCAL_STORAGE __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define CLAY__THREAD_LOCAL_STORAGE _Thread_local
+#else
+#define CLAY__THREAD_LOCAL_STORAGE __thread
+#endif
+
+// With CLAY_THREAD_LOCAL_CONTEXT defined, each thread has its own current context, so separate contexts can be laid out concurrently
+#ifdef CLAY_THREAD_LOCAL_CONTEXT
+#define CLAY__THREAD_LOCAL CLAY__THREAD_LOCAL_STORAGE
+#else
+#define CLAY__THREAD_LOCAL
+#endif
+
+// Lets GCC and Clang check the arguments passed to printf style functions
+#if defined(__GNUC__) || defined(__clang__)
+#define CLAY__PRINTF_FORMAT(formatIndex, firstArgumentIndex) __attribute__((format(printf, formatIndex, firstArgumentIndex)))
+#else
+#define CLAY__PRINTF_FORMAT(formatIndex, firstArgumentIndex)
+#endif
+
 // Public Macro API ------------------------
 
 #define CLAY__MAX(x, y) (((x) > (y)) ? (x) : (y))
@@ -56,6 +85,8 @@
 
 #define CLAY_TEXT_CONFIG(...) Clay__StoreTextElementConfig(CLAY__CONFIG_WRAPPER(Clay_TextElementConfig, __VA_ARGS__))
 
+#define CLAY_TEXT_CONFIG_STATIC(...) Clay__StoreStaticTextElementConfig(CLAY__CONFIG_WRAPPER(Clay_TextElementConfig, __VA_ARGS__))
+
 #define CLAY_BORDER_OUTSIDE(widthValue) {widthValue, widthValue, widthValue, widthValue, 0}
 
 #define CLAY_BORDER_ALL(widthValue) {widthValue, widthValue, widthValue, widthValue, widthValue}
@@ -101,7 +132,7 @@
 
 #define CLAY_STRING_CONST(string) { .isStaticallyAllocated = true, .length = CLAY__STRING_LENGTH(CLAY__ENSURE_STRING_LITERAL(string)), .chars = (string) }
 
-static uint8_t CLAY__ELEMENT_DEFINITION_LATCH;
+static CLAY__THREAD_LOCAL_STORAGE uint8_t CLAY__ELEMENT_DEFINITION_LATCH;
 
 // GCC marks the above CLAY__ELEMENT_DEFINITION_LATCH as an unused variable for files that include clay.h but don't declare any layout
 // This is to suppress that warning
@@ -145,12 +176,33 @@ static inline void Clay__SuppressUnusedLatchDefinitionVariableWarning(void) { (v
 // As well as by passing a predefined declaration struct
 // Clay_ElementDeclaration declarationStruct = ...
 // CLAY(declarationStruct);
+// CLAY_STATIC() declares an element from a pointer to a Clay_ElementDeclaration that stays valid and unmodified for the lifetime
+// of the context, such as a static const. The declaration is processed once and then referenced by pointer on subsequent frames.
+// static const Clay_ElementDeclaration rowDeclaration = { .layout = { .padding = { 8, 8, 8, 8 } }, .backgroundColor = { 40, 40, 40, 255 } };
+// CLAY_STATIC(&rowDeclaration) { ...children }
+#define CLAY_STATIC(declarationPtr)                                                                                                                         \
+    for (                                                                                                                                                   \
+        CLAY__ELEMENT_DEFINITION_LATCH = (Clay__OpenElement(), Clay__ConfigureOpenElementStatic(declarationPtr), 0);                                        \
+        CLAY__ELEMENT_DEFINITION_LATCH < 1;                                                                                                                 \
+        CLAY__ELEMENT_DEFINITION_LATCH=1, Clay__CloseElement()                                                                                              \
+    )
+
 #define CLAY__WRAPPER_TYPE(type) Clay__##type##Wrapper
 #define CLAY__WRAPPER_STRUCT(type) typedef struct { type wrapped; } CLAY__WRAPPER_TYPE(type)
 #define CLAY__CONFIG_WRAPPER(type, ...) (CLAY__INIT(CLAY__WRAPPER_TYPE(type)) { __VA_ARGS__ }).wrapped
 
 #define CLAY_TEXT(text, textConfig) Clay__OpenTextElement(text, textConfig)
 
+// Declares a text element for very large text, such as a log file inside a scroll container. Only the blocks of text near the visible
+// region are measured and wrapped, so the cost of each frame doesn't depend on the length of the text. See Clay_LargeTextState.
+// CLAY_LARGE_TEXT(CLAY_ID("Log"), logText, CLAY_TEXT_CONFIG({ .fontSize = 16 }), &logState);
+#define CLAY_LARGE_TEXT(id, text, textConfig, state) Clay__OpenLargeTextElement(id, text, textConfig, state)
+
+// Declares a text element for text that is edited in place, such as the buffer of a text editor. When an edit has been reported with
+// Clay_ReportTextEdit(), only the words touched by the edit are measured again. See Clay_EditableTextState.
+// CLAY_EDITABLE_TEXT(editorText, CLAY_TEXT_CONFIG({ .fontSize = 16 }), &editorState);
+#define CLAY_EDITABLE_TEXT(text, textConfig, state) Clay__OpenEditableTextElement(text, textConfig, state)
+
 #ifdef __cplusplus
 
 #define CLAY__INIT(type) type
@@ -550,6 +602,17 @@ typedef struct Clay_BorderElementConfig {
 
 CLAY__WRAPPER_STRUCT(Clay_BorderElementConfig);
 
+// Layer -----------------------------
+
+// Controls whether an element and its children are marked as a layer that renderers can cache.
+typedef struct Clay_LayerElementConfig {
+    // Wraps the render commands of this element and its non floating descendants in LAYER_BEGIN and LAYER_END render commands.
+    // Renderers can draw the contents of a layer to an offscreen surface once, and composite that surface for as long as the layer's contentHash is unchanged.
+    bool cached;
+} Clay_LayerElementConfig;
+
+CLAY__WRAPPER_STRUCT(Clay_LayerElementConfig);
+
 // Render Command Data -----------------------------
 
 // Render command data when commandType == CLAY_RENDER_COMMAND_TYPE_TEXT
@@ -608,6 +671,13 @@ typedef struct Clay_ScrollRenderData {
     bool vertical;
 } Clay_ClipRenderData;
 
+// Render command data when commandType == CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN || commandType == CLAY_RENDER_COMMAND_TYPE_LAYER_END
+typedef struct Clay_LayerRenderData {
+    // A hash of every render command between LAYER_BEGIN and LAYER_END, with positions relative to the layer's bounding box.
+    // If the hash and the size of the bounding box match a previous frame, the contents of the layer look exactly the same, even if the layer has moved.
+    uint32_t contentHash;
+} Clay_LayerRenderData;
+
 // Render command data when commandType == CLAY_RENDER_COMMAND_TYPE_BORDER
 typedef struct Clay_BorderRenderData {
     // Controls a shared color for all this element's borders.
@@ -634,6 +704,8 @@ typedef union Clay_RenderData {
     Clay_BorderRenderData border;
     // Render command data when commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START|END
     Clay_ClipRenderData clip;
+    // Render command data when commandType == CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN|END
+    Clay_LayerRenderData layer;
 } Clay_RenderData;
 
 // Miscellaneous Structs & Enums ---------------------------------
@@ -661,6 +733,63 @@ typedef struct Clay_ElementData {
     bool found;
 } Clay_ElementData;
 
+// Describes the items of a virtual list, see Clay_GetVirtualListRange.
+typedef struct Clay_VirtualListConfig {
+    int32_t itemCount; // The total number of items in the list.
+    float itemExtent; // The height (or width, for CLAY_LEFT_TO_RIGHT lists) of every item, if getItemOffset is not provided.
+    // Optional, for lists with items of varying size. Returns the distance from the start of the first item to the start of the item at itemIndex,
+    // including the childGap after each preceding item. Will also be called with itemIndex == itemCount, and must never decrease as itemIndex increases.
+    float (*getItemOffset)(int32_t itemIndex, void *userData);
+    void *userData; // A pointer that will be transparently passed through to getItemOffset.
+    int32_t overscan; // The number of extra items to include on each side of the visible range.
+} Clay_VirtualListConfig;
+
+// The window of items in a virtual list that should be declared this frame, see Clay_GetVirtualListRange.
+typedef struct Clay_VirtualListRange {
+    int32_t startIndex; // The index of the first item to declare.
+    int32_t endIndex; // One past the index of the last item to declare.
+    float leadingSpace; // The size of a spacer element to declare before the first item, if startIndex > 0.
+    float trailingSpace; // The size of a spacer element to declare after the last item, if endIndex < itemCount.
+} Clay_VirtualListRange;
+
+// Persistent state for one block of a large text element, see Clay_LargeTextState.
+typedef struct Clay_LargeTextBlock {
+    float height; // The height of the block when it was last laid out.
+    float width; // The width the block was wrapped to when it was last laid out, or 0 if it hasn't been laid out yet.
+} Clay_LargeTextBlock;
+
+// Persistent state for a text element declared with CLAY_LARGE_TEXT(). Zero initialize it, set the user fields, and keep it for as long as
+// the same text is shown. The text is split into blocks of around blockSize bytes, starting after a newline, and only the blocks around
+// the visible region of the innermost clip container are declared. The rest are represented by spacers with estimated heights.
+typedef struct Clay_LargeTextState {
+    // User fields
+    Clay_LargeTextBlock *blocks; // Storage for blockCapacity blocks. If the text is longer than blockCapacity * blockSize, the block size is increased to fit.
+    int32_t blockCapacity;
+    int32_t blockSize; // The size of each block in bytes. Defaults to 4096.
+    float prefetch; // The distance above and below the visible region to declare blocks in. Defaults to the height of the visible region.
+    // Internal fields
+    int32_t layoutBlockSize; // The block size that the recorded block heights were laid out with
+    int32_t declaredStartIndex; // The range of blocks that was declared last frame
+    int32_t declaredEndIndex;
+    int32_t anchorIndex; // The first visible block last frame, which is kept in place when the estimated heights above it change
+    float childOffset; // The vertical .childOffset of the clip container last frame
+} Clay_LargeTextState;
+
+// Persistent state for a text element declared with CLAY_EDITABLE_TEXT(). Zero initialize it and keep it for as long as the text element
+// exists. Edits reported with Clay_ReportTextEdit() are merged until the element is next declared. If the text changes without an edit
+// being reported, or the previous measurement is no longer cached, the text is measured again from scratch.
+typedef struct Clay_EditableTextState {
+    // Internal fields
+    int32_t editStart; // The changed region of the text, from editStart to editRemovedEnd before the edits and to editInsertedEnd after them
+    int32_t editRemovedEnd;
+    int32_t editInsertedEnd;
+    int32_t textLength; // The length of the text when it was last measured
+    uint32_t measureTextCacheId; // The text measurement cache entry of the text when it was last measured
+    uint16_t fontId; // The font of the text when it was last measured
+    uint16_t fontSize;
+    uint16_t letterSpacing;
+} Clay_EditableTextState;
+
 // Used by renderers to determine specific handling for each render command.
 typedef CLAY_PACKED_ENUM {
     // This command type should be skipped.
@@ -679,6 +808,10 @@ typedef CLAY_PACKED_ENUM {
     CLAY_RENDER_COMMAND_TYPE_SCISSOR_END,
     // The renderer should provide a custom implementation for handling this render command based on its .customData
     CLAY_RENDER_COMMAND_TYPE_CUSTOM,
+    // The commands up to the matching LAYER_END can be drawn to an offscreen surface the size of the boundingBox, and cached using .contentHash
+    CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN,
+    // Ends the layer started by the matching LAYER_BEGIN. Renderers that don't cache layers can ignore both commands.
+    CLAY_RENDER_COMMAND_TYPE_LAYER_END,
 } Clay_RenderCommandType;
 
 typedef struct Clay_RenderCommand {
@@ -702,6 +835,8 @@ typedef struct Clay_RenderCommand {
     // CLAY_RENDER_COMMAND_TYPE_SCISSOR_START - The renderer should begin clipping all future draw commands, only rendering content that falls within the provided boundingBox.
     // CLAY_RENDER_COMMAND_TYPE_SCISSOR_END - The renderer should finish any previously active clipping, and begin rendering elements in full again.
     // CLAY_RENDER_COMMAND_TYPE_CUSTOM - The renderer should provide a custom implementation for handling this render command based on its .customData
+    // CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN - The commands up to the matching LAYER_END can be drawn to an offscreen surface the size of the boundingBox, and cached using .contentHash
+    // CLAY_RENDER_COMMAND_TYPE_LAYER_END - Ends the layer started by the matching LAYER_BEGIN. Renderers that don't cache layers can ignore both commands.
     Clay_RenderCommandType commandType;
 } Clay_RenderCommand;
 
@@ -715,6 +850,40 @@ typedef struct Clay_RenderCommandArray {
     Clay_RenderCommand* internalArray;
 } Clay_RenderCommandArray;
 
+// A run of consecutive render commands that can be drawn without changing renderer state.
+// Generated by Clay_EndLayout() when draw batching is enabled, see Clay_SetDrawBatchingEnabled().
+typedef struct Clay_DrawBatch {
+    // The index in the render command array of the first command in this batch.
+    int32_t startIndex;
+    // The number of consecutive render commands in this batch.
+    int32_t count;
+    // Commands in the same batch share a key. The top 4 bits hold the command type, and the rest hold the fontId
+    // for text or a hash of imageData for images. Different images can share a hash, so the key is only a hint and
+    // renderers should still read the data of each command.
+    uint32_t key;
+} Clay_DrawBatch;
+
+// A sized array of draw batches.
+typedef struct Clay_DrawBatchArray {
+    // The underlying max capacity of the array, not necessarily all initialized.
+    int32_t capacity;
+    // The number of initialized elements in this array. Used for loops and iteration.
+    int32_t length;
+    // A pointer to the first element in the internal array.
+    Clay_DrawBatch* internalArray;
+} Clay_DrawBatchArray;
+
+// The output of one call to Clay_EndLayout(), acquired with Clay_AcquireFrame() so that it can be consumed while later frames are laid out.
+typedef struct Clay_Frame {
+    // The render commands returned by Clay_EndLayout().
+    Clay_RenderCommandArray renderCommands;
+    // The draw batches for renderCommands, see Clay_GetDrawBatches().
+    Clay_DrawBatchArray drawBatches;
+    // The context and frame buffer that own the frame's memory. Used internally by Clay_ReleaseFrame().
+    struct Clay_Context *context;
+    int32_t frameBufferIndex;
+} Clay_Frame;
+
 // Represents the current state of interaction with clay this frame.
 typedef CLAY_PACKED_ENUM {
     // A left mouse click, or touch occurred this frame.
@@ -764,6 +933,8 @@ typedef struct Clay_ElementDeclaration {
     Clay_ClipElementConfig clip;
     // Controls settings related to element borders, and will generate BORDER render commands.
     Clay_BorderElementConfig border;
+    // Marks the element and its children as a layer that renderers can cache, and will generate LAYER_BEGIN and LAYER_END render commands.
+    Clay_LayerElementConfig layer;
     // A pointer that will be transparently passed through to resulting render commands.
     void *userData;
 } Clay_ElementDeclaration;
@@ -789,6 +960,15 @@ typedef CLAY_PACKED_ENUM {
     CLAY_ERROR_TYPE_PERCENTAGE_OVER_1,
     // Clay encountered an internal error. It would be wonderful if you could report this so we can fix it!
     CLAY_ERROR_TYPE_INTERNAL_ERROR,
+    // Clay_BeginLayout() was called while every frame buffer was either acquired with Clay_AcquireFrame() or holding the previous frame.
+    // The frame is laid out into a scratch buffer that can't be acquired. The number of frame buffers can be increased with Clay_SetFrameBufferCount().
+    CLAY_ERROR_TYPE_FRAME_BUFFERS_EXHAUSTED,
+    // Clay_FrameAllocString() or Clay_FrameFormat() ran out of space in the string data of the current frame.
+    // This limit can be increased with Clay_SetFrameStringCapacity().
+    CLAY_ERROR_TYPE_FRAME_STRING_CAPACITY_EXCEEDED,
+    // Clay ran out of capacity in its internal array for storing wrapped lines of text, and the remaining lines were cut off.
+    // This limit can be increased with Clay_SetMaxWrappedTextLineCount().
+    CLAY_ERROR_TYPE_WRAPPED_TEXT_LINE_CAPACITY_EXCEEDED,
 } Clay_ErrorType;
 
 // Data to identify the error that clay has encountered.
@@ -802,6 +982,9 @@ typedef struct Clay_ErrorData {
     // CLAY_ERROR_TYPE_FLOATING_CONTAINER_PARENT_NOT_FOUND - A floating element was declared using CLAY_ATTACH_TO_ELEMENT_ID and either an invalid .parentId was provided or no element with the provided .parentId was found.
     // CLAY_ERROR_TYPE_PERCENTAGE_OVER_1 - An element was declared that using CLAY_SIZING_PERCENT but the percentage value was over 1. Percentage values are expected to be in the 0-1 range.
     // CLAY_ERROR_TYPE_INTERNAL_ERROR - Clay encountered an internal error. It would be wonderful if you could report this so we can fix it!
+    // CLAY_ERROR_TYPE_FRAME_BUFFERS_EXHAUSTED - Clay_BeginLayout() was called while every frame buffer was in use. The frame is laid out into a scratch buffer that can't be acquired. The number of frame buffers can be increased with Clay_SetFrameBufferCount().
+    // CLAY_ERROR_TYPE_FRAME_STRING_CAPACITY_EXCEEDED - Clay_FrameAllocString() or Clay_FrameFormat() ran out of space. This limit can be increased with Clay_SetFrameStringCapacity().
+    // CLAY_ERROR_TYPE_WRAPPED_TEXT_LINE_CAPACITY_EXCEEDED - Clay ran out of capacity for wrapped lines of text. This limit can be increased with Clay_SetMaxWrappedTextLineCount().
     Clay_ErrorType errorType;
     // A string containing human-readable error text that explains the error in more detail.
     Clay_String errorText;
@@ -817,6 +1000,28 @@ typedef struct {
     void *userData;
 } Clay_ErrorHandler;
 
+// A wrapper struct around an optional user provided allocator, used by Clay to grow its internal memory between frames
+// instead of dropping elements when capacity is exceeded. See Clay_SetAllocator().
+typedef struct {
+    // Returns a new block of memory at least size bytes in length, or NULL if the allocation failed.
+    void *(*allocateFunction)(size_t size, void *userData);
+    // Releases a block previously returned from allocateFunction. size is the same value that was passed when allocating.
+    void (*freeFunction)(void *memory, size_t size, void *userData);
+    // A pointer that will be transparently passed through to the allocator functions when they are called.
+    void *userData;
+} Clay_Allocator;
+
+// A wrapper struct around an optional user provided parallel for function, used by Clay to split the layout calculation of large
+// layouts into jobs that can run on multiple threads. See Clay_SetParallelExecutor().
+typedef struct {
+    // Calls job(jobIndex, jobData) once for every jobIndex from 0 to jobCount - 1, on any threads and in any order, and returns once all of them have finished.
+    void (*parallelForFunction)(int32_t jobCount, void (*job)(int32_t jobIndex, void *jobData), void *jobData, void *userData);
+    // Layouts are only split into jobs of at least this many elements. Zero uses the default of 1024.
+    int32_t minimumJobElementCount;
+    // A pointer that will be transparently passed through to parallelForFunction when it is called.
+    void *userData;
+} Clay_ParallelExecutor;
+
 // Function Forward Declarations ---------------------------------
 
 // Public API functions ------------------------------------------
@@ -841,6 +1046,19 @@ CLAY_DLL_EXPORT Clay_Context* Clay_GetCurrentContext(void);
 // Sets the context that clay will use to compute the layout.
 // Used to restore a context saved from Clay_GetCurrentContext when using multiple instances of clay simultaneously.
 CLAY_DLL_EXPORT void Clay_SetCurrentContext(Clay_Context* context);
+// Variants of the functions below that take the context explicitly. Each one behaves like the function it wraps, as if the given context
+// was current on the calling thread, without changing the current context. Between Clay_BeginLayoutCtx() and Clay_EndLayoutCtx(), the
+// given context is used on the calling thread instead of the current one, so layout declarations are added to it.
+// Different contexts can be used concurrently from different threads, unless compiled with CLAY_DISABLE_THREAD_LOCAL.
+CLAY_DLL_EXPORT void Clay_SetLayoutDimensionsCtx(Clay_Context* context, Clay_Dimensions dimensions);
+CLAY_DLL_EXPORT void Clay_SetPointerStateCtx(Clay_Context* context, Clay_Vector2 position, bool pointerDown);
+CLAY_DLL_EXPORT void Clay_UpdateScrollContainersCtx(Clay_Context* context, bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime);
+CLAY_DLL_EXPORT void Clay_BeginLayoutCtx(Clay_Context* context);
+CLAY_DLL_EXPORT Clay_RenderCommandArray Clay_EndLayoutCtx(Clay_Context* context);
+CLAY_DLL_EXPORT Clay_ElementData Clay_GetElementDataCtx(Clay_Context* context, Clay_ElementId id);
+CLAY_DLL_EXPORT bool Clay_PointerOverCtx(Clay_Context* context, Clay_ElementId elementId);
+CLAY_DLL_EXPORT Clay_ScrollContainerData Clay_GetScrollContainerDataCtx(Clay_Context* context, Clay_ElementId id);
+CLAY_DLL_EXPORT Clay_Frame Clay_AcquireFrameCtx(Clay_Context* context);
 // Updates the state of Clay's internal scroll data, updating scroll content positions if scrollDelta is non zero, and progressing momentum scrolling.
 // - enableDragScrolling when set to true will enable mobile device like "touch drag" scroll of scroll containers, including momentum scrolling after the touch has ended.
 // - scrollDelta is the amount to scroll this frame on each axis in pixels.
@@ -849,6 +1067,10 @@ CLAY_DLL_EXPORT void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_
 // Returns the internally stored scroll offset for the currently open element.
 // Generally intended for use with clip elements to create scrolling containers.
 CLAY_DLL_EXPORT Clay_Vector2 Clay_GetScrollOffset(void);
+// Returns the range of items that are visible in the currently open scroll container, which should be a virtual list of config.itemCount items laid out
+// along its layoutDirection. Only the items in the range need to be declared, with spacers before and after them so the content size stays correct.
+// The visible region is based on the container's bounding box from the last frame, and the .childOffset of its clip config.
+CLAY_DLL_EXPORT Clay_VirtualListRange Clay_GetVirtualListRange(Clay_VirtualListConfig config);
 // Updates the layout dimensions in response to the window or outer container being resized.
 CLAY_DLL_EXPORT void Clay_SetLayoutDimensions(Clay_Dimensions dimensions);
 // Called before starting any layout declarations.
@@ -856,6 +1078,27 @@ CLAY_DLL_EXPORT void Clay_BeginLayout(void);
 // Called when all layout declarations are finished.
 // Computes the layout and generates and returns the array of render commands to draw.
 CLAY_DLL_EXPORT Clay_RenderCommandArray Clay_EndLayout(void);
+// Starts measuring a subtree, either during a layout or between layouts. Elements declared until Clay_EndMeasure() are
+// placed in an invisible container that fits its contents, up to availableSize (an axis of 0 is unbounded).
+// The elements are sized and their text is wrapped, but they are not positioned, rendered or registered by ID,
+// and they are discarded by Clay_EndMeasure(). Measurements can't be nested.
+CLAY_DLL_EXPORT void Clay_BeginMeasure(Clay_Dimensions availableSize);
+// Finishes a measurement started with Clay_BeginMeasure(), and returns the size of the container.
+CLAY_DLL_EXPORT Clay_Dimensions Clay_EndMeasure(void);
+// Changes the offset of a floating element declared in the last layout, e.g. a tooltip or a dragged item, without declaring the layout again.
+// Call Clay_UpdateFloatingElements() to reposition it. Only has an effect between Clay_EndLayout() and the next Clay_BeginLayout().
+CLAY_DLL_EXPORT void Clay_SetFloatingElementOffset(Clay_ElementId id, Clay_Vector2 offset);
+// Repositions the floating elements moved with Clay_SetFloatingElementOffset(), along with any floating elements attached to them, and returns
+// the render commands of the last layout with theirs regenerated. Sizes are not recalculated, and the rest of the render commands are reused.
+CLAY_DLL_EXPORT Clay_RenderCommandArray Clay_UpdateFloatingElements(void);
+// Copies a string into the string data of the current frame, which lives as long as the frame's render commands, so dynamic
+// text doesn't need a user managed arena. Call between Clay_BeginLayout() and Clay_EndLayout(). Returns an empty string
+// if the capacity set with Clay_SetFrameStringCapacity() is exceeded.
+CLAY_DLL_EXPORT Clay_String Clay_FrameAllocString(Clay_String string);
+// Formats a string into the string data of the current frame, in the same way as Clay_FrameAllocString(). Supports a subset of printf:
+// %d %i %u %x %X %o %p %f %F %s %c and %%, with the - 0 + space and # flags, widths, precisions and the hh h l ll z j t and L length
+// modifiers. %f is converted exactly and rounds ties to even. %e %g and %a are written as they are, but still consume their argument.
+CLAY_DLL_EXPORT Clay_String Clay_FrameFormat(const char *format, ...) CLAY__PRINTF_FORMAT(1, 2);
 // Calculates a hash ID from the given idString.
 // Generally only used for dynamic strings when CLAY_ID("stringLiteral") can't be used.
 CLAY_DLL_EXPORT Clay_ElementId Clay_GetElementId(Clay_String idString);
@@ -900,31 +1143,99 @@ CLAY_DLL_EXPORT void Clay_SetDebugModeEnabled(bool enabled);
 CLAY_DLL_EXPORT bool Clay_IsDebugModeEnabled(void);
 // Enables and disables visibility culling. By default, Clay will not generate render commands for elements whose bounding box is entirely outside the screen.
 CLAY_DLL_EXPORT void Clay_SetCullingEnabled(bool enabled);
+// Snaps the edges of every bounding box in the layout output to multiples of gridSize, e.g. {1, 1} for whole pixels,
+// {1 / devicePixelRatio, 1 / devicePixelRatio} for device pixels, or the cell size of a terminal. Edges are snapped rather
+// than sizes, so elements that touch before snapping still touch afterwards. An axis with a grid size of 0 is not snapped.
+// This state is retained and does not need to be set each frame. Disabled by default.
+CLAY_DLL_EXPORT void Clay_SetPixelSnapping(Clay_Dimensions gridSize);
+// Enables and disables config interning. When enabled, identical layout and text configs declared within the same frame share a single stored copy,
+// reducing memory traffic for large lists of identically styled elements. Disabled by default.
+CLAY_DLL_EXPORT void Clay_SetConfigInterningEnabled(bool enabled);
+// Enables and disables draw batching. When enabled, Clay_EndLayout() reorders render commands within each zIndex and clip region
+// so that non overlapping commands of the same type, font or image are adjacent, and records the resulting runs for Clay_GetDrawBatches().
+// Commands that overlap keep their relative order, so the drawn output is unchanged as long as every command draws inside its bounding box.
+// Disabled by default.
+CLAY_DLL_EXPORT void Clay_SetDrawBatchingEnabled(bool enabled);
+// Returns the draw batches for the render commands returned by the last call to Clay_EndLayout(). Empty when draw batching is disabled.
+CLAY_DLL_EXPORT Clay_DrawBatchArray Clay_GetDrawBatches(void);
+// Enables and disables occlusion culling. When enabled, Clay_EndLayout() drops rectangle, border, text and image render commands
+// that are completely hidden behind opaque rectangles (alpha 255, no corner radius) drawn after them. Disabled by default.
+CLAY_DLL_EXPORT void Clay_SetOcclusionCullingEnabled(bool enabled);
+// Enables and disables frame skipping. When enabled, Clay keeps a running hash of the elements, configs and text declared each frame,
+// along with the layout dimensions and settings. If Clay_EndLayout() sees the same hash as the previous frame, it skips calculating the
+// layout and returns the previous frame's render commands again. Disabled by default.
+CLAY_DLL_EXPORT void Clay_SetFrameSkippingEnabled(bool enabled);
+// Returns true if the last call to Clay_EndLayout() returned the previous frame's render commands unchanged, in which case renderers
+// can skip presenting the frame. Always false when frame skipping is disabled.
+CLAY_DLL_EXPORT bool Clay_IsFrameUnchanged(void);
+// Acquires the output of the last call to Clay_EndLayout(). The render commands, draw batches and any strings they point to in Clay's
+// memory stay valid until the frame is passed to Clay_ReleaseFrame(), even while later frames are laid out, so a render thread can
+// draw one frame while the next one is declared. Must be called from the thread that calls Clay_EndLayout().
+CLAY_DLL_EXPORT Clay_Frame Clay_AcquireFrame(void);
+// Releases a frame acquired with Clay_AcquireFrame(), allowing Clay to reuse its memory. Can be called from any thread.
+CLAY_DLL_EXPORT void Clay_ReleaseFrame(Clay_Frame frame);
+// Returns the number of frame buffers that Clay_EndLayout() alternates between.
+CLAY_DLL_EXPORT int32_t Clay_GetFrameBufferCount(void);
+// Modifies the number of frame buffers that Clay_EndLayout() alternates between. One buffer always holds the output of the previous frame,
+// so two buffers allow one frame to be acquired at a time, three allow two and so on. The minimum and default is 2.
+// Acquired frames are never overwritten. When no buffer is free, the frame is laid out into a scratch buffer, and Clay_AcquireFrame() returns
+// an empty frame for it.
+// This may require reallocating additional memory, and re-calling Clay_Initialize();
+CLAY_DLL_EXPORT void Clay_SetFrameBufferCount(int32_t frameBufferCount);
 // Returns the maximum number of UI elements supported by Clay's current configuration.
 CLAY_DLL_EXPORT int32_t Clay_GetMaxElementCount(void);
 // Modifies the maximum number of UI elements supported by Clay's current configuration.
-// This may require reallocating additional memory, and re-calling Clay_Initialize();
+// This may require reallocating additional memory, and re-calling Clay_Initialize(), unless an allocator is set with Clay_SetAllocator().
 CLAY_DLL_EXPORT void Clay_SetMaxElementCount(int32_t maxElementCount);
 // Returns the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
 CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 // Modifies the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
-// This may require reallocating additional memory, and re-calling Clay_Initialize();
+// This may require reallocating additional memory, and re-calling Clay_Initialize(), unless an allocator is set with Clay_SetAllocator().
 CLAY_DLL_EXPORT void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount);
+// Returns the maximum number of lines that text elements can be wrapped into in one layout.
+CLAY_DLL_EXPORT int32_t Clay_GetMaxWrappedTextLineCount(void);
+// Modifies the maximum number of lines that text elements can be wrapped into in one layout. Each text element uses at least one line.
+// This may require reallocating additional memory, and re-calling Clay_Initialize();
+CLAY_DLL_EXPORT void Clay_SetMaxWrappedTextLineCount(int32_t maxWrappedTextLineCount);
+// Returns the number of bytes available to Clay_FrameAllocString() and Clay_FrameFormat() in each frame.
+CLAY_DLL_EXPORT int32_t Clay_GetFrameStringCapacity(void);
+// Modifies the number of bytes available to Clay_FrameAllocString() and Clay_FrameFormat() in each frame. The default is 8192.
+// This may require reallocating additional memory, and re-calling Clay_Initialize();
+CLAY_DLL_EXPORT void Clay_SetFrameStringCapacity(int32_t frameStringCapacity);
 // Resets Clay's internal text measurement cache. Useful if font mappings have changed or fonts have been reloaded.
 CLAY_DLL_EXPORT void Clay_ResetMeasureTextCache(void);
+// Reports that removedLength bytes at offset in the text of an editable text element were replaced with insertedLength bytes.
+// Call it for each change to the text between layouts, with offsets into the text as it is after the previous changes. See CLAY_EDITABLE_TEXT().
+CLAY_DLL_EXPORT void Clay_ReportTextEdit(Clay_EditableTextState *state, int32_t offset, int32_t removedLength, int32_t insertedLength);
+// Binds an allocator that Clay will use to grow its internal memory when element, render command or text measurement capacity is exceeded.
+// Growth happens at the start of the next Clay_BeginLayout(), and preserves the text measurement cache and scroll state.
+// Once set, Clay_SetMaxElementCount() and Clay_SetMaxMeasureTextCacheWordCount() also take effect without re-calling Clay_Initialize().
+// Capacities only grow: a value smaller than the current capacity is ignored until Clay_Initialize() is called again.
+// By default no allocator is set and Clay never allocates memory beyond the arena passed to Clay_Initialize().
+CLAY_DLL_EXPORT void Clay_SetAllocator(Clay_Allocator allocator);
+// Binds a parallel for function that Clay_EndLayout() uses to size and wrap large independent subtrees as separate jobs. The output is
+// identical to laying out on a single thread. Jobs call the function passed to Clay_SetMeasureTextFunction(), which must then be thread safe.
+// Floating roots, positioning and render command generation always run on the thread that calls Clay_EndLayout().
+// By default no executor is set and the whole layout is calculated on the thread that calls Clay_EndLayout().
+CLAY_DLL_EXPORT void Clay_SetParallelExecutor(Clay_ParallelExecutor executor);
 
 // Internal API functions required by macros ----------------------
 
 CLAY_DLL_EXPORT void Clay__OpenElement(void);
 CLAY_DLL_EXPORT void Clay__ConfigureOpenElement(const Clay_ElementDeclaration config);
 CLAY_DLL_EXPORT void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *config);
+CLAY_DLL_EXPORT void Clay__ConfigureOpenElementStatic(const Clay_ElementDeclaration *declaration);
 CLAY_DLL_EXPORT void Clay__CloseElement(void);
 CLAY_DLL_EXPORT Clay_ElementId Clay__HashString(Clay_String key, uint32_t seed);
 CLAY_DLL_EXPORT Clay_ElementId Clay__HashStringWithOffset(Clay_String key, uint32_t offset, uint32_t seed);
 CLAY_DLL_EXPORT void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig);
+CLAY_DLL_EXPORT void Clay__OpenLargeTextElement(Clay_ElementId id, Clay_String text, Clay_TextElementConfig *textConfig, Clay_LargeTextState *state);
+CLAY_DLL_EXPORT void Clay__OpenEditableTextElement(Clay_String text, Clay_TextElementConfig *textConfig, Clay_EditableTextState *state);
 CLAY_DLL_EXPORT Clay_TextElementConfig *Clay__StoreTextElementConfig(Clay_TextElementConfig config);
+CLAY_DLL_EXPORT Clay_TextElementConfig *Clay__StoreStaticTextElementConfig(Clay_TextElementConfig config);
 CLAY_DLL_EXPORT uint32_t Clay__GetParentElementId(void);
 
+// The debug view settings of contexts created after they are set
 extern Clay_Color Clay__debugViewHighlightColor;
 extern uint32_t Clay__debugViewWidth;
 
@@ -948,6 +1259,16 @@ extern uint32_t Clay__debugViewWidth;
 #define CLAY__MAXFLOAT 3.40282346638528859812e+38F
 #endif
 
+// Atomic operations on int32_t, used for frame buffer acquire counts
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CLAY__ATOMIC_LOAD(pointer) _InterlockedOr((long volatile *)(pointer), 0)
+#define CLAY__ATOMIC_ADD(pointer, value) _InterlockedExchangeAdd((long volatile *)(pointer), (value))
+#else
+#define CLAY__ATOMIC_LOAD(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+#define CLAY__ATOMIC_ADD(pointer, value) __atomic_fetch_add((pointer), (value), __ATOMIC_ACQ_REL)
+#endif
+
 Clay_LayoutConfig CLAY_LAYOUT_DEFAULT = CLAY__DEFAULT_STRUCT;
 
 Clay_Color Clay__Color_DEFAULT = CLAY__DEFAULT_STRUCT;
@@ -1017,9 +1338,14 @@ typedef struct                                      \
                                                     \
 CLAY__ARRAY_DEFINE_FUNCTIONS(typeName, arrayName)   \
 
-Clay_Context *Clay__currentContext;
+CLAY__THREAD_LOCAL Clay_Context *Clay__currentContext;
+// Set by the Ctx variants of the API, and used instead of Clay__currentContext on the thread that set it
+CLAY__THREAD_LOCAL_STORAGE Clay_Context *Clay__explicitContext;
 int32_t Clay__defaultMaxElementCount = 8192;
 int32_t Clay__defaultMaxMeasureTextWordCacheCount = 16384;
+int32_t Clay__defaultFrameBufferCount = 2;
+int32_t Clay__defaultFrameStringCapacity = 8192;
+int32_t Clay__defaultMaxWrappedTextLineCount = 8192;
 
 void Clay__ErrorHandlerFunctionDefault(Clay_ErrorData errorText) {
     (void) errorText;
@@ -1032,6 +1358,8 @@ typedef struct {
     bool maxElementsExceeded;
     bool maxRenderCommandsExceeded;
     bool maxTextMeasureCacheExceeded;
+    bool frameStringCapacityExceeded;
+    bool maxWrappedTextLinesExceeded;
     bool textMeasurementFunctionNotSet;
 } Clay_BooleanWarnings;
 
@@ -1074,9 +1402,11 @@ CLAY__ARRAY_DEFINE(Clay_FloatingElementConfig, Clay__FloatingElementConfigArray)
 CLAY__ARRAY_DEFINE(Clay_CustomElementConfig, Clay__CustomElementConfigArray)
 CLAY__ARRAY_DEFINE(Clay_ClipElementConfig, Clay__ClipElementConfigArray)
 CLAY__ARRAY_DEFINE(Clay_BorderElementConfig, Clay__BorderElementConfigArray)
+CLAY__ARRAY_DEFINE(Clay_LayerElementConfig, Clay__LayerElementConfigArray)
 CLAY__ARRAY_DEFINE(Clay_String, Clay__StringArray)
 CLAY__ARRAY_DEFINE(Clay_SharedElementConfig, Clay__SharedElementConfigArray)
 CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_RenderCommand, Clay_RenderCommandArray)
+CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_DrawBatch, Clay_DrawBatchArray)
 
 typedef CLAY_PACKED_ENUM {
     CLAY__ELEMENT_CONFIG_TYPE_NONE,
@@ -1088,6 +1418,7 @@ typedef CLAY_PACKED_ENUM {
     CLAY__ELEMENT_CONFIG_TYPE_TEXT,
     CLAY__ELEMENT_CONFIG_TYPE_CUSTOM,
     CLAY__ELEMENT_CONFIG_TYPE_SHARED,
+    CLAY__ELEMENT_CONFIG_TYPE_LAYER,
 } Clay__ElementConfigType;
 
 typedef union {
@@ -1099,6 +1430,7 @@ typedef union {
     Clay_ClipElementConfig *clipElementConfig;
     Clay_BorderElementConfig *borderElementConfig;
     Clay_SharedElementConfig *sharedElementConfig;
+    Clay_LayerElementConfig *layerElementConfig;
 } Clay_ElementConfigUnion;
 
 typedef struct {
@@ -1115,10 +1447,34 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__WrappedTextLine, Clay__WrappedTextLineArray)
 
+typedef struct {
+    int32_t startOffset;
+    int32_t length;
+    float width;
+    float height;
+    int32_t next;
+} Clay__MeasuredWord;
+
+CLAY__ARRAY_DEFINE(Clay__MeasuredWord, Clay__MeasuredWordArray)
+
+typedef struct {
+    Clay_Dimensions unwrappedDimensions;
+    int32_t measuredWordsStartIndex;
+    float minWidth;
+    bool containsNewlines;
+    // Hash map data
+    uint32_t id;
+    int32_t nextIndex;
+    uint32_t generation;
+} Clay__MeasureTextCacheItem;
+
+CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
+
 typedef struct {
     Clay_String text;
     Clay_Dimensions preferredDimensions;
     int32_t elementIndex;
+    Clay__MeasureTextCacheItem *measureTextCacheItem;
     Clay__WrappedTextLineArraySlice wrappedLines;
 } Clay__TextElementData;
 
@@ -1143,9 +1499,45 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElement, Clay_LayoutElementArray)
 
+typedef struct {
+    int32_t index;
+    uint32_t generation; // Slots are never cleared, and are only valid during the frame they were written in
+} Clay__ConfigInternSlot;
+
+CLAY__ARRAY_DEFINE(Clay__ConfigInternSlot, Clay__ConfigInternSlotArray)
+
+// Persistent data for a declaration passed to CLAY_STATIC(). Sub configs that are never written to during layout
+// are referenced directly from the declaration, the rest are copied here once.
+typedef struct {
+    const Clay_ElementDeclaration *declaration;
+    Clay_LayoutConfig layoutConfig;
+    Clay_SharedElementConfig sharedConfig;
+    Clay_ElementConfig elementConfigs[6]; // Shared, image, custom, clip, border and layer
+    int32_t elementConfigCount;
+} Clay__StaticDeclaration;
+
+CLAY__ARRAY_DEFINE(Clay__StaticDeclaration, Clay__StaticDeclarationArray)
+
+// A compact copy of the config values read while sizing, stored per element index so that the sizing passes
+// stream through contiguous memory rather than dereferencing each child's layoutConfig and elementConfigs.
+// Written when an element is closed, while its configs are still in cache from calculating its dimensions.
+typedef struct {
+    Clay_SizingAxis sizing[2]; // Indexed by axis, 0 = x, 1 = y
+    uint32_t padding[2]; // Total padding along each axis, which doesn't fit in the uint16_t of each side
+    uint16_t childGap;
+    Clay_LayoutDirection layoutDirection;
+    bool resizable : 1; // False for text elements that can't be wrapped
+    bool hasChildContainers : 1; // Non text elements with children, which need to be visited by the sizing BFS
+    bool clipX : 1;
+    bool clipY : 1;
+} Clay__LayoutElementSizing;
+
+CLAY__ARRAY_DEFINE(Clay__LayoutElementSizing, Clay__LayoutElementSizingArray)
+
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_BoundingBox boundingBox;
+    Clay_Dimensions elementDimensions; // The final dimensions of layoutElement, restored when Clay_EndLayout() skips the layout calculation
     Clay_Dimensions contentSize;
     Clay_Vector2 scrollOrigin;
     Clay_Vector2 pointerOrigin;
@@ -1167,6 +1559,16 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__DebugElementData, Clay__DebugElementDataArray)
 
+// The lengths of one frame's output within the frame buffer arrays in Clay_Context
+typedef struct {
+    int32_t renderCommandCount;
+    int32_t drawBatchCount;
+    int32_t stringDataLength;
+    int32_t acquireCount; // Accessed atomically, as frames can be released from other threads
+} Clay__FrameBuffer;
+
+CLAY__ARRAY_DEFINE(Clay__FrameBuffer, Clay__FrameBufferArray)
+
 typedef struct { // todo get this struct into a single cache line
     Clay_BoundingBox boundingBox;
     Clay_ElementId elementId;
@@ -1181,28 +1583,6 @@ typedef struct { // todo get this struct into a single cache line
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElementHashMapItem, Clay__LayoutElementHashMapItemArray)
 
-typedef struct {
-    int32_t startOffset;
-    int32_t length;
-    float width;
-    int32_t next;
-} Clay__MeasuredWord;
-
-CLAY__ARRAY_DEFINE(Clay__MeasuredWord, Clay__MeasuredWordArray)
-
-typedef struct {
-    Clay_Dimensions unwrappedDimensions;
-    int32_t measuredWordsStartIndex;
-    float minWidth;
-    bool containsNewlines;
-    // Hash map data
-    uint32_t id;
-    int32_t nextIndex;
-    uint32_t generation;
-} Clay__MeasureTextCacheItem;
-
-CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
-
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_Vector2 position;
@@ -1217,13 +1597,48 @@ typedef struct {
     uint32_t clipElementId; // This can be zero if there is no clip element
     int16_t zIndex;
     Clay_Vector2 pointerOffset; // Only used when scroll containers are managed externally
+    int32_t renderCommandStart; // The range of render commands generated for this tree by the last call to Clay_EndLayout()
+    int32_t renderCommandCount;
+    bool moved; // Set by Clay_SetFloatingElementOffset() until Clay_UpdateFloatingElements() is called
 } Clay__LayoutElementTreeRoot;
 
 CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeRoot, Clay__LayoutElementTreeRootArray)
 
+// The lengths of the per frame arrays when Clay_BeginMeasure() was called, so that Clay_EndMeasure() can discard everything declared since
+typedef struct {
+    int32_t layoutElements;
+    int32_t openLayoutElementStack;
+    int32_t openClipElementStack;
+    int32_t layoutElementChildren;
+    int32_t layoutElementChildrenBuffer;
+    int32_t textElementData;
+    int32_t aspectRatioElementIndexes;
+    int32_t layoutConfigs;
+    int32_t elementConfigs;
+    int32_t textElementConfigs;
+    int32_t aspectRatioElementConfigs;
+    int32_t imageElementConfigs;
+    int32_t floatingElementConfigs;
+    int32_t clipElementConfigs;
+    int32_t customElementConfigs;
+    int32_t borderElementConfigs;
+    int32_t layerElementConfigs;
+    int32_t sharedElementConfigs;
+    int32_t layoutElementIdStrings;
+    int32_t wrappedTextLines;
+    int32_t layoutElementTreeRoots;
+    int32_t openElementIndex; // The element that was open when the measurement started, or -1
+    int32_t openElementChildCount;
+    uint64_t frameHash;
+    bool configInterningEnabled;
+} Clay__MeasureState;
+
 struct Clay_Context {
     int32_t maxElementCount;
     int32_t maxMeasureTextCacheWordCount;
+    int32_t frameBufferCount;
+    int32_t frameStringCapacity;
+    int32_t maxWrappedTextLineCount;
     bool warningsEnabled;
     Clay_ErrorHandler errorHandler;
     Clay_BooleanWarnings booleanWarnings;
@@ -1235,16 +1650,53 @@ struct Clay_Context {
     uint32_t dynamicElementIndex;
     bool debugModeEnabled;
     bool disableCulling;
+    Clay_Dimensions pixelSnapGridSize;
+    bool configInterningEnabled;
+    bool drawBatchingEnabled;
+    bool occlusionCullingEnabled;
     bool externalScrollHandlingEnabled;
+    bool frameSkippingEnabled;
+    bool frameUnchanged;
+    bool measuring; // True between Clay_BeginMeasure() and Clay_EndMeasure()
+    Clay__MeasureState measureState;
     uint32_t debugSelectedElementId;
     uint32_t generation;
+    uint64_t frameHash;
+    uint64_t previousFrameHash; // Zero if the previous frame's render commands can't be reused
     uintptr_t arenaResetOffset;
+    Clay_Dimensions (*measureTextFunction)(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
+    Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData);
     void *measureTextUserData;
     void *queryScrollOffsetUserData;
+    Clay_Context *contextBeforeLayout; // The explicit context to restore in Clay_EndLayoutCtx()
+    uint32_t debugViewWidth;
+    Clay_Color debugViewHighlightColor;
+    Clay_LayoutConfig defaultLayoutConfig; // Used by text elements, and by every element after maxElementCount is exceeded
     Clay_Arena internalArena;
+    // Growable memory
+    Clay_Allocator allocator;
+    Clay_ParallelExecutor parallelExecutor;
+    void *allocatedMemory; // Non null if internalArena was provided by allocator rather than Clay_Initialize
+    size_t allocatedMemorySize;
+    int32_t droppedElementCount;
+    int32_t requestedMaxElementCount;
+    int32_t requestedMaxMeasureTextCacheWordCount;
+    int32_t requestedFrameBufferCount;
+    int32_t requestedFrameStringCapacity;
+    int32_t requestedMaxWrappedTextLineCount;
+    int32_t frameBufferIndex; // The frame buffer written by the current frame
+    int32_t outputFrameBufferIndex; // The frame buffer holding the output of the last call to Clay_EndLayout(), or -1
     // Layout Elements / Render Commands
     Clay_LayoutElementArray layoutElements;
-    Clay_RenderCommandArray renderCommands;
+    Clay__LayoutElementSizingArray layoutElementSizing;
+    Clay__int32_tArray layoutElementSubtreeSizes; // The number of elements declared between opening and closing each element, including itself
+    Clay_RenderCommandArray renderCommands; // Views into the current frame buffer
+    Clay_DrawBatchArray drawBatches;
+    Clay_RenderCommandArray frameBufferRenderCommands; // maxElementCount entries per frame buffer
+    Clay_DrawBatchArray frameBufferDrawBatches;
+    Clay__charArray frameBufferStringData;
+    Clay__FrameBufferArray frameBuffers;
+    Clay__int32_tArray drawBatchCommandOrder;
     Clay__int32_tArray openLayoutElementStack;
     Clay__int32_tArray layoutElementChildren;
     Clay__int32_tArray layoutElementChildrenBuffer;
@@ -1262,7 +1714,14 @@ struct Clay_Context {
     Clay__ClipElementConfigArray clipElementConfigs;
     Clay__CustomElementConfigArray customElementConfigs;
     Clay__BorderElementConfigArray borderElementConfigs;
+    Clay__LayerElementConfigArray layerElementConfigs;
     Clay__SharedElementConfigArray sharedElementConfigs;
+    Clay__ConfigInternSlotArray layoutConfigInternTable;
+    Clay__ConfigInternSlotArray textElementConfigInternTable;
+    Clay__TextElementConfigArray staticTextElementConfigs;
+    Clay__int32_tArray staticTextElementConfigInternTable;
+    Clay__StaticDeclarationArray staticDeclarations;
+    Clay__int32_tArray staticDeclarationTable;
     // Misc Data Structures
     Clay__StringArray layoutElementIdStrings;
     Clay__WrappedTextLineArray wrappedTextLines;
@@ -1279,7 +1738,7 @@ struct Clay_Context {
     Clay_ElementIdArray pointerOverIds;
     Clay__ScrollContainerDataInternalArray scrollContainerDatas;
     Clay__boolArray treeNodeVisited;
-    Clay__charArray dynamicStringData;
+    Clay__charArray dynamicStringData; // View into the current frame buffer
     Clay__DebugElementDataArray debugElementData;
 };
 
@@ -1304,11 +1763,36 @@ Clay_String Clay__WriteStringToCharBuffer(Clay__charArray *buffer, Clay_String s
 #ifdef CLAY_WASM
     __attribute__((import_module("clay"), import_name("measureTextFunction"))) Clay_Dimensions Clay__MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
     __attribute__((import_module("clay"), import_name("queryScrollOffsetFunction"))) Clay_Vector2 Clay__QueryScrollOffset(uint32_t elementId, void *userData);
-#else
-    Clay_Dimensions (*Clay__MeasureText)(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
-    Clay_Vector2 (*Clay__QueryScrollOffset)(uint32_t elementId, void *userData);
 #endif
 
+// Rounds a value to the nearest multiple of gridSize, or returns it unchanged if gridSize is 0
+float Clay__SnapToGrid(float value, float gridSize) {
+    if (gridSize <= 0) {
+        return value;
+    }
+    float scaled = value / gridSize;
+    // Too large to hold in an int, and already a whole number anyway
+    if (scaled >= 2147483520.0f || scaled <= -2147483520.0f) {
+        return value;
+    }
+    return (float)(int32_t)(scaled + (scaled < 0 ? -0.5f : 0.5f)) * gridSize;
+}
+
+// Snaps the edges of a bounding box rather than its size, so that adjacent boxes keep sharing an edge
+Clay_BoundingBox Clay__SnapBoundingBox(Clay_BoundingBox boundingBox, Clay_Dimensions gridSize) {
+    if (gridSize.width > 0) {
+        float left = Clay__SnapToGrid(boundingBox.x, gridSize.width);
+        boundingBox.width = Clay__SnapToGrid(boundingBox.x + boundingBox.width, gridSize.width) - left;
+        boundingBox.x = left;
+    }
+    if (gridSize.height > 0) {
+        float top = Clay__SnapToGrid(boundingBox.y, gridSize.height);
+        boundingBox.height = Clay__SnapToGrid(boundingBox.y + boundingBox.height, gridSize.height) - top;
+        boundingBox.y = top;
+    }
+    return boundingBox;
+}
+
 Clay_LayoutElement* Clay__GetOpenLayoutElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     return Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1));
@@ -1319,16 +1803,140 @@ uint32_t Clay__GetParentElementId(void) {
     return Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 2))->id;
 }
 
-Clay_LayoutConfig * Clay__StoreLayoutConfig(Clay_LayoutConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &CLAY_LAYOUT_DEFAULT : Clay__LayoutConfigArray_Add(&Clay_GetCurrentContext()->layoutConfigs, config); }
-Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_TextElementConfig_DEFAULT : Clay__TextElementConfigArray_Add(&Clay_GetCurrentContext()->textElementConfigs, config); }
+uint32_t Clay__HashConfigValue(uint32_t hash, uint32_t value) {
+    hash += value;
+    hash += (hash << 10);
+    hash ^= (hash >> 6);
+    return hash;
+}
+
+uint32_t Clay__HashConfigFloat(uint32_t hash, float value) {
+    union { float f; uint32_t u; } bits = { value };
+    return Clay__HashConfigValue(hash, bits.u);
+}
+
+uint32_t Clay__HashSizingAxis(uint32_t hash, Clay_SizingAxis *axis) {
+    hash = Clay__HashConfigValue(hash, axis->type);
+    if (axis->type == CLAY__SIZING_TYPE_PERCENT) {
+        return Clay__HashConfigFloat(hash, axis->size.percent);
+    }
+    hash = Clay__HashConfigFloat(hash, axis->size.minMax.min);
+    return Clay__HashConfigFloat(hash, axis->size.minMax.max);
+}
+
+bool Clay__SizingAxisEqual(Clay_SizingAxis *a, Clay_SizingAxis *b) {
+    if (a->type != b->type) {
+        return false;
+    }
+    if (a->type == CLAY__SIZING_TYPE_PERCENT) {
+        return a->size.percent == b->size.percent;
+    }
+    return a->size.minMax.min == b->size.minMax.min && a->size.minMax.max == b->size.minMax.max;
+}
+
+// Configs are compared field by field rather than with Clay__MemCmp, as padding bytes in compound literals are not guaranteed to be zeroed
+uint32_t Clay__HashLayoutConfig(Clay_LayoutConfig *config) {
+    uint32_t hash = Clay__HashSizingAxis(0, &config->sizing.width);
+    hash = Clay__HashSizingAxis(hash, &config->sizing.height);
+    hash = Clay__HashConfigValue(hash, (uint32_t)config->padding.left | ((uint32_t)config->padding.right << 16));
+    hash = Clay__HashConfigValue(hash, (uint32_t)config->padding.top | ((uint32_t)config->padding.bottom << 16));
+    hash = Clay__HashConfigValue(hash, (uint32_t)config->childGap | ((uint32_t)config->childAlignment.x << 16) | ((uint32_t)config->childAlignment.y << 20) | ((uint32_t)config->layoutDirection << 24));
+    return hash;
+}
+
+bool Clay__LayoutConfigEqual(Clay_LayoutConfig *a, Clay_LayoutConfig *b) {
+    return Clay__SizingAxisEqual(&a->sizing.width, &b->sizing.width)
+        && Clay__SizingAxisEqual(&a->sizing.height, &b->sizing.height)
+        && a->padding.left == b->padding.left && a->padding.right == b->padding.right
+        && a->padding.top == b->padding.top && a->padding.bottom == b->padding.bottom
+        && a->childGap == b->childGap
+        && a->childAlignment.x == b->childAlignment.x && a->childAlignment.y == b->childAlignment.y
+        && a->layoutDirection == b->layoutDirection;
+}
+
+uint32_t Clay__HashTextElementConfig(Clay_TextElementConfig *config) {
+    uint32_t hash = Clay__HashConfigValue(0, (uint32_t)(uintptr_t)config->userData);
+    hash = Clay__HashConfigFloat(hash, config->textColor.r);
+    hash = Clay__HashConfigFloat(hash, config->textColor.g);
+    hash = Clay__HashConfigFloat(hash, config->textColor.b);
+    hash = Clay__HashConfigFloat(hash, config->textColor.a);
+    hash = Clay__HashConfigValue(hash, (uint32_t)config->fontId | ((uint32_t)config->fontSize << 16));
+    hash = Clay__HashConfigValue(hash, (uint32_t)config->letterSpacing | ((uint32_t)config->lineHeight << 16));
+    hash = Clay__HashConfigValue(hash, (uint32_t)config->wrapMode | ((uint32_t)config->textAlignment << 8));
+    return hash;
+}
+
+bool Clay__TextElementConfigEqual(Clay_TextElementConfig *a, Clay_TextElementConfig *b) {
+    return a->userData == b->userData
+        && a->textColor.r == b->textColor.r && a->textColor.g == b->textColor.g && a->textColor.b == b->textColor.b && a->textColor.a == b->textColor.a
+        && a->fontId == b->fontId && a->fontSize == b->fontSize
+        && a->letterSpacing == b->letterSpacing && a->lineHeight == b->lineHeight
+        && a->wrapMode == b->wrapMode && a->textAlignment == b->textAlignment;
+}
+
+// The intern tables are direct mapped, so a hash collision just results in a second copy of the config being stored
+Clay_LayoutConfig * Clay__InternLayoutConfig(Clay_LayoutConfig config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Apply the same defaults as Clay__CloseElement up front, so that the write there doesn't modify a shared config
+    if (config.sizing.width.type != CLAY__SIZING_TYPE_PERCENT && config.sizing.width.size.minMax.max <= 0) {
+        config.sizing.width.size.minMax.max = CLAY__MAXFLOAT;
+    }
+    if (config.sizing.height.type != CLAY__SIZING_TYPE_PERCENT && config.sizing.height.size.minMax.max <= 0) {
+        config.sizing.height.size.minMax.max = CLAY__MAXFLOAT;
+    }
+    Clay__ConfigInternSlot *slot = &context->layoutConfigInternTable.internalArray[Clay__HashLayoutConfig(&config) % context->layoutConfigInternTable.capacity];
+    if (slot->generation == context->generation && slot->index < context->layoutConfigs.length && Clay__LayoutConfigEqual(&context->layoutConfigs.internalArray[slot->index], &config)) {
+        return &context->layoutConfigs.internalArray[slot->index];
+    }
+    Clay_LayoutConfig *stored = Clay__LayoutConfigArray_Add(&context->layoutConfigs, config);
+    *slot = CLAY__INIT(Clay__ConfigInternSlot) { .index = context->layoutConfigs.length - 1, .generation = context->generation };
+    return stored;
+}
+
+Clay_TextElementConfig * Clay__InternTextElementConfig(Clay_TextElementConfig config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__ConfigInternSlot *slot = &context->textElementConfigInternTable.internalArray[Clay__HashTextElementConfig(&config) % context->textElementConfigInternTable.capacity];
+    if (slot->generation == context->generation && slot->index < context->textElementConfigs.length && Clay__TextElementConfigEqual(&context->textElementConfigs.internalArray[slot->index], &config)) {
+        return &context->textElementConfigs.internalArray[slot->index];
+    }
+    Clay_TextElementConfig *stored = Clay__TextElementConfigArray_Add(&context->textElementConfigs, config);
+    *slot = CLAY__INIT(Clay__ConfigInternSlot) { .index = context->textElementConfigs.length - 1, .generation = context->generation };
+    return stored;
+}
+
+Clay_LayoutConfig * Clay__StoreLayoutConfig(Clay_LayoutConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_GetCurrentContext()->defaultLayoutConfig : Clay_GetCurrentContext()->configInterningEnabled ? Clay__InternLayoutConfig(config) : Clay__LayoutConfigArray_Add(&Clay_GetCurrentContext()->layoutConfigs, config); }
+Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_TextElementConfig_DEFAULT : Clay_GetCurrentContext()->configInterningEnabled ? Clay__InternTextElementConfig(config) : Clay__TextElementConfigArray_Add(&Clay_GetCurrentContext()->textElementConfigs, config); }
 Clay_AspectRatioElementConfig * Clay__StoreAspectRatioElementConfig(Clay_AspectRatioElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_AspectRatioElementConfig_DEFAULT : Clay__AspectRatioElementConfigArray_Add(&Clay_GetCurrentContext()->aspectRatioElementConfigs, config); }
 Clay_ImageElementConfig * Clay__StoreImageElementConfig(Clay_ImageElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_ImageElementConfig_DEFAULT : Clay__ImageElementConfigArray_Add(&Clay_GetCurrentContext()->imageElementConfigs, config); }
 Clay_FloatingElementConfig * Clay__StoreFloatingElementConfig(Clay_FloatingElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_FloatingElementConfig_DEFAULT : Clay__FloatingElementConfigArray_Add(&Clay_GetCurrentContext()->floatingElementConfigs, config); }
 Clay_CustomElementConfig * Clay__StoreCustomElementConfig(Clay_CustomElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_CustomElementConfig_DEFAULT : Clay__CustomElementConfigArray_Add(&Clay_GetCurrentContext()->customElementConfigs, config); }
 Clay_ClipElementConfig * Clay__StoreClipElementConfig(Clay_ClipElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_ClipElementConfig_DEFAULT : Clay__ClipElementConfigArray_Add(&Clay_GetCurrentContext()->clipElementConfigs, config); }
 Clay_BorderElementConfig * Clay__StoreBorderElementConfig(Clay_BorderElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_BorderElementConfig_DEFAULT : Clay__BorderElementConfigArray_Add(&Clay_GetCurrentContext()->borderElementConfigs, config); }
+Clay_LayerElementConfig * Clay__StoreLayerElementConfig(Clay_LayerElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_LayerElementConfig_DEFAULT : Clay__LayerElementConfigArray_Add(&Clay_GetCurrentContext()->layerElementConfigs, config); }
 Clay_SharedElementConfig * Clay__StoreSharedElementConfig(Clay_SharedElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_SharedElementConfig_DEFAULT : Clay__SharedElementConfigArray_Add(&Clay_GetCurrentContext()->sharedElementConfigs, config); }
 
+// Static text configs are interned in persistent memory, and return the same pointer every frame for the same values.
+// Once the persistent pool is full, further configs fall back to being stored for the current frame only.
+Clay_TextElementConfig * Clay__StoreStaticTextElementConfig(Clay_TextElementConfig config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray *table = &context->staticTextElementConfigInternTable;
+    uint32_t hash = Clay__HashTextElementConfig(&config);
+    for (int32_t i = 0; i < table->capacity; ++i) {
+        int32_t *slot = &table->internalArray[(hash + i) % table->capacity];
+        if (*slot == -1) {
+            if (context->staticTextElementConfigs.length == context->staticTextElementConfigs.capacity) {
+                break;
+            }
+            *slot = context->staticTextElementConfigs.length;
+            return Clay__TextElementConfigArray_Add(&context->staticTextElementConfigs, config);
+        }
+        if (Clay__TextElementConfigEqual(&context->staticTextElementConfigs.internalArray[*slot], &config)) {
+            return &context->staticTextElementConfigs.internalArray[*slot];
+        }
+    }
+    return Clay__StoreTextElementConfig(config);
+}
+
 Clay_ElementConfig Clay__AttachElementConfig(Clay_ElementConfigUnion config, Clay__ElementConfigType type) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->booleanWarnings.maxElementsExceeded) {
@@ -1550,6 +2158,84 @@ uint32_t Clay__HashStringContentsWithConfig(Clay_String *text, Clay_TextElementC
     return hash + 1; // Reserve the hash result of zero as "null id"
 }
 
+// The frame hash is 64 bits wide, as a collision means a changed frame is presented as unchanged
+uint64_t Clay__HashFrameValue(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * 0xff51afd7ed558ccdULL;
+    return hash ^ (hash >> 32);
+}
+
+uint64_t Clay__HashFrameFloat(uint64_t hash, float value) {
+    union { float f; uint32_t u; } bits = { value };
+    return Clay__HashFrameValue(hash, bits.u);
+}
+
+uint64_t Clay__HashFrameColor(uint64_t hash, Clay_Color color) {
+    hash = Clay__HashFrameFloat(hash, color.r);
+    hash = Clay__HashFrameFloat(hash, color.g);
+    hash = Clay__HashFrameFloat(hash, color.b);
+    return Clay__HashFrameFloat(hash, color.a);
+}
+
+// Values mixed into the frame hash ahead of each declaration, so that the shape of the tree is part of the hash
+enum {
+    CLAY__FRAME_HASH_ELEMENT = 1,
+    CLAY__FRAME_HASH_STATIC_ELEMENT,
+    CLAY__FRAME_HASH_TEXT,
+    CLAY__FRAME_HASH_CLOSE,
+};
+
+// Adds every field of a declaration to the frame hash. Memory that the declaration points to, such as imageData, is only hashed by address.
+uint64_t Clay__HashFrameDeclaration(uint64_t hash, const Clay_ElementDeclaration *declaration) {
+    hash = Clay__HashFrameValue(hash, CLAY__FRAME_HASH_ELEMENT);
+    hash = Clay__HashFrameValue(hash, declaration->id.id);
+    hash = Clay__HashFrameValue(hash, Clay__HashLayoutConfig((Clay_LayoutConfig *)&declaration->layout));
+    hash = Clay__HashFrameColor(hash, declaration->backgroundColor);
+    hash = Clay__HashFrameFloat(hash, declaration->cornerRadius.topLeft);
+    hash = Clay__HashFrameFloat(hash, declaration->cornerRadius.topRight);
+    hash = Clay__HashFrameFloat(hash, declaration->cornerRadius.bottomLeft);
+    hash = Clay__HashFrameFloat(hash, declaration->cornerRadius.bottomRight);
+    hash = Clay__HashFrameFloat(hash, declaration->aspectRatio.aspectRatio);
+    hash = Clay__HashFrameValue(hash, (uint64_t)(uintptr_t)declaration->image.imageData);
+    if (declaration->floating.attachTo != CLAY_ATTACH_TO_NONE) {
+        const Clay_FloatingElementConfig *floating = &declaration->floating;
+        hash = Clay__HashFrameFloat(hash, floating->offset.x);
+        hash = Clay__HashFrameFloat(hash, floating->offset.y);
+        hash = Clay__HashFrameFloat(hash, floating->expand.width);
+        hash = Clay__HashFrameFloat(hash, floating->expand.height);
+        hash = Clay__HashFrameValue(hash, floating->parentId);
+        hash = Clay__HashFrameValue(hash, (uint64_t)(uint16_t)floating->zIndex
+            | ((uint64_t)floating->attachPoints.element << 16) | ((uint64_t)floating->attachPoints.parent << 24)
+            | ((uint64_t)floating->pointerCaptureMode << 32) | ((uint64_t)floating->attachTo << 40) | ((uint64_t)floating->clipTo << 48));
+    }
+    hash = Clay__HashFrameValue(hash, (uint64_t)(uintptr_t)declaration->custom.customData);
+    hash = Clay__HashFrameValue(hash, (uint64_t)declaration->clip.horizontal | ((uint64_t)declaration->clip.vertical << 1) | ((uint64_t)declaration->layer.cached << 2));
+    hash = Clay__HashFrameFloat(hash, declaration->clip.childOffset.x);
+    hash = Clay__HashFrameFloat(hash, declaration->clip.childOffset.y);
+    hash = Clay__HashFrameColor(hash, declaration->border.color);
+    const Clay_BorderWidth *width = &declaration->border.width;
+    hash = Clay__HashFrameValue(hash, (uint64_t)width->left | ((uint64_t)width->right << 16) | ((uint64_t)width->top << 32) | ((uint64_t)width->bottom << 48));
+    hash = Clay__HashFrameValue(hash, width->betweenChildren);
+    return Clay__HashFrameValue(hash, (uint64_t)(uintptr_t)declaration->userData);
+}
+
+// Text is hashed by address as well as by contents, so that the previous frame's render commands never point at text that has since changed.
+// Text written to the frame's string data is hashed by its offset instead, as each frame buffer has its own string data.
+uint64_t Clay__HashFrameText(uint64_t hash, Clay_String *text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    hash = Clay__HashFrameValue(hash, CLAY__FRAME_HASH_TEXT);
+    uintptr_t stringDataOffset = (uintptr_t)text->chars - (uintptr_t)context->dynamicStringData.internalArray;
+    if (stringDataOffset < (uintptr_t)context->dynamicStringData.capacity) {
+        hash = Clay__HashFrameValue(hash, (uint64_t)stringDataOffset | (1ULL << 63));
+    } else {
+        hash = Clay__HashFrameValue(hash, (uint64_t)(uintptr_t)text->chars);
+    }
+    hash = Clay__HashFrameValue(hash, (uint64_t)text->length);
+    if (!text->isStaticallyAllocated) {
+        hash = Clay__HashFrameValue(hash, Clay__HashData((const uint8_t *)text->chars, text->length));
+    }
+    return Clay__HashFrameValue(hash, Clay__HashTextElementConfig(config));
+}
+
 Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__MeasuredWord *previousWord) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->measuredWordsFreeList.length > 0) {
@@ -1564,10 +2250,205 @@ Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__Measure
     }
 }
 
-Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
+// Measures the words of text from start up to end, which is either the length of the text or just past a space or newline, and links them
+// after previousWord. Returns the last word that was added, or NULL if the measured words array ran out of capacity.
+Clay__MeasuredWord *Clay__MeasureWords(Clay_String *text, int32_t start, int32_t end, Clay_TextElementConfig *config, float spaceWidth, Clay__MeasuredWord *previousWord, float *minWidth, float *height) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t wordStart = start;
+    for (int32_t i = start; i < end; ++i) {
+        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
+            if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
+                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                    .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
+                    .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
+                    .userData = context->errorHandler.userData });
+                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
+            }
+            return NULL;
+        }
+        char current = text->chars[i];
+        if (current == ' ' || current == '\n') {
+            int32_t length = i - wordStart;
+            Clay_Dimensions dimensions = {};
+            if (length > 0) {
+                dimensions = context->measureTextFunction(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[wordStart], .baseChars = text->chars}, config, context->measureTextUserData);
+            }
+            *minWidth = CLAY__MAX(dimensions.width, *minWidth);
+            *height = CLAY__MAX(*height, dimensions.height);
+            if (current == ' ') {
+                dimensions.width += spaceWidth;
+                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = wordStart, .length = length + 1, .width = dimensions.width, .height = dimensions.height, .next = -1 }, previousWord);
+            } else {
+                if (length > 0) {
+                    previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = wordStart, .length = length, .width = dimensions.width, .height = dimensions.height, .next = -1 }, previousWord);
+                }
+                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = i + 1, .length = 0, .width = 0, .next = -1 }, previousWord);
+            }
+            wordStart = i + 1;
+        }
+    }
+    if (end - wordStart > 0) {
+        Clay_Dimensions dimensions = context->measureTextFunction(CLAY__INIT(Clay_StringSlice) { .length = end - wordStart, .chars = &text->chars[wordStart], .baseChars = text->chars }, config, context->measureTextUserData);
+        previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = wordStart, .length = end - wordStart, .width = dimensions.width, .height = dimensions.height, .next = -1 }, previousWord);
+        *height = CLAY__MAX(*height, dimensions.height);
+        *minWidth = CLAY__MAX(dimensions.width, *minWidth);
+    }
+    return previousWord;
+}
+
+// Calculates the unwrapped width of measured text from its measured words
+void Clay__UpdateMeasuredTextWidth(Clay__MeasureTextCacheItem *measured, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    float lineWidth = 0;
+    float measuredWidth = 0;
+    measured->containsNewlines = false;
+    int32_t wordIndex = measured->measuredWordsStartIndex;
+    while (wordIndex != -1) {
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+        // measuredWord->length == 0 means a newline character
+        if (measuredWord->length == 0) {
+            measuredWidth = CLAY__MAX(lineWidth, measuredWidth);
+            measured->containsNewlines = true;
+            lineWidth = 0;
+        } else {
+            lineWidth += measuredWord->width;
+        }
+        wordIndex = measuredWord->next;
+    }
+    measured->unwrappedDimensions.width = CLAY__MAX(lineWidth, measuredWidth) - config->letterSpacing;
+}
+
+// Patches the measurement of the text that an editable text element was last declared with, measuring only the words touched by the
+// reported edit and moving the words after it. Returns NULL if no edit was reported, or the previous measurement is no longer cached.
+Clay__MeasureTextCacheItem *Clay__MeasureEditedText(Clay_String *text, Clay_TextElementConfig *config, Clay_EditableTextState *state, uint32_t id) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t editStart = state->editStart;
+    int32_t removedEnd = state->editRemovedEnd;
+    int32_t insertedEnd = state->editInsertedEnd;
+    if (state->measureTextCacheId == 0 || text->length == 0 || (removedEnd == editStart && insertedEnd == editStart)
+        || editStart < 0 || removedEnd < editStart || insertedEnd < editStart || removedEnd > state->textLength
+        || text->length != state->textLength - removedEnd + insertedEnd
+        || state->fontId != config->fontId || state->fontSize != config->fontSize || state->letterSpacing != config->letterSpacing) {
+        return NULL;
+    }
+    // The previous measurement can only be patched if no other text element has used it this frame
+    uint32_t previousHashBucket = state->measureTextCacheId % (context->maxMeasureTextCacheWordCount / 32);
+    int32_t elementIndexPrevious = 0;
+    int32_t elementIndex = context->measureTextHashMap.internalArray[previousHashBucket];
+    while (elementIndex != 0 && Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex)->id != state->measureTextCacheId) {
+        elementIndexPrevious = elementIndex;
+        elementIndex = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex)->nextIndex;
+    }
+    if (elementIndex == 0) {
+        return NULL;
+    }
+    Clay__MeasureTextCacheItem *measured = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
+    if (measured->generation == context->generation) {
+        return NULL;
+    }
+
+    // The words that need to be measured again run from the start of the word containing the edit to the first space or newline after it.
+    // The text outside of the edit is unchanged, so both ends can be found by scanning the new text.
+    int32_t offsetDelta = insertedEnd - removedEnd;
+    int32_t regionStart = editStart;
+    while (regionStart > 0 && text->chars[regionStart - 1] != ' ' && text->chars[regionStart - 1] != '\n') {
+        regionStart--;
+    }
+    int32_t regionEnd = insertedEnd;
+    while (regionEnd < text->length && text->chars[regionEnd] != ' ' && text->chars[regionEnd] != '\n') {
+        regionEnd++;
+    }
+    int32_t previousRegionEnd = regionEnd - offsetDelta;
+    if (regionEnd < text->length) {
+        regionEnd++;
+    }
+
+    // Words with length > 0 start at the start of their region, and a newline is stored as an empty word that starts after it
+    Clay__MeasuredWord head = { .next = measured->measuredWordsStartIndex };
+    Clay__MeasuredWord *lastUnchangedWord = &head;
+    int32_t wordIndex = head.next;
+    while (wordIndex != -1) {
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+        if (measuredWord->length > 0 ? measuredWord->startOffset >= regionStart : measuredWord->startOffset > regionStart) {
+            break;
+        }
+        lastUnchangedWord = measuredWord;
+        wordIndex = measuredWord->next;
+    }
+    int32_t firstRemovedWordIndex = wordIndex;
+    while (wordIndex != -1) {
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+        if (measuredWord->length > 0 ? measuredWord->startOffset > previousRegionEnd : measuredWord->startOffset - 1 > previousRegionEnd) {
+            break;
+        }
+        wordIndex = measuredWord->next;
+    }
+    int32_t firstMovedWordIndex = wordIndex;
+
+    float spaceWidth = context->measureTextFunction(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
+    // Removed words are only freed once the new words have been measured, so that running out of capacity leaves the measurement intact
+    float minWidth = 0;
+    float height = 0;
+    Clay__MeasuredWord insertedHead = { .next = -1 };
+    Clay__MeasuredWord *lastInsertedWord = Clay__MeasureWords(text, regionStart, regionEnd, config, spaceWidth, &insertedHead, &minWidth, &height);
+    if (!lastInsertedWord) {
+        return NULL;
+    }
+    for (wordIndex = firstRemovedWordIndex; wordIndex != firstMovedWordIndex;) {
+        Clay__int32_tArray_Add(&context->measuredWordsFreeList, wordIndex);
+        wordIndex = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex)->next;
+    }
+    // If no words were measured lastInsertedWord is insertedHead, and the unchanged words are linked straight to the moved words
+    lastInsertedWord->next = firstMovedWordIndex;
+    lastUnchangedWord->next = insertedHead.next;
+    measured->measuredWordsStartIndex = head.next;
+
+    // Move the words after the edit, and recalculate the dimensions in the same pass. The minimum width excludes the trailing space of each word.
+    float lineWidth = 0;
+    float measuredWidth = 0;
+    height = 0;
+    measured->minWidth = 0;
+    measured->containsNewlines = false;
+    bool moved = false;
+    for (wordIndex = head.next; wordIndex != -1;) {
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+        moved = moved || wordIndex == firstMovedWordIndex;
+        if (moved) {
+            measuredWord->startOffset += offsetDelta;
+        }
+        if (measuredWord->length == 0) {
+            measuredWidth = CLAY__MAX(lineWidth, measuredWidth);
+            measured->containsNewlines = true;
+            lineWidth = 0;
+        } else {
+            bool finalCharIsSpace = text->chars[measuredWord->startOffset + measuredWord->length - 1] == ' ';
+            measured->minWidth = CLAY__MAX(measuredWord->width - (finalCharIsSpace ? spaceWidth : 0), measured->minWidth);
+            height = CLAY__MAX(measuredWord->height, height);
+            lineWidth += measuredWord->width;
+        }
+        wordIndex = measuredWord->next;
+    }
+    measured->unwrappedDimensions.width = CLAY__MAX(lineWidth, measuredWidth) - config->letterSpacing;
+    measured->unwrappedDimensions.height = height;
+
+    // Move the measurement to the hash bucket of the new text
+    if (elementIndexPrevious == 0) {
+        context->measureTextHashMap.internalArray[previousHashBucket] = measured->nextIndex;
+    } else {
+        Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious)->nextIndex = measured->nextIndex;
+    }
+    uint32_t hashBucket = id % (context->maxMeasureTextCacheWordCount / 32);
+    measured->nextIndex = context->measureTextHashMap.internalArray[hashBucket];
+    context->measureTextHashMap.internalArray[hashBucket] = elementIndex;
+    measured->id = id;
+    measured->generation = context->generation;
+    return measured;
+}
+
+Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config, Clay_EditableTextState *editState) {
     Clay_Context* context = Clay_GetCurrentContext();
     #ifndef CLAY_WASM
-    if (!Clay__MeasureText) {
+    if (!context->measureTextFunction) {
         if (!context->booleanWarnings.textMeasurementFunctionNotSet) {
             context->booleanWarnings.textMeasurementFunctionNotSet = true;
             context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
@@ -1614,6 +2495,13 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         }
     }
 
+    if (editState) {
+        Clay__MeasureTextCacheItem *edited = Clay__MeasureEditedText(text, config, editState, id);
+        if (edited) {
+            return edited;
+        }
+    }
+
     int32_t newItemIndex = 0;
     Clay__MeasureTextCacheItem newCacheItem = { .measuredWordsStartIndex = -1, .id = id, .generation = context->generation };
     Clay__MeasureTextCacheItem *measured = NULL;
@@ -1637,65 +2525,13 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         newItemIndex = context->measureTextHashMapInternal.length - 1;
     }
 
-    int32_t start = 0;
-    int32_t end = 0;
-    float lineWidth = 0;
-    float measuredWidth = 0;
-    float measuredHeight = 0;
-    float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
+    float spaceWidth = context->measureTextFunction(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
     Clay__MeasuredWord tempWord = { .next = -1 };
-    Clay__MeasuredWord *previousWord = &tempWord;
-    while (end < text->length) {
-        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
-            if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
-                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                    .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
-                    .errorText = CLAY_STRING("Clay has run out of space in it's internal text measurement cache. Try using Clay_SetMaxMeasureTextCacheWordCount() (default 16384, with 1 unit storing 1 measured word)."),
-                    .userData = context->errorHandler.userData });
-                context->booleanWarnings.maxTextMeasureCacheExceeded = true;
-            }
-            return &Clay__MeasureTextCacheItem_DEFAULT;
-        }
-        char current = text->chars[end];
-        if (current == ' ' || current == '\n') {
-            int32_t length = end - start;
-            Clay_Dimensions dimensions = {};
-            if (length > 0) {
-                dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config, context->measureTextUserData);
-            }
-            measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
-            measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
-            if (current == ' ') {
-                dimensions.width += spaceWidth;
-                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length + 1, .width = dimensions.width, .next = -1 }, previousWord);
-                lineWidth += dimensions.width;
-            }
-            if (current == '\n') {
-                if (length > 0) {
-                    previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = length, .width = dimensions.width, .next = -1 }, previousWord);
-                }
-                previousWord = Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = end + 1, .length = 0, .width = 0, .next = -1 }, previousWord);
-                lineWidth += dimensions.width;
-                measuredWidth = CLAY__MAX(lineWidth, measuredWidth);
-                measured->containsNewlines = true;
-                lineWidth = 0;
-            }
-            start = end + 1;
-        }
-        end++;
-    }
-    if (end - start > 0) {
-        Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
-        Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
-        lineWidth += dimensions.width;
-        measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
-        measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
+    if (!Clay__MeasureWords(text, 0, text->length, config, spaceWidth, &tempWord, &measured->minWidth, &measured->unwrappedDimensions.height)) {
+        return &Clay__MeasureTextCacheItem_DEFAULT;
     }
-    measuredWidth = CLAY__MAX(lineWidth, measuredWidth) - config->letterSpacing;
-
     measured->measuredWordsStartIndex = tempWord.next;
-    measured->unwrappedDimensions.width = measuredWidth;
-    measured->unwrappedDimensions.height = measuredHeight;
+    Clay__UpdateMeasuredTextWidth(measured, config);
 
     if (elementIndexPrevious != 0) {
         Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious)->nextIndex = newItemIndex;
@@ -1711,7 +2547,8 @@ bool Clay__PointIsInsideRect(Clay_Vector2 point, Clay_BoundingBox rect) {
 
 Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement, uint32_t idAlias) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
+    // Measured elements are discarded, so they must not replace the elements declared by the layout
+    if (context->measuring || context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
         return NULL;
     }
     Clay_LayoutElementHashMapItem item = { .elementId = elementId, .layoutElement = layoutElement, .nextIndex = -1, .generation = context->generation + 1, .idAlias = idAlias };
@@ -1810,6 +2647,9 @@ void Clay__CloseElement(void) {
     if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
+    if (context->frameSkippingEnabled) {
+        context->frameHash = Clay__HashFrameValue(context->frameHash, CLAY__FRAME_HASH_CLOSE);
+    }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
     Clay_LayoutConfig *layoutConfig = openLayoutElement->layoutConfig;
     bool elementHasClipHorizontal = false;
@@ -1904,6 +2744,20 @@ void Clay__CloseElement(void) {
 
     Clay__UpdateAspectRatioBox(openLayoutElement);
 
+    int32_t openLayoutElementIndex = Clay__int32_tArray_GetValue(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1);
+    Clay__int32_tArray_Set(&context->layoutElementSubtreeSizes, openLayoutElementIndex, context->layoutElements.length - openLayoutElementIndex);
+    Clay__LayoutElementSizing *sizing = &context->layoutElementSizing.internalArray[openLayoutElementIndex];
+    sizing->sizing[0] = layoutConfig->sizing.width;
+    sizing->sizing[1] = layoutConfig->sizing.height;
+    sizing->padding[0] = (uint32_t)layoutConfig->padding.left + layoutConfig->padding.right;
+    sizing->padding[1] = (uint32_t)layoutConfig->padding.top + layoutConfig->padding.bottom;
+    sizing->childGap = layoutConfig->childGap;
+    sizing->layoutDirection = layoutConfig->layoutDirection;
+    sizing->resizable = true;
+    sizing->hasChildContainers = openLayoutElement->childrenOrTextContent.children.length > 0;
+    sizing->clipX = elementHasClipHorizontal;
+    sizing->clipY = elementHasClipVertical;
+
     bool elementIsFloating = Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING);
 
     // Close the currently open element
@@ -1985,6 +2839,7 @@ void Clay__OpenElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
+        context->droppedElementCount++;
         return;
     }
     Clay_LayoutElement layoutElement = CLAY__DEFAULT_STRUCT;
@@ -1997,13 +2852,17 @@ void Clay__OpenElement(void) {
     }
 }
 
-void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig) {
+void Clay__OpenEditableTextElement(Clay_String text, Clay_TextElementConfig *textConfig, Clay_EditableTextState *state) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
+        context->droppedElementCount++;
         return;
     }
     Clay_LayoutElement *parentElement = Clay__GetOpenLayoutElement();
+    if (context->frameSkippingEnabled) {
+        context->frameHash = Clay__HashFrameText(context->frameHash, &text, textConfig);
+    }
 
     Clay_LayoutElement layoutElement = CLAY__DEFAULT_STRUCT;
     Clay_LayoutElement *textElement = Clay_LayoutElementArray_Add(&context->layoutElements, layoutElement);
@@ -2014,7 +2873,10 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
     }
 
     Clay__int32_tArray_Add(&context->layoutElementChildrenBuffer, context->layoutElements.length - 1);
-    Clay__MeasureTextCacheItem *textMeasured = Clay__MeasureTextCached(&text, textConfig);
+    Clay__MeasureTextCacheItem *textMeasured = Clay__MeasureTextCached(&text, textConfig, state);
+    if (state) {
+        *state = CLAY__INIT(Clay_EditableTextState) { .textLength = text.length, .measureTextCacheId = textMeasured->id, .fontId = textConfig->fontId, .fontSize = textConfig->fontSize, .letterSpacing = textConfig->letterSpacing };
+    }
     Clay_ElementId elementId = Clay__HashNumber(parentElement->childrenOrTextContent.children.length, parentElement->id);
     textElement->id = elementId.id;
     Clay__AddHashMapItem(elementId, textElement, 0);
@@ -2022,15 +2884,26 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
     Clay_Dimensions textDimensions = { .width = textMeasured->unwrappedDimensions.width, .height = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textMeasured->unwrappedDimensions.height };
     textElement->dimensions = textDimensions;
     textElement->minDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->minWidth, .height = textDimensions.height };
-    textElement->childrenOrTextContent.textElementData = Clay__TextElementDataArray_Add(&context->textElementData, CLAY__INIT(Clay__TextElementData) { .text = text, .preferredDimensions = textMeasured->unwrappedDimensions, .elementIndex = context->layoutElements.length - 1 });
+    textElement->childrenOrTextContent.textElementData = Clay__TextElementDataArray_Add(&context->textElementData, CLAY__INIT(Clay__TextElementData) { .text = text, .preferredDimensions = textMeasured->unwrappedDimensions, .elementIndex = context->layoutElements.length - 1, .measureTextCacheItem = textMeasured });
     textElement->elementConfigs = CLAY__INIT(Clay__ElementConfigArraySlice) {
             .length = 1,
             .internalArray = Clay__ElementConfigArray_Add(&context->elementConfigs, CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_TEXT, .config = { .textElementConfig = textConfig }})
     };
-    textElement->layoutConfig = &CLAY_LAYOUT_DEFAULT;
+    textElement->layoutConfig = &context->defaultLayoutConfig;
+    context->layoutElementSizing.internalArray[context->layoutElements.length - 1] = CLAY__INIT(Clay__LayoutElementSizing) {
+        .sizing = { context->defaultLayoutConfig.sizing.width, context->defaultLayoutConfig.sizing.height },
+        .padding = { (uint32_t)context->defaultLayoutConfig.padding.left + context->defaultLayoutConfig.padding.right, (uint32_t)context->defaultLayoutConfig.padding.top + context->defaultLayoutConfig.padding.bottom },
+        .childGap = context->defaultLayoutConfig.childGap,
+        .layoutDirection = context->defaultLayoutConfig.layoutDirection,
+        .resizable = textConfig->wrapMode == CLAY_TEXT_WRAP_WORDS,
+    };
     parentElement->childrenOrTextContent.children.length++;
 }
 
+void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig) {
+    Clay__OpenEditableTextElement(text, textConfig, CLAY__NULL);
+}
+
 Clay_ElementId Clay__AttachId(Clay_ElementId elementId) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->booleanWarnings.maxElementsExceeded) {
@@ -2044,10 +2917,42 @@ Clay_ElementId Clay__AttachId(Clay_ElementId elementId) {
     return elementId;
 }
 
+void Clay__OpenClipElement(Clay_LayoutElement *openLayoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray_Add(&context->openClipElementStack, (int)openLayoutElement->id);
+    if (context->measuring) {
+        return;
+    }
+    // Retrieve or create cached data to track scroll position across frames
+    Clay__ScrollContainerDataInternal *scrollOffset = CLAY__NULL;
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
+        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+        if (openLayoutElement->id == mapping->elementId) {
+            scrollOffset = mapping;
+            scrollOffset->layoutElement = openLayoutElement;
+            scrollOffset->openThisFrame = true;
+        }
+    }
+    if (!scrollOffset) {
+        scrollOffset = Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
+    }
+    if (context->externalScrollHandlingEnabled) {
+        scrollOffset->scrollPosition = context->queryScrollOffsetFunction(scrollOffset->elementId, context->queryScrollOffsetUserData);
+    }
+}
+
 void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
-    openLayoutElement->layoutConfig = Clay__StoreLayoutConfig(declaration->layout);
+    if (context->frameSkippingEnabled) {
+        context->frameHash = Clay__HashFrameDeclaration(context->frameHash, declaration);
+    }
+    if (context->configInterningEnabled && declaration->aspectRatio.aspectRatio > 0 && !context->booleanWarnings.maxElementsExceeded) {
+        // The max height of aspect ratio elements is written during layout, so their config can't be shared with other elements
+        openLayoutElement->layoutConfig = Clay__LayoutConfigArray_Add(&context->layoutConfigs, declaration->layout);
+    } else {
+        openLayoutElement->layoutConfig = Clay__StoreLayoutConfig(declaration->layout);
+    }
     if ((declaration->layout.sizing.width.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.width.size.percent > 1) || (declaration->layout.sizing.height.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.height.size.percent > 1)) {
         context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                 .errorType = CLAY_ERROR_TYPE_PERCENTAGE_OVER_1,
@@ -2058,27 +2963,16 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     Clay_ElementId openLayoutElementId = declaration->id;
 
     openLayoutElement->elementConfigs.internalArray = &context->elementConfigs.internalArray[context->elementConfigs.length];
-    Clay_SharedElementConfig *sharedConfig = NULL;
-    if (declaration->backgroundColor.a > 0) {
-        sharedConfig = Clay__StoreSharedElementConfig(CLAY__INIT(Clay_SharedElementConfig) { .backgroundColor = declaration->backgroundColor });
+    bool hasCornerRadius = !Clay__MemCmp((char *)(&declaration->cornerRadius), (char *)(&Clay__CornerRadius_DEFAULT), sizeof(Clay_CornerRadius));
+    if (declaration->backgroundColor.a > 0 || hasCornerRadius || declaration->userData != 0) {
+        // Stored in one go, because the config returned once the element limit is exceeded is shared by every context
+        Clay_SharedElementConfig *sharedConfig = Clay__StoreSharedElementConfig(CLAY__INIT(Clay_SharedElementConfig) {
+            .backgroundColor = declaration->backgroundColor.a > 0 ? declaration->backgroundColor : Clay__Color_DEFAULT,
+            .cornerRadius = declaration->cornerRadius,
+            .userData = declaration->userData
+        });
         Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .sharedElementConfig = sharedConfig }, CLAY__ELEMENT_CONFIG_TYPE_SHARED);
     }
-    if (!Clay__MemCmp((char *)(&declaration->cornerRadius), (char *)(&Clay__CornerRadius_DEFAULT), sizeof(Clay_CornerRadius))) {
-        if (sharedConfig) {
-            sharedConfig->cornerRadius = declaration->cornerRadius;
-        } else {
-            sharedConfig = Clay__StoreSharedElementConfig(CLAY__INIT(Clay_SharedElementConfig) { .cornerRadius = declaration->cornerRadius });
-            Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .sharedElementConfig = sharedConfig }, CLAY__ELEMENT_CONFIG_TYPE_SHARED);
-        }
-    }
-    if (declaration->userData != 0) {
-        if (sharedConfig) {
-            sharedConfig->userData = declaration->userData;
-        } else {
-            sharedConfig = Clay__StoreSharedElementConfig(CLAY__INIT(Clay_SharedElementConfig) { .userData = declaration->userData });
-            Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .sharedElementConfig = sharedConfig }, CLAY__ELEMENT_CONFIG_TYPE_SHARED);
-        }
-    }
     if (declaration->image.imageData) {
         Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .imageElementConfig = Clay__StoreImageElementConfig(declaration->image) }, CLAY__ELEMENT_CONFIG_TYPE_IMAGE);
     }
@@ -2141,41 +3035,130 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
 
     if (declaration->clip.horizontal | declaration->clip.vertical) {
         Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .clipElementConfig = Clay__StoreClipElementConfig(declaration->clip) }, CLAY__ELEMENT_CONFIG_TYPE_CLIP);
-        Clay__int32_tArray_Add(&context->openClipElementStack, (int)openLayoutElement->id);
-        // Retrieve or create cached data to track scroll position across frames
-        Clay__ScrollContainerDataInternal *scrollOffset = CLAY__NULL;
-        for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-            Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-            if (openLayoutElement->id == mapping->elementId) {
-                scrollOffset = mapping;
-                scrollOffset->layoutElement = openLayoutElement;
-                scrollOffset->openThisFrame = true;
-            }
-        }
-        if (!scrollOffset) {
-            scrollOffset = Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
-        }
-        if (context->externalScrollHandlingEnabled) {
-            scrollOffset->scrollPosition = Clay__QueryScrollOffset(scrollOffset->elementId, context->queryScrollOffsetUserData);
-        }
+        Clay__OpenClipElement(openLayoutElement);
     }
     if (!Clay__MemCmp((char *)(&declaration->border.width), (char *)(&Clay__BorderWidth_DEFAULT), sizeof(Clay_BorderWidth))) {
         Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .borderElementConfig = Clay__StoreBorderElementConfig(declaration->border) }, CLAY__ELEMENT_CONFIG_TYPE_BORDER);
     }
+    if (declaration->layer.cached) {
+        Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .layerElementConfig = Clay__StoreLayerElementConfig(declaration->layer) }, CLAY__ELEMENT_CONFIG_TYPE_LAYER);
+    }
 }
 
 void Clay__ConfigureOpenElement(const Clay_ElementDeclaration declaration) {
     Clay__ConfigureOpenElementPtr(&declaration);
 }
 
+Clay__StaticDeclaration* Clay__GetStaticDeclaration(const Clay_ElementDeclaration *declaration) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray *table = &context->staticDeclarationTable;
+    uint32_t hash = Clay__HashConfigValue(0, (uint32_t)((uintptr_t)declaration >> 3));
+    int32_t *slot = NULL;
+    for (int32_t i = 0; i < table->capacity; ++i) {
+        slot = &table->internalArray[(hash + i) % table->capacity];
+        if (*slot == -1) {
+            break;
+        }
+        if (context->staticDeclarations.internalArray[*slot].declaration == declaration) {
+            return &context->staticDeclarations.internalArray[*slot];
+        }
+    }
+    if (*slot != -1 || context->staticDeclarations.length == context->staticDeclarations.capacity) {
+        return NULL;
+    }
+
+    if ((declaration->layout.sizing.width.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.width.size.percent > 1) || (declaration->layout.sizing.height.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.height.size.percent > 1)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_PERCENTAGE_OVER_1,
+                .errorText = CLAY_STRING("An element was configured with CLAY_SIZING_PERCENT, but the provided percentage value was over 1.0. Clay expects a value between 0 and 1, i.e. 20% is 0.2."),
+                .userData = context->errorHandler.userData });
+    }
+    *slot = context->staticDeclarations.length;
+    Clay__StaticDeclaration *staticDeclaration = Clay__StaticDeclarationArray_Add(&context->staticDeclarations, CLAY__INIT(Clay__StaticDeclaration) {
+        .declaration = declaration,
+        .layoutConfig = declaration->layout,
+        .sharedConfig = { .backgroundColor = declaration->backgroundColor.a > 0 ? declaration->backgroundColor : Clay__Color_DEFAULT, .cornerRadius = declaration->cornerRadius, .userData = declaration->userData },
+    });
+    // Apply the same defaults as Clay__CloseElement up front, so that Clay__CloseElement never changes persistent memory
+    Clay_LayoutConfig *layoutConfig = &staticDeclaration->layoutConfig;
+    if (layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
+        if (layoutConfig->sizing.width.size.minMax.max <= 0) {
+            layoutConfig->sizing.width.size.minMax.max = CLAY__MAXFLOAT;
+        }
+    }
+    if (layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
+        if (layoutConfig->sizing.height.size.minMax.max <= 0) {
+            layoutConfig->sizing.height.size.minMax.max = CLAY__MAXFLOAT;
+        }
+    }
+    // Element configs are added in the same order as Clay__ConfigureOpenElementPtr
+    Clay_ElementConfig *configs = staticDeclaration->elementConfigs;
+    if (declaration->backgroundColor.a > 0 || !Clay__MemCmp((char *)(&declaration->cornerRadius), (char *)(&Clay__CornerRadius_DEFAULT), sizeof(Clay_CornerRadius)) || declaration->userData != 0) {
+        configs[staticDeclaration->elementConfigCount++] = CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_SHARED, .config = { .sharedElementConfig = &staticDeclaration->sharedConfig } };
+    }
+    if (declaration->image.imageData) {
+        configs[staticDeclaration->elementConfigCount++] = CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_IMAGE, .config = { .imageElementConfig = (Clay_ImageElementConfig *)&declaration->image } };
+    }
+    if (declaration->custom.customData) {
+        configs[staticDeclaration->elementConfigCount++] = CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_CUSTOM, .config = { .customElementConfig = (Clay_CustomElementConfig *)&declaration->custom } };
+    }
+    if (declaration->clip.horizontal | declaration->clip.vertical) {
+        configs[staticDeclaration->elementConfigCount++] = CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_CLIP, .config = { .clipElementConfig = (Clay_ClipElementConfig *)&declaration->clip } };
+    }
+    if (!Clay__MemCmp((char *)(&declaration->border.width), (char *)(&Clay__BorderWidth_DEFAULT), sizeof(Clay_BorderWidth))) {
+        configs[staticDeclaration->elementConfigCount++] = CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_BORDER, .config = { .borderElementConfig = (Clay_BorderElementConfig *)&declaration->border } };
+    }
+    if (declaration->layer.cached) {
+        configs[staticDeclaration->elementConfigCount++] = CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_LAYER, .config = { .layerElementConfig = (Clay_LayerElementConfig *)&declaration->layer } };
+    }
+    return staticDeclaration;
+}
+
+void Clay__ConfigureOpenElementStatic(const Clay_ElementDeclaration *declaration) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return;
+    }
+    // Floating and aspect ratio elements depend on per frame state, so they are configured in the same way as any other element
+    Clay__StaticDeclaration *staticDeclaration = NULL;
+    if (declaration->floating.attachTo == CLAY_ATTACH_TO_NONE && declaration->aspectRatio.aspectRatio == 0) {
+        staticDeclaration = Clay__GetStaticDeclaration(declaration);
+    }
+    if (!staticDeclaration) {
+        Clay__ConfigureOpenElementPtr(declaration);
+        return;
+    }
+    if (context->frameSkippingEnabled) {
+        // Static declarations are never modified, so their address identifies their contents
+        context->frameHash = Clay__HashFrameValue(Clay__HashFrameValue(context->frameHash, CLAY__FRAME_HASH_STATIC_ELEMENT), (uint64_t)(uintptr_t)declaration);
+    }
+    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    openLayoutElement->layoutConfig = &staticDeclaration->layoutConfig;
+    openLayoutElement->elementConfigs = CLAY__INIT(Clay__ElementConfigArraySlice) { .length = staticDeclaration->elementConfigCount, .internalArray = staticDeclaration->elementConfigs };
+    if (declaration->id.id != 0) {
+        Clay__AttachId(declaration->id);
+    } else if (openLayoutElement->id == 0) {
+        Clay__GenerateIdForAnonymousElement(openLayoutElement);
+    }
+    if (declaration->clip.horizontal | declaration->clip.vertical) {
+        Clay__OpenClipElement(openLayoutElement);
+    }
+}
+
 void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     int32_t maxElementCount = context->maxElementCount;
     // Ephemeral Memory - reset every frame
     Clay_Arena *arena = &context->internalArena;
     arena->nextAllocation = context->arenaResetOffset;
+    // Elements can write to their layout config when they are closed, so the shared default is reset every frame
+    context->defaultLayoutConfig = CLAY__INIT(Clay_LayoutConfig) CLAY__DEFAULT_STRUCT;
 
     context->layoutElementChildrenBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElements = Clay_LayoutElementArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSizing = Clay__LayoutElementSizingArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSizing.length = context->layoutElementSizing.capacity; // This array is accessed directly by element index rather than behaving as a list
+    context->layoutElementSubtreeSizes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSubtreeSizes.length = context->layoutElementSubtreeSizes.capacity;
     context->warnings = Clay__WarningArray_Allocate_Arena(100, arena);
 
     context->layoutConfigs = Clay__LayoutConfigArray_Allocate_Arena(maxElementCount, arena);
@@ -2187,23 +3170,23 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->clipElementConfigs = Clay__ClipElementConfigArray_Allocate_Arena(maxElementCount, arena);
     context->customElementConfigs = Clay__CustomElementConfigArray_Allocate_Arena(maxElementCount, arena);
     context->borderElementConfigs = Clay__BorderElementConfigArray_Allocate_Arena(maxElementCount, arena);
+    context->layerElementConfigs = Clay__LayerElementConfigArray_Allocate_Arena(maxElementCount, arena);
     context->sharedElementConfigs = Clay__SharedElementConfigArray_Allocate_Arena(maxElementCount, arena);
 
     context->layoutElementIdStrings = Clay__StringArray_Allocate_Arena(maxElementCount, arena);
-    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
+    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(context->maxWrappedTextLineCount, arena);
     context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->textElementData = Clay__TextElementDataArray_Allocate_Arena(maxElementCount, arena);
     context->aspectRatioElementIndexes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->renderCommands = Clay_RenderCommandArray_Allocate_Arena(maxElementCount, arena);
+    context->drawBatchCommandOrder = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->treeNodeVisited = Clay__boolArray_Allocate_Arena(maxElementCount, arena);
     context->treeNodeVisited.length = context->treeNodeVisited.capacity; // This array is accessed directly rather than behaving as a list
     context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->dynamicStringData = Clay__charArray_Allocate_Arena(maxElementCount, arena);
 }
 
 void Clay__InitializePersistentMemory(Clay_Context* context) {
@@ -2221,289 +3204,883 @@ void Clay__InitializePersistentMemory(Clay_Context* context) {
     context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
     context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(maxElementCount, arena);
+    // The output of each frame is written to the next free frame buffer, so that the output of previous frames stays
+    // intact while they are rendered, and an unchanged frame can return the previous frame's output again.
+    // The extra buffer at index frameBufferCount is the scratch buffer, used when every other buffer is in use.
+    int32_t frameBufferCount = context->frameBufferCount + 1;
+    context->frameBufferRenderCommands = Clay_RenderCommandArray_Allocate_Arena(maxElementCount * frameBufferCount, arena);
+    context->frameBufferDrawBatches = Clay_DrawBatchArray_Allocate_Arena(maxElementCount * frameBufferCount, arena);
+    context->frameBufferStringData = Clay__charArray_Allocate_Arena(context->frameStringCapacity * frameBufferCount, arena);
+    context->frameBuffers = Clay__FrameBufferArray_Allocate_Arena(frameBufferCount, arena);
     context->debugElementData = Clay__DebugElementDataArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutConfigInternTable = Clay__ConfigInternSlotArray_Allocate_Arena(maxElementCount, arena);
+    context->textElementConfigInternTable = Clay__ConfigInternSlotArray_Allocate_Arena(maxElementCount, arena);
+    context->staticTextElementConfigs = Clay__TextElementConfigArray_Allocate_Arena(256, arena);
+    context->staticTextElementConfigInternTable = Clay__int32_tArray_Allocate_Arena(512, arena);
+    context->staticDeclarations = Clay__StaticDeclarationArray_Allocate_Arena(256, arena);
+    context->staticDeclarationTable = Clay__int32_tArray_Allocate_Arena(512, arena);
     context->arenaResetOffset = arena->nextAllocation;
 }
 
-const float CLAY__EPSILON = 0.01;
-
-bool Clay__FloatEqual(float left, float right) {
-    float subtracted = left - right;
-    return subtracted < CLAY__EPSILON && subtracted > -CLAY__EPSILON;
+// Points the render command, draw batch and string data arrays at the given frame buffer
+void Clay__UseFrameBuffer(Clay_Context* context, int32_t frameBufferIndex) {
+    Clay__FrameBuffer *frameBuffer = &context->frameBuffers.internalArray[frameBufferIndex];
+    int32_t maxElementCount = context->maxElementCount;
+    context->frameBufferIndex = frameBufferIndex;
+    context->renderCommands = CLAY__INIT(Clay_RenderCommandArray) { .capacity = maxElementCount, .length = frameBuffer->renderCommandCount, .internalArray = context->frameBufferRenderCommands.internalArray + frameBufferIndex * maxElementCount };
+    context->drawBatches = CLAY__INIT(Clay_DrawBatchArray) { .capacity = maxElementCount, .length = frameBuffer->drawBatchCount, .internalArray = context->frameBufferDrawBatches.internalArray + frameBufferIndex * maxElementCount };
+    int32_t frameStringCapacity = context->frameStringCapacity;
+    context->dynamicStringData = CLAY__INIT(Clay__charArray) { .capacity = frameStringCapacity, .length = frameBuffer->stringDataLength, .internalArray = context->frameBufferStringData.internalArray + frameBufferIndex * frameStringCapacity };
 }
 
-void Clay__SizeContainersAlongAxis(bool xAxis) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
-    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
-    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
-        bfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
-        Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
-
-        // Size floating containers to their parents
-        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
-            Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
-            Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
-            if (parentItem && parentItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
-                Clay_LayoutElement *parentLayoutElement = parentItem->layoutElement;
-                switch (rootElement->layoutConfig->sizing.width.type) {
-                    case CLAY__SIZING_TYPE_GROW: {
-                        rootElement->dimensions.width = parentLayoutElement->dimensions.width;
-                        break;
-                    }
-                    case CLAY__SIZING_TYPE_PERCENT: {
-                        rootElement->dimensions.width = parentLayoutElement->dimensions.width * rootElement->layoutConfig->sizing.width.size.percent;
-                        break;
-                    }
-                    default: break;
-                }
-                switch (rootElement->layoutConfig->sizing.height.type) {
-                    case CLAY__SIZING_TYPE_GROW: {
-                        rootElement->dimensions.height = parentLayoutElement->dimensions.height;
-                        break;
-                    }
-                    case CLAY__SIZING_TYPE_PERCENT: {
-                        rootElement->dimensions.height = parentLayoutElement->dimensions.height * rootElement->layoutConfig->sizing.height.size.percent;
-                        break;
-                    }
-                    default: break;
-                }
-            }
+bool Clay__AnyFrameAcquired(Clay_Context* context) {
+    for (int32_t i = 0; i < context->frameBuffers.length; ++i) {
+        if (CLAY__ATOMIC_LOAD(&context->frameBuffers.internalArray[i].acquireCount) > 0) {
+            return true;
         }
+    }
+    return false;
+}
 
-        if (rootElement->layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
-            rootElement->dimensions.width = CLAY__MIN(CLAY__MAX(rootElement->dimensions.width, rootElement->layoutConfig->sizing.width.size.minMax.min), rootElement->layoutConfig->sizing.width.size.minMax.max);
-        }
-        if (rootElement->layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
-            rootElement->dimensions.height = CLAY__MIN(CLAY__MAX(rootElement->dimensions.height, rootElement->layoutConfig->sizing.height.size.minMax.min), rootElement->layoutConfig->sizing.height.size.minMax.max);
+// Chooses the frame buffer that the next frame is written to. The buffer holding the previous frame's output is kept for
+// Clay_AcquireFrame() and frame skipping, and acquired buffers are kept until they are released.
+void Clay__BeginFrameBuffer(Clay_Context* context) {
+    int32_t frameBufferCount = context->frameBufferCount;
+    int32_t outputIndex = context->outputFrameBufferIndex;
+    int32_t frameBufferIndex = -1;
+    for (int32_t i = 1; i <= frameBufferCount; ++i) {
+        int32_t candidate = (outputIndex + i + frameBufferCount) % frameBufferCount;
+        if (candidate != outputIndex && CLAY__ATOMIC_LOAD(&context->frameBuffers.internalArray[candidate].acquireCount) == 0) {
+            frameBufferIndex = candidate;
+            break;
         }
+    }
+    if (frameBufferIndex == -1) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_FRAME_BUFFERS_EXHAUSTED,
+            .errorText = CLAY_STRING("Clay_BeginLayout() was called while every frame buffer was acquired. The frame will be laid out into a scratch buffer that can't be acquired. Release frames with Clay_ReleaseFrame(), or increase the number of frame buffers with Clay_SetFrameBufferCount()."),
+            .userData = context->errorHandler.userData });
+        frameBufferIndex = frameBufferCount;
+    }
+    context->frameBuffers.internalArray[frameBufferIndex].renderCommandCount = 0;
+    context->frameBuffers.internalArray[frameBufferIndex].drawBatchCount = 0;
+    context->frameBuffers.internalArray[frameBufferIndex].stringDataLength = 0;
+    Clay__UseFrameBuffer(context, frameBufferIndex);
+}
 
-        for (int32_t i = 0; i < bfsBuffer.length; ++i) {
-            int32_t parentIndex = Clay__int32_tArray_GetValue(&bfsBuffer, i);
-            Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
-            Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
-            int32_t growContainerCount = 0;
-            float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
-            float parentPadding = (float)(xAxis ? (parent->layoutConfig->padding.left + parent->layoutConfig->padding.right) : (parent->layoutConfig->padding.top + parent->layoutConfig->padding.bottom));
-            float innerContentSize = 0, totalPaddingAndChildGaps = parentPadding;
-            bool sizingAlongAxis = (xAxis && parentStyleConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) || (!xAxis && parentStyleConfig->layoutDirection == CLAY_TOP_TO_BOTTOM);
-            resizableContainerBuffer.length = 0;
-            float parentChildGap = parentStyleConfig->childGap;
-
-            for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
-                int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
-                Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
-
-                if (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) && childElement->childrenOrTextContent.children.length > 0) {
-                    Clay__int32_tArray_Add(&bfsBuffer, childElementIndex);
-                }
-
-                if (childSizing.type != CLAY__SIZING_TYPE_PERCENT
-                    && childSizing.type != CLAY__SIZING_TYPE_FIXED
-                    && (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig->wrapMode == CLAY_TEXT_WRAP_WORDS)) // todo too many loops
-//                    && (xAxis || !Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT))
-                ) {
-                    Clay__int32_tArray_Add(&resizableContainerBuffer, childElementIndex);
-                }
-
-                if (sizingAlongAxis) {
-                    innerContentSize += (childSizing.type == CLAY__SIZING_TYPE_PERCENT ? 0 : childSize);
-                    if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
-                        growContainerCount++;
-                    }
-                    if (childOffset > 0) {
-                        innerContentSize += parentChildGap; // For children after index 0, the childAxisOffset is the gap from the previous child
-                        totalPaddingAndChildGaps += parentChildGap;
-                    }
-                } else {
-                    innerContentSize = CLAY__MAX(childSize, innerContentSize);
-                }
-            }
-
-            // Expand percentage containers to size
-            for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
-                int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
-                Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-                if (childSizing.type == CLAY__SIZING_TYPE_PERCENT) {
-                    *childSize = (parentSize - totalPaddingAndChildGaps) * childSizing.size.percent;
-                    if (sizingAlongAxis) {
-                        innerContentSize += *childSize;
-                    }
-                    Clay__UpdateAspectRatioBox(childElement);
-                }
-            }
-
-            if (sizingAlongAxis) {
-                float sizeToDistribute = parentSize - parentPadding - innerContentSize;
-                // The content is too large, compress the children as much as possible
-                if (sizeToDistribute < 0) {
-                    // If the parent clips content in this axis direction, don't compress children, just leave them alone
-                    Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                    if (clipElementConfig) {
-                        if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
-                            continue;
-                        }
-                    }
-                    // Scrolling containers preferentially compress before others
-                    while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float largest = 0;
-                        float secondLargest = 0;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, largest)) { continue; }
-                            if (childSize > largest) {
-                                secondLargest = largest;
-                                largest = childSize;
-                            }
-                            if (childSize < largest) {
-                                secondLargest = CLAY__MAX(secondLargest, childSize);
-                                widthToAdd = secondLargest - largest;
-                            }
-                        }
-
-                        widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float minSize = xAxis ? child->minDimensions.width : child->minDimensions.height;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, largest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize <= minSize) {
-                                    *childSize = minSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
-                // The content is too small, allow SIZING_GROW containers to expand
-                } else if (sizeToDistribute > 0 && growContainerCount > 0) {
-                    for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                        Clay__SizingType childSizing = xAxis ? child->layoutConfig->sizing.width.type : child->layoutConfig->sizing.height.type;
-                        if (childSizing != CLAY__SIZING_TYPE_GROW) {
-                            Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                        }
-                    }
-                    while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float smallest = CLAY__MAXFLOAT;
-                        float secondSmallest = CLAY__MAXFLOAT;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, smallest)) { continue; }
-                            if (childSize < smallest) {
-                                secondSmallest = smallest;
-                                smallest = childSize;
-                            }
-                            if (childSize > smallest) {
-                                secondSmallest = CLAY__MIN(secondSmallest, childSize);
-                                widthToAdd = secondSmallest - smallest;
-                            }
-                        }
+// Records the lengths of the current frame's output, and makes it the output returned by Clay_AcquireFrame().
+// Output in the scratch buffer is never published, and the previous output stays the one kept for frame skipping.
+void Clay__EndFrameBuffer(Clay_Context* context) {
+    Clay__FrameBuffer *frameBuffer = &context->frameBuffers.internalArray[context->frameBufferIndex];
+    frameBuffer->renderCommandCount = context->renderCommands.length;
+    frameBuffer->drawBatchCount = context->drawBatches.length;
+    frameBuffer->stringDataLength = context->dynamicStringData.length;
+    if (context->frameBufferIndex == context->frameBufferCount) {
+        context->previousFrameHash = 0;
+        return;
+    }
+    context->outputFrameBufferIndex = context->frameBufferIndex;
+}
 
-                        widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float maxSize = xAxis ? child->layoutConfig->sizing.width.size.minMax.max : child->layoutConfig->sizing.height.size.minMax.max;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, smallest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize >= maxSize) {
-                                    *childSize = maxSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
-                }
-            // Sizing along the non layout axis ("off axis")
-            } else {
-                for (int32_t childOffset = 0; childOffset < resizableContainerBuffer.length; childOffset++) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childOffset));
-                    Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                    float minSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
-                    float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-
-                    float maxSize = parentSize - parentPadding;
-                    // If we're laying out the children of a scroll panel, grow containers expand to the size of the inner content, not the outer container
-                    if (Clay__ElementHasConfig(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
-                        Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                        if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
-                            maxSize = CLAY__MAX(maxSize, innerContentSize);
-                        }
-                    }
-                    if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
-                        *childSize = CLAY__MIN(maxSize, childSizing.size.minMax.max);
-                    }
-                    *childSize = CLAY__MAX(minSize, CLAY__MIN(*childSize, maxSize));
-                }
-            }
-        }
+void Clay__InitializePersistentTables(Clay_Context* context) {
+    for (int32_t i = 0; i < context->layoutConfigInternTable.capacity; ++i) {
+        context->layoutConfigInternTable.internalArray[i] = CLAY__INIT(Clay__ConfigInternSlot) { .index = -1 };
+        context->textElementConfigInternTable.internalArray[i] = CLAY__INIT(Clay__ConfigInternSlot) { .index = -1 };
+    }
+    for (int32_t i = 0; i < context->staticTextElementConfigInternTable.capacity; ++i) {
+        context->staticTextElementConfigInternTable.internalArray[i] = -1;
+    }
+    for (int32_t i = 0; i < context->staticDeclarationTable.capacity; ++i) {
+        context->staticDeclarationTable.internalArray[i] = -1;
     }
+    context->frameBuffers.length = context->frameBuffers.capacity;
+    for (int32_t i = 0; i < context->frameBuffers.length; ++i) {
+        context->frameBuffers.internalArray[i] = CLAY__INIT(Clay__FrameBuffer) CLAY__DEFAULT_STRUCT;
+    }
+    context->outputFrameBufferIndex = -1;
+    Clay__UseFrameBuffer(context, 0);
 }
 
-Clay_String Clay__IntToString(int32_t integer) {
-    if (integer == 0) {
-        return CLAY__INIT(Clay_String) { .length = 1, .chars = "0" };
+bool Clay__GrowInternalMemory(Clay_Context* context, int32_t maxElementCount, int32_t maxMeasureTextCacheWordCount, int32_t frameBufferCount, int32_t frameStringCapacity, int32_t maxWrappedTextLineCount) {
+    Clay_Context sizingContext = {
+        .maxElementCount = maxElementCount,
+        .maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount,
+        .frameBufferCount = frameBufferCount,
+        .frameStringCapacity = frameStringCapacity,
+        .maxWrappedTextLineCount = maxWrappedTextLineCount,
+        .internalArena = { .capacity = SIZE_MAX, .memory = NULL }
+    };
+    Clay__InitializePersistentMemory(&sizingContext);
+    Clay__InitializeEphemeralMemory(&sizingContext);
+    size_t newMemorySize = sizingContext.internalArena.nextAllocation + 128;
+    char *newMemory = (char *)context->allocator.allocateFunction(newMemorySize, context->allocator.userData);
+    if (!newMemory) {
+        return false;
     }
-    Clay_Context* context = Clay_GetCurrentContext();
-    char *chars = (char *)(context->dynamicStringData.internalArray + context->dynamicStringData.length);
-    int32_t length = 0;
-    int32_t sign = integer;
 
-    if (integer < 0) {
-        integer = -integer;
+    // Persistent data is copied across, ephemeral data is rebuilt by the next call to Clay__InitializeEphemeralMemory
+    Clay_Context old = *context;
+    uintptr_t baseOffset = 64 - ((uintptr_t)newMemory % 64);
+    baseOffset = baseOffset == 64 ? 0 : baseOffset;
+    context->internalArena = CLAY__INIT(Clay_Arena) { .capacity = newMemorySize - baseOffset, .memory = newMemory + baseOffset };
+    context->maxElementCount = maxElementCount;
+    context->maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    context->frameBufferCount = frameBufferCount;
+    context->frameStringCapacity = frameStringCapacity;
+    context->maxWrappedTextLineCount = maxWrappedTextLineCount;
+    Clay__InitializePersistentMemory(context);
+
+    // Layout elements from the previous frame live in the old memory block, so any references to them are cleared
+    for (int32_t i = 0; i < old.scrollContainerDatas.length; ++i) {
+        Clay__ScrollContainerDataInternal scrollData = old.scrollContainerDatas.internalArray[i];
+        scrollData.layoutElement = &Clay_LayoutElement_DEFAULT;
+        Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, scrollData);
+    }
+    for (int32_t i = 0; i < old.debugElementData.length; ++i) {
+        Clay__DebugElementDataArray_Add(&context->debugElementData, old.debugElementData.internalArray[i]);
+    }
+    for (int32_t i = 0; i < old.pointerOverIds.length; ++i) {
+        Clay_ElementIdArray_Add(&context->pointerOverIds, old.pointerOverIds.internalArray[i]);
+    }
+    // Render commands from the previous frame were left in the old memory block, so they can't be reused by the next frame
+    context->previousFrameHash = 0;
+    // Static declarations hold pointers into their own pool, so they are rebuilt on next use rather than copied
+    Clay__InitializePersistentTables(context);
+    // Configs returned by CLAY_TEXT_CONFIG_STATIC() may be held by the user across frames, so their pool stays where it is rather than moving
+    // to the new block. It was allocated from the memory passed to Clay_Initialize(), which is never freed by clay.
+    context->staticTextElementConfigs = old.staticTextElementConfigs;
+    context->staticTextElementConfigInternTable = old.staticTextElementConfigInternTable;
+    for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
+        context->layoutElementsHashMap.internalArray[i] = -1;
     }
-    while (integer > 0) {
-        chars[length++] = (char)(integer % 10 + '0');
-        integer /= 10;
+    for (int32_t i = 0; i < old.layoutElementsHashMapInternal.length; ++i) {
+        Clay_LayoutElementHashMapItem item = old.layoutElementsHashMapInternal.internalArray[i];
+        uint32_t hashBucket = item.elementId.id % context->layoutElementsHashMap.capacity;
+        item.layoutElement = &Clay_LayoutElement_DEFAULT;
+        item.debugData = context->debugElementData.internalArray + (item.debugData - old.debugElementData.internalArray);
+        item.nextIndex = context->layoutElementsHashMap.internalArray[hashBucket];
+        context->layoutElementsHashMap.internalArray[hashBucket] = i;
+        Clay__LayoutElementHashMapItemArray_Add(&context->layoutElementsHashMapInternal, item);
     }
 
-    if (sign < 0) {
-        chars[length++] = '-';
+    // Measured words and cache items are referenced by index, so they can be copied directly before rebuilding the buckets
+    for (int32_t i = 0; i < old.measuredWords.length; ++i) {
+        Clay__MeasuredWordArray_Add(&context->measuredWords, old.measuredWords.internalArray[i]);
+    }
+    for (int32_t i = 0; i < old.measuredWordsFreeList.length; ++i) {
+        Clay__int32_tArray_Add(&context->measuredWordsFreeList, old.measuredWordsFreeList.internalArray[i]);
+    }
+    for (int32_t i = 0; i < old.measureTextHashMapInternalFreeList.length; ++i) {
+        Clay__int32_tArray_Add(&context->measureTextHashMapInternalFreeList, old.measureTextHashMapInternalFreeList.internalArray[i]);
+    }
+    for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
+        context->measureTextHashMap.internalArray[i] = 0;
+    }
+    for (int32_t i = 0; i < old.measureTextHashMapInternal.length; ++i) {
+        Clay__MeasureTextCacheItemArray_Add(&context->measureTextHashMapInternal, old.measureTextHashMapInternal.internalArray[i]);
+    }
+    // Only items reachable from the old buckets are relinked, items that failed part way through measurement were never linked
+    for (int32_t bucket = 0; bucket < old.maxMeasureTextCacheWordCount / 32; ++bucket) {
+        int32_t itemIndex = old.measureTextHashMap.internalArray[bucket];
+        while (itemIndex != 0) {
+            Clay__MeasureTextCacheItem *item = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, itemIndex);
+            int32_t nextIndex = item->nextIndex;
+            uint32_t hashBucket = item->id % (context->maxMeasureTextCacheWordCount / 32);
+            item->nextIndex = context->measureTextHashMap.internalArray[hashBucket];
+            context->measureTextHashMap.internalArray[hashBucket] = itemIndex;
+            itemIndex = nextIndex;
+        }
     }
 
-    // Reverse the string to get the correct order
-    for (int32_t j = 0, k = length - 1; j < k; j++, k--) {
-        char temp = chars[j];
-        chars[j] = chars[k];
-        chars[k] = temp;
+    if (old.allocatedMemory) {
+        context->allocator.freeFunction(old.allocatedMemory, old.allocatedMemorySize, context->allocator.userData);
     }
-    context->dynamicStringData.length += length;
-    return CLAY__INIT(Clay_String) { .length = length, .chars = chars };
+    context->allocatedMemory = newMemory;
+    context->allocatedMemorySize = newMemorySize;
+    return true;
 }
 
-void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    if (context->renderCommands.length < context->renderCommands.capacity - 1) {
-        Clay_RenderCommandArray_Add(&context->renderCommands, renderCommand);
-    } else {
-        if (!context->booleanWarnings.maxRenderCommandsExceeded) {
-            context->booleanWarnings.maxRenderCommandsExceeded = true;
-            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
-                .errorText = CLAY_STRING("Clay ran out of capacity while attempting to create render commands. This is usually caused by a large amount of wrapping text elements while close to the max element capacity. Try using Clay_SetMaxElementCount() with a higher value."),
-                .userData = context->errorHandler.userData });
+void Clay__GrowInternalMemoryIfRequired(Clay_Context* context) {
+    // Acquired frames live in the current memory block, so growing is postponed until they have been released
+    if (!context->allocator.allocateFunction || Clay__AnyFrameAcquired(context)) {
+        return;
+    }
+    int32_t maxElementCount = CLAY__MAX(context->maxElementCount, context->requestedMaxElementCount);
+    int32_t maxMeasureTextCacheWordCount = CLAY__MAX(context->maxMeasureTextCacheWordCount, context->requestedMaxMeasureTextCacheWordCount);
+    if (context->booleanWarnings.maxElementsExceeded || context->booleanWarnings.maxRenderCommandsExceeded || context->layoutElementsHashMapInternal.length >= context->layoutElementsHashMapInternal.capacity - 1) {
+        maxElementCount = CLAY__MAX(maxElementCount * 2, context->layoutElements.length + context->droppedElementCount * 2);
+    }
+    if (context->booleanWarnings.maxTextMeasureCacheExceeded) {
+        if (context->measureTextHashMapInternal.length >= context->measureTextHashMapInternal.capacity - 1) {
+            maxElementCount = CLAY__MAX(maxElementCount, context->maxElementCount * 2);
+        } else {
+            maxMeasureTextCacheWordCount *= 2;
         }
     }
+    // The measure text hash map has one bucket per 32 words, but is allocated with maxElementCount entries
+    maxElementCount = CLAY__MAX(maxElementCount, maxMeasureTextCacheWordCount / 32);
+    context->requestedMaxElementCount = 0;
+    context->requestedMaxMeasureTextCacheWordCount = 0;
+    int32_t frameBufferCount = context->requestedFrameBufferCount ? context->requestedFrameBufferCount : context->frameBufferCount;
+    context->requestedFrameBufferCount = 0;
+    int32_t frameStringCapacity = CLAY__MAX(context->frameStringCapacity, context->requestedFrameStringCapacity);
+    context->requestedFrameStringCapacity = 0;
+    if (context->booleanWarnings.frameStringCapacityExceeded) {
+        frameStringCapacity *= 2;
+    }
+    int32_t maxWrappedTextLineCount = CLAY__MAX(context->maxWrappedTextLineCount, context->requestedMaxWrappedTextLineCount);
+    context->requestedMaxWrappedTextLineCount = 0;
+    if (context->booleanWarnings.maxWrappedTextLinesExceeded) {
+        maxWrappedTextLineCount *= 2;
+    }
+    if (maxElementCount == context->maxElementCount && maxMeasureTextCacheWordCount == context->maxMeasureTextCacheWordCount && frameBufferCount == context->frameBufferCount
+        && frameStringCapacity == context->frameStringCapacity && maxWrappedTextLineCount == context->maxWrappedTextLineCount) {
+        return;
+    }
+    if (!Clay__GrowInternalMemory(context, maxElementCount, maxMeasureTextCacheWordCount, frameBufferCount, frameStringCapacity, maxWrappedTextLineCount)) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+            .errorText = CLAY_STRING("Clay attempted to grow its internal memory, but the allocator provided with Clay_SetAllocator() returned NULL."),
+            .userData = context->errorHandler.userData });
+    }
 }
 
-bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
+const float CLAY__EPSILON = 0.01;
+
+bool Clay__FloatEqual(float left, float right) {
+    float subtracted = left - right;
+    return subtracted < CLAY__EPSILON && subtracted > -CLAY__EPSILON;
+}
+
+typedef struct {
+    Clay_Context *context;
+    bool xAxis;
+    float direction; // 1 when growing children, -1 when compressing them
+} Clay__SpaceDistribution;
+
+// Sizes are negated when compressing, so that growing and compressing can share the same code
+float Clay__DistributionSize(Clay__SpaceDistribution *distribution, int32_t elementIndex) {
+    Clay_LayoutElement *element = &distribution->context->layoutElements.internalArray[elementIndex];
+    return distribution->direction * (distribution->xAxis ? element->dimensions.width : element->dimensions.height);
+}
+
+void Clay__DistributionSetSize(Clay__SpaceDistribution *distribution, int32_t elementIndex, float size) {
+    Clay_LayoutElement *element = &distribution->context->layoutElements.internalArray[elementIndex];
+    *(distribution->xAxis ? &element->dimensions.width : &element->dimensions.height) = distribution->direction * size;
+}
+
+// The size at which a child stops growing (its max size) or compressing (its min size)
+float Clay__DistributionLimit(Clay__SpaceDistribution *distribution, int32_t elementIndex) {
+    if (distribution->direction > 0) {
+        return distribution->context->layoutElementSizing.internalArray[elementIndex].sizing[distribution->xAxis ? 0 : 1].size.minMax.max;
+    }
+    Clay_LayoutElement *element = &distribution->context->layoutElements.internalArray[elementIndex];
+    return -(distribution->xAxis ? element->minDimensions.width : element->minDimensions.height);
+}
+
+// The heap holds the largest size at its root when sorting, or the smallest limit when byLimit is set
+float Clay__DistributionHeapKey(Clay__SpaceDistribution *distribution, int32_t elementIndex, bool byLimit) {
+    return byLimit ? -Clay__DistributionLimit(distribution, elementIndex) : Clay__DistributionSize(distribution, elementIndex);
+}
+
+void Clay__DistributionSiftDown(Clay__SpaceDistribution *distribution, int32_t *heap, int32_t length, int32_t index, bool byLimit) {
+    while (true) {
+        int32_t largest = index;
+        int32_t left = index * 2 + 1;
+        int32_t right = left + 1;
+        if (left < length && Clay__DistributionHeapKey(distribution, heap[left], byLimit) > Clay__DistributionHeapKey(distribution, heap[largest], byLimit)) {
+            largest = left;
+        }
+        if (right < length && Clay__DistributionHeapKey(distribution, heap[right], byLimit) > Clay__DistributionHeapKey(distribution, heap[largest], byLimit)) {
+            largest = right;
+        }
+        if (largest == index) {
+            return;
+        }
+        int32_t swap = heap[index];
+        heap[index] = heap[largest];
+        heap[largest] = swap;
+        index = largest;
+    }
+}
+
+void Clay__DistributionSiftUp(Clay__SpaceDistribution *distribution, int32_t *heap, int32_t index, bool byLimit) {
+    while (index > 0) {
+        int32_t parent = (index - 1) / 2;
+        if (Clay__DistributionHeapKey(distribution, heap[index], byLimit) <= Clay__DistributionHeapKey(distribution, heap[parent], byLimit)) {
+            return;
+        }
+        int32_t swap = heap[index];
+        heap[index] = heap[parent];
+        heap[parent] = swap;
+        index = parent;
+    }
+}
+
+// Grows the children in the buffer by sizeToDistribute in total, or compresses them if it is negative, evening out their sizes.
+// The children are sorted by size once, then a "water level" is raised from the smallest (or lowered from the largest when compressing).
+// Each child joins the level once it reaches the child's size, and leaves at its limit, so a row of k children takes O(k log k).
+void Clay__DistributeSpace(Clay_Context *context, bool xAxis, Clay__int32_tArray *children, float sizeToDistribute) {
+    Clay__SpaceDistribution distribution = { .context = context, .xAxis = xAxis, .direction = sizeToDistribute > 0 ? 1.0f : -1.0f };
+    float remaining = distribution.direction * sizeToDistribute;
+    int32_t *buffer = children->internalArray;
+    int32_t count = children->length;
+    if (remaining <= CLAY__EPSILON || count == 0) {
+        return;
+    }
+    // If every child can reach its limit with the space there is, nothing needs to be sorted
+    float spaceToLimits = 0;
+    for (int32_t i = 0; i < count; ++i) {
+        spaceToLimits += Clay__DistributionLimit(&distribution, buffer[i]) - Clay__DistributionSize(&distribution, buffer[i]);
+    }
+    if (spaceToLimits <= remaining) {
+        for (int32_t i = 0; i < count; ++i) {
+            Clay__DistributionSetSize(&distribution, buffer[i], Clay__DistributionLimit(&distribution, buffer[i]));
+        }
+        return;
+    }
+    // Heap sort the children so the smallest comes first, unless they already are, which is common as siblings often start out the same size
+    int32_t sortedCount = 1;
+    while (sortedCount < count && Clay__DistributionSize(&distribution, buffer[sortedCount - 1]) <= Clay__DistributionSize(&distribution, buffer[sortedCount])) {
+        sortedCount++;
+    }
+    if (sortedCount < count) {
+        for (int32_t i = count / 2 - 1; i >= 0; --i) {
+            Clay__DistributionSiftDown(&distribution, buffer, count, i, false);
+        }
+        for (int32_t end = count - 1; end > 0; --end) {
+            int32_t swap = buffer[0];
+            buffer[0] = buffer[end];
+            buffer[end] = swap;
+            Clay__DistributionSiftDown(&distribution, buffer, end, 0, false);
+        }
+    }
+    // Children at the level are kept in a heap ordered by limit, in the space before the children that haven't joined yet
+    int32_t joinedCount = 0;
+    int32_t nextIndex = 0;
+    float level = Clay__DistributionSize(&distribution, buffer[0]);
+    while (true) {
+        while (nextIndex < count && Clay__DistributionSize(&distribution, buffer[nextIndex]) <= level) {
+            buffer[joinedCount] = buffer[nextIndex++];
+            Clay__DistributionSiftUp(&distribution, buffer, joinedCount++, true);
+        }
+        while (joinedCount > 0 && Clay__DistributionLimit(&distribution, buffer[0]) <= level) {
+            Clay__DistributionSetSize(&distribution, buffer[0], Clay__DistributionLimit(&distribution, buffer[0]));
+            buffer[0] = buffer[--joinedCount];
+            Clay__DistributionSiftDown(&distribution, buffer, joinedCount, 0, true);
+        }
+        if (joinedCount == 0) {
+            if (nextIndex == count) {
+                break;
+            }
+            level = Clay__DistributionSize(&distribution, buffer[nextIndex]);
+            continue;
+        }
+        float nextLevel = Clay__DistributionLimit(&distribution, buffer[0]);
+        if (nextIndex < count) {
+            nextLevel = CLAY__MIN(nextLevel, Clay__DistributionSize(&distribution, buffer[nextIndex]));
+        }
+        float sizeToNextLevel = (nextLevel - level) * (float)joinedCount;
+        if (sizeToNextLevel >= remaining) {
+            level += remaining / (float)joinedCount;
+            break;
+        }
+        remaining -= sizeToNextLevel;
+        level = nextLevel;
+    }
+    for (int32_t i = 0; i < joinedCount; ++i) {
+        Clay__DistributionSetSize(&distribution, buffer[i], level);
+    }
+}
+
+// Sizes the children of a single container along one axis, and appends the children that are containers themselves to bfsBuffer.
+// If deferredSubtrees is set, child containers with at most maxDeferredSubtreeSize elements are appended there instead, to be sized as a separate job.
+void Clay__SizeChildrenAlongAxis(Clay_Context *context, int32_t parentIndex, bool xAxis, Clay__int32_tArray *bfsBuffer, Clay__int32_tArray *resizableContainerBuffer, Clay__int32_tArray *deferredSubtrees, int32_t maxDeferredSubtreeSize) {
+    int32_t axis = xAxis ? 0 : 1;
+    Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
+    Clay__LayoutElementSizing *parentSizing = &context->layoutElementSizing.internalArray[parentIndex];
+    int32_t growContainerCount = 0;
+    float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
+    float parentPadding = (float)parentSizing->padding[axis];
+    float innerContentSize = 0, totalPaddingAndChildGaps = parentPadding;
+    bool sizingAlongAxis = (xAxis && parentSizing->layoutDirection == CLAY_LEFT_TO_RIGHT) || (!xAxis && parentSizing->layoutDirection == CLAY_TOP_TO_BOTTOM);
+    resizableContainerBuffer->length = 0;
+    float parentChildGap = (float)parentSizing->childGap;
+
+    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+        int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
+        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+        Clay__LayoutElementSizing *childElementSizing = &context->layoutElementSizing.internalArray[childElementIndex];
+        Clay_SizingAxis childSizing = childElementSizing->sizing[axis];
+        float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
+
+        if (childElementSizing->hasChildContainers) {
+            if (deferredSubtrees && context->layoutElementSubtreeSizes.internalArray[childElementIndex] <= maxDeferredSubtreeSize) {
+                Clay__int32_tArray_Add(deferredSubtrees, childElementIndex);
+            } else {
+                Clay__int32_tArray_Add(bfsBuffer, childElementIndex);
+            }
+        }
+
+        if (childSizing.type != CLAY__SIZING_TYPE_PERCENT
+            && childSizing.type != CLAY__SIZING_TYPE_FIXED
+            && childElementSizing->resizable
+//            && (xAxis || !Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT))
+        ) {
+            Clay__int32_tArray_Add(resizableContainerBuffer, childElementIndex);
+        }
+
+        if (sizingAlongAxis) {
+            innerContentSize += (childSizing.type == CLAY__SIZING_TYPE_PERCENT ? 0 : childSize);
+            if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
+                growContainerCount++;
+            }
+            if (childOffset > 0) {
+                innerContentSize += parentChildGap; // For children after index 0, the childAxisOffset is the gap from the previous child
+                totalPaddingAndChildGaps += parentChildGap;
+            }
+        } else {
+            innerContentSize = CLAY__MAX(childSize, innerContentSize);
+        }
+    }
+
+    // Expand percentage containers to size
+    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+        int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
+        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+        Clay_SizingAxis childSizing = context->layoutElementSizing.internalArray[childElementIndex].sizing[axis];
+        float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
+        if (childSizing.type == CLAY__SIZING_TYPE_PERCENT) {
+            *childSize = (parentSize - totalPaddingAndChildGaps) * childSizing.size.percent;
+            if (sizingAlongAxis) {
+                innerContentSize += *childSize;
+            }
+            Clay__UpdateAspectRatioBox(childElement);
+        }
+    }
+
+    if (sizingAlongAxis) {
+        float sizeToDistribute = parentSize - parentPadding - innerContentSize;
+        // The content is too large, compress the children as much as possible
+        if (sizeToDistribute < 0) {
+            // If the parent clips content in this axis direction, don't compress children, just leave them alone
+            if (xAxis ? parentSizing->clipX : parentSizing->clipY) {
+                return;
+            }
+            Clay__DistributeSpace(context, xAxis, resizableContainerBuffer, sizeToDistribute);
+        // The content is too small, allow SIZING_GROW containers to expand
+        } else if (sizeToDistribute > 0 && growContainerCount > 0) {
+            for (int childIndex = 0; childIndex < resizableContainerBuffer->length; childIndex++) {
+                Clay__SizingType childSizing = context->layoutElementSizing.internalArray[Clay__int32_tArray_GetValue(resizableContainerBuffer, childIndex)].sizing[axis].type;
+                if (childSizing != CLAY__SIZING_TYPE_GROW) {
+                    Clay__int32_tArray_RemoveSwapback(resizableContainerBuffer, childIndex--);
+                }
+            }
+            Clay__DistributeSpace(context, xAxis, resizableContainerBuffer, sizeToDistribute);
+        }
+    // Sizing along the non layout axis ("off axis")
+    } else {
+        for (int32_t childOffset = 0; childOffset < resizableContainerBuffer->length; childOffset++) {
+            int32_t childElementIndex = Clay__int32_tArray_GetValue(resizableContainerBuffer, childOffset);
+            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
+            Clay_SizingAxis childSizing = context->layoutElementSizing.internalArray[childElementIndex].sizing[axis];
+            float minSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
+            float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
+
+            float maxSize = parentSize - parentPadding;
+            // If we're laying out the children of a scroll panel, grow containers expand to the size of the inner content, not the outer container
+            if (xAxis ? parentSizing->clipX : parentSizing->clipY) {
+                maxSize = CLAY__MAX(maxSize, innerContentSize);
+            }
+            if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
+                *childSize = CLAY__MIN(maxSize, childSizing.size.minMax.max);
+            }
+            *childSize = CLAY__MAX(minSize, CLAY__MIN(*childSize, maxSize));
+        }
+    }
+}
+
+#define CLAY__PARALLEL_DEFAULT_JOB_ELEMENT_COUNT 1024
+#define CLAY__PARALLEL_MAX_JOBS 64
+
+typedef struct {
+    Clay_Context *context;
+    bool xAxis;
+    Clay__int32_tArray subtrees;
+    int32_t subtreeStarts[CLAY__PARALLEL_MAX_JOBS + 1]; // Job i sizes subtrees[subtreeStarts[i]] up to subtrees[subtreeStarts[i + 1]]
+    int32_t scratchOffsets[CLAY__PARALLEL_MAX_JOBS + 1]; // Job i uses elements scratchOffsets[i] up to scratchOffsets[i + 1] of the scratch buffers
+} Clay__SizingJobs;
+
+void Clay__SizeSubtreesJob(int32_t jobIndex, void *jobData) {
+    Clay__SizingJobs *jobs = (Clay__SizingJobs *)jobData;
+    Clay_Context *context = jobs->context;
+    int32_t scratchOffset = jobs->scratchOffsets[jobIndex];
+    int32_t scratchCapacity = jobs->scratchOffsets[jobIndex + 1] - scratchOffset;
+    Clay__int32_tArray bfsBuffer = { .capacity = scratchCapacity, .length = 0, .internalArray = context->layoutElementChildrenBuffer.internalArray + scratchOffset };
+    Clay__int32_tArray resizableContainerBuffer = { .capacity = scratchCapacity, .length = 0, .internalArray = context->openLayoutElementStack.internalArray + scratchOffset };
+    for (int32_t subtreeIndex = jobs->subtreeStarts[jobIndex]; subtreeIndex < jobs->subtreeStarts[jobIndex + 1]; ++subtreeIndex) {
+        bfsBuffer.length = 0;
+        Clay__int32_tArray_Add(&bfsBuffer, jobs->subtrees.internalArray[subtreeIndex]);
+        for (int32_t i = 0; i < bfsBuffer.length; ++i) {
+            Clay__SizeChildrenAlongAxis(context, bfsBuffer.internalArray[i], jobs->xAxis, &bfsBuffer, &resizableContainerBuffer, NULL, 0);
+        }
+    }
+}
+
+// Sizes subtrees whose roots have already been sized, grouping them into jobs of roughly jobElementCount elements.
+// The subtrees are disjoint ranges of the layout element array, so each job gets a slice of the BFS and resizable container buffers
+// as large as its subtrees, and the slices together never need more than the buffers' capacity of one entry per element.
+void Clay__SizeSubtreesInParallel(Clay_Context *context, bool xAxis, Clay__int32_tArray subtrees, int32_t jobElementCount) {
+    Clay__SizingJobs jobs = { .context = context, .xAxis = xAxis, .subtrees = subtrees };
+    int32_t jobCount = 0;
+    int32_t jobSize = 0;
+    int32_t scratchOffset = 0;
+    for (int32_t i = 0; i < subtrees.length; ++i) {
+        if (jobSize == 0 || (jobSize >= jobElementCount && jobCount < CLAY__PARALLEL_MAX_JOBS)) {
+            jobs.subtreeStarts[jobCount] = i;
+            jobs.scratchOffsets[jobCount] = scratchOffset;
+            jobCount++;
+            jobSize = 0;
+        }
+        int32_t subtreeElementCount = context->layoutElementSubtreeSizes.internalArray[subtrees.internalArray[i]];
+        jobSize += subtreeElementCount;
+        scratchOffset += subtreeElementCount;
+    }
+    jobs.subtreeStarts[jobCount] = subtrees.length;
+    jobs.scratchOffsets[jobCount] = scratchOffset;
+    if (jobCount == 1) {
+        Clay__SizeSubtreesJob(0, &jobs);
+    } else {
+        context->parallelExecutor.parallelForFunction(jobCount, Clay__SizeSubtreesJob, &jobs, context->parallelExecutor.userData);
+    }
+}
+
+// Sizes the trees from firstRootIndex onwards along one axis
+void Clay__SizeContainersAlongAxis(bool xAxis, int32_t firstRootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // The space past the end of these buffers is used, as their contents are still needed when measuring during a layout
+    Clay__int32_tArray bfsBuffer = { .capacity = context->layoutElementChildrenBuffer.capacity - context->layoutElementChildrenBuffer.length, .length = 0, .internalArray = context->layoutElementChildrenBuffer.internalArray + context->layoutElementChildrenBuffer.length };
+    Clay__int32_tArray resizableContainerBuffer = { .capacity = context->openLayoutElementStack.capacity - context->openLayoutElementStack.length, .length = 0, .internalArray = context->openLayoutElementStack.internalArray + context->openLayoutElementStack.length };
+    // Unused elsewhere, holds the roots of subtrees that are sized as parallel jobs
+    Clay__int32_tArray deferredSubtrees = context->reusableElementIndexBuffer;
+    int32_t minimumJobElementCount = context->parallelExecutor.minimumJobElementCount > 0 ? context->parallelExecutor.minimumJobElementCount : CLAY__PARALLEL_DEFAULT_JOB_ELEMENT_COUNT;
+    for (int32_t rootIndex = firstRootIndex; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        bfsBuffer.length = 0;
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
+        Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
+
+        // Size floating containers to their parents
+        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+            Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
+            Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
+            if (parentItem && parentItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
+                Clay_LayoutElement *parentLayoutElement = parentItem->layoutElement;
+                switch (rootElement->layoutConfig->sizing.width.type) {
+                    case CLAY__SIZING_TYPE_GROW: {
+                        rootElement->dimensions.width = parentLayoutElement->dimensions.width;
+                        break;
+                    }
+                    case CLAY__SIZING_TYPE_PERCENT: {
+                        rootElement->dimensions.width = parentLayoutElement->dimensions.width * rootElement->layoutConfig->sizing.width.size.percent;
+                        break;
+                    }
+                    default: break;
+                }
+                switch (rootElement->layoutConfig->sizing.height.type) {
+                    case CLAY__SIZING_TYPE_GROW: {
+                        rootElement->dimensions.height = parentLayoutElement->dimensions.height;
+                        break;
+                    }
+                    case CLAY__SIZING_TYPE_PERCENT: {
+                        rootElement->dimensions.height = parentLayoutElement->dimensions.height * rootElement->layoutConfig->sizing.height.size.percent;
+                        break;
+                    }
+                    default: break;
+                }
+            }
+        }
+
+        if (rootElement->layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
+            rootElement->dimensions.width = CLAY__MIN(CLAY__MAX(rootElement->dimensions.width, rootElement->layoutConfig->sizing.width.size.minMax.min), rootElement->layoutConfig->sizing.width.size.minMax.max);
+        }
+        if (rootElement->layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
+            rootElement->dimensions.height = CLAY__MIN(CLAY__MAX(rootElement->dimensions.height, rootElement->layoutConfig->sizing.height.size.minMax.min), rootElement->layoutConfig->sizing.height.size.minMax.max);
+        }
+
+        // Subtrees small enough to be a single job are deferred, larger ones are broken down further by the BFS
+        int32_t rootElementCount = context->layoutElementSubtreeSizes.internalArray[root->layoutElementIndex];
+        // Parallel jobs use the scratch buffers from the start, so they aren't used while measuring
+        bool parallel = context->parallelExecutor.parallelForFunction && !context->measuring && rootElementCount >= minimumJobElementCount * 2;
+        int32_t jobElementCount = CLAY__MAX(minimumJobElementCount, (rootElementCount + CLAY__PARALLEL_MAX_JOBS - 1) / CLAY__PARALLEL_MAX_JOBS);
+        deferredSubtrees.length = 0;
+        for (int32_t i = 0; i < bfsBuffer.length; ++i) {
+            Clay__SizeChildrenAlongAxis(context, Clay__int32_tArray_GetValue(&bfsBuffer, i), xAxis, &bfsBuffer, &resizableContainerBuffer, parallel ? &deferredSubtrees : NULL, jobElementCount);
+        }
+        if (deferredSubtrees.length > 0) {
+            Clay__SizeSubtreesInParallel(context, xAxis, deferredSubtrees, jobElementCount);
+        }
+    }
+}
+
+// Frame strings are appended to the string data of the current frame buffer. Appending continues past the end of the buffer
+// without writing, so that Clay__EndFrameString() can tell whether the whole string fit.
+void Clay__FrameStringAppend(Clay__charArray *buffer, const char *chars, int32_t length) {
+    for (int32_t i = 0; i < length; ++i) {
+        if (buffer->length < buffer->capacity) {
+            buffer->internalArray[buffer->length] = chars[i];
+        }
+        buffer->length++;
+    }
+}
+
+void Clay__FrameStringAppendInteger(Clay__charArray *buffer, uint64_t value, bool negative, uint32_t base) {
+    char digits[24];
+    int32_t length = 0;
+    do {
+        digits[sizeof(digits) - 1 - length++] = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value > 0);
+    if (negative) {
+        digits[sizeof(digits) - 1 - length++] = '-';
+    }
+    Clay__FrameStringAppend(buffer, digits + sizeof(digits) - length, length);
+}
+
+// Writes value in the given base to out with at least minimumDigits digits (at most 24), and returns the number of characters written
+int32_t Clay__FormatDigits(char *out, uint64_t value, uint32_t base, bool uppercase, int32_t minimumDigits) {
+    const char *symbols = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    char digits[24];
+    int32_t length = 0;
+    minimumDigits = CLAY__MIN(minimumDigits, (int32_t)sizeof(digits));
+    while ((value > 0 || length < minimumDigits) && length < (int32_t)sizeof(digits)) {
+        digits[length++] = symbols[value % base];
+        value /= base;
+    }
+    for (int32_t i = 0; i < length; ++i) {
+        out[i] = digits[length - 1 - i];
+    }
+    return length;
+}
+
+// A double has at most 309 integer digits, and its fraction is exact after 1074 decimals, as 2^-1074 is the smallest step
+#define CLAY__FORMAT_FLOAT_CAPACITY 1400
+#define CLAY__FORMAT_FLOAT_MAX_DECIMALS 1074
+
+uint64_t Clay__DoubleBits(double value) {
+    uint64_t bits = 0;
+    for (int32_t i = 0; i < (int32_t)sizeof(bits); ++i) {
+        ((unsigned char *)&bits)[i] = ((const unsigned char *)&value)[i];
+    }
+    return bits;
+}
+
+// Writes the digits of mantissa * 2^shift to out, and returns how many were written. The mantissa is shifted into a 1088 bit
+// integer, which is then divided by 10^9 repeatedly.
+int32_t Clay__FormatShiftedInteger(char *out, uint64_t mantissa, int32_t shift) {
+    uint32_t limbs[34] = CLAY__DEFAULT_STRUCT;
+    int32_t limbShift = shift / 32, bitShift = shift % 32;
+    limbs[limbShift] = (uint32_t)(mantissa << bitShift);
+    limbs[limbShift + 1] = (uint32_t)(mantissa >> (32 - bitShift));
+    limbs[limbShift + 2] = bitShift > 0 ? (uint32_t)(mantissa >> (64 - bitShift)) : 0;
+    int32_t limbCount = limbShift + 3;
+    uint32_t chunks[40];
+    int32_t chunkCount = 0;
+    do {
+        uint64_t remainder = 0;
+        for (int32_t i = limbCount - 1; i >= 0; --i) {
+            uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = (uint32_t)(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        chunks[chunkCount++] = (uint32_t)remainder;
+        while (limbCount > 0 && limbs[limbCount - 1] == 0) {
+            limbCount--;
+        }
+    } while (limbCount > 0);
+    int32_t length = 0;
+    for (int32_t i = chunkCount - 1; i >= 0; --i) {
+        length += Clay__FormatDigits(out + length, chunks[i], 10, false, i == chunkCount - 1 ? 1 : 9);
+    }
+    return length;
+}
+
+// Writes the magnitude of a finite double, given by its bits, with the given number of decimals to out, which holds CLAY__FORMAT_FLOAT_CAPACITY
+// characters, and returns the length. The conversion is exact like printf's: the fraction is held as an integer over 2^fractionBits, and each
+// multiplication by 10^9 moves the next 9 digits above the binary point. It rounds to the nearest value, with ties to even. Decimals past
+// CLAY__FORMAT_FLOAT_MAX_DECIMALS are always zero, and are returned in trailingZeros instead of being written.
+int32_t Clay__FormatFloat(char *out, uint64_t bits, int32_t decimals, bool decimalPoint, int32_t *trailingZeros) {
+    int32_t exponentField = (int32_t)((bits >> 52) & 0x7ff);
+    uint64_t mantissa = bits & 0xfffffffffffffULL;
+    // Subnormal values have no implicit leading bit, and the same exponent as the smallest normal values
+    if (exponentField > 0) {
+        mantissa |= 0x10000000000000ULL;
+    } else {
+        exponentField = 1;
+    }
+    int32_t exponent = exponentField - 1075;
+    uint32_t limbs[36] = CLAY__DEFAULT_STRUCT;
+    int32_t fractionBits = 0;
+    int32_t length;
+    if (exponent >= 0) {
+        length = Clay__FormatShiftedInteger(out, mantissa, exponent);
+    } else {
+        fractionBits = -exponent;
+        uint64_t fraction = fractionBits < 64 ? mantissa & ((1ULL << fractionBits) - 1) : mantissa;
+        length = Clay__FormatDigits(out, fractionBits < 64 ? mantissa >> fractionBits : 0, 10, false, 1);
+        limbs[0] = (uint32_t)fraction;
+        limbs[1] = (uint32_t)(fraction >> 32);
+    }
+    int32_t exactDecimals = CLAY__MIN(decimals, fractionBits);
+    *trailingZeros = decimals - exactDecimals;
+    if (decimalPoint) {
+        out[length++] = '.';
+    }
+    int32_t topLimb = fractionBits / 32, topShift = fractionBits % 32;
+    for (int32_t written = 0; written < exactDecimals;) {
+        int32_t count = CLAY__MIN(exactDecimals - written, 9);
+        uint32_t multiplier = 1;
+        for (int32_t i = 0; i < count; ++i) {
+            multiplier *= 10;
+        }
+        uint64_t carry = 0;
+        for (int32_t i = 0; i <= topLimb + 1; ++i) {
+            uint64_t product = (uint64_t)limbs[i] * multiplier + carry;
+            limbs[i] = (uint32_t)product;
+            carry = product >> 32;
+        }
+        uint64_t digits = (((uint64_t)limbs[topLimb + 1] << 32) | limbs[topLimb]) >> topShift;
+        limbs[topLimb] &= ((uint32_t)1 << topShift) - 1;
+        limbs[topLimb + 1] = 0;
+        length += Clay__FormatDigits(out + length, digits, 10, false, count);
+        written += count;
+    }
+    // What is left of the fraction is compared with one half, which is the bit just below the binary point
+    if (fractionBits > 0) {
+        int32_t halfBit = fractionBits - 1;
+        bool half = (limbs[halfBit / 32] >> (halfBit % 32)) & 1;
+        bool belowHalf = (limbs[halfBit / 32] & (((uint32_t)1 << (halfBit % 32)) - 1)) != 0;
+        for (int32_t i = 0; i < halfBit / 32; ++i) {
+            belowHalf = belowHalf || limbs[i] != 0;
+        }
+        char lastDigit = out[length - 1] == '.' ? out[length - 2] : out[length - 1];
+        if (half && (belowHalf || ((lastDigit - '0') & 1))) {
+            int32_t i = length - 1;
+            for (; i >= 0 && (out[i] == '.' || out[i] == '9'); --i) {
+                out[i] = out[i] == '.' ? '.' : '0';
+            }
+            if (i >= 0) {
+                out[i]++;
+            } else {
+                for (i = length; i > 0; --i) {
+                    out[i] = out[i - 1];
+                }
+                out[0] = '1';
+                length++;
+            }
+        }
+    }
+    return length;
+}
+
+// Appends a converted value padded to width: the prefix (a sign or 0x), leadingZeros zeros, the body and trailingZeros zeros. The padding is
+// spaces before it, spaces after it when leftAlign is set, or zeros between the prefix and the value when zeroPad is set.
+void Clay__FrameStringAppendPadded(Clay__charArray *buffer, const char *prefix, int32_t leadingZeros, const char *body, int32_t bodyLength, int32_t trailingZeros, int32_t width, bool leftAlign, bool zeroPad) {
+    int32_t prefixLength = 0;
+    while (prefix[prefixLength]) {
+        prefixLength++;
+    }
+    // Anything wider than the buffer is going to be discarded anyway
+    leadingZeros = CLAY__MIN(leadingZeros, buffer->capacity + 1);
+    trailingZeros = CLAY__MIN(trailingZeros, buffer->capacity + 1);
+    int32_t padding = CLAY__MIN(width, buffer->capacity + 1) - prefixLength - leadingZeros - bodyLength - trailingZeros;
+    for (int32_t i = 0; !leftAlign && !zeroPad && i < padding; ++i) {
+        Clay__FrameStringAppend(buffer, " ", 1);
+    }
+    Clay__FrameStringAppend(buffer, prefix, prefixLength);
+    for (int32_t i = 0; !leftAlign && zeroPad && i < padding; ++i) {
+        Clay__FrameStringAppend(buffer, "0", 1);
+    }
+    for (int32_t i = 0; i < leadingZeros; ++i) {
+        Clay__FrameStringAppend(buffer, "0", 1);
+    }
+    Clay__FrameStringAppend(buffer, body, bodyLength);
+    for (int32_t i = 0; i < trailingZeros; ++i) {
+        Clay__FrameStringAppend(buffer, "0", 1);
+    }
+    for (int32_t i = 0; leftAlign && i < padding; ++i) {
+        Clay__FrameStringAppend(buffer, " ", 1);
+    }
+}
+
+// Reads the argument of a signed integer conversion with the given length modifier, where 'H' stands for hh and 'q' for ll
+int64_t Clay__FrameFormatSignedArgument(va_list *args, char length) {
+    switch (length) {
+        case 'H': return (signed char)va_arg(*args, int);
+        case 'h': return (short)va_arg(*args, int);
+        case 'l': return va_arg(*args, long);
+        case 'q': return va_arg(*args, long long);
+        case 'j': return va_arg(*args, intmax_t);
+        case 'z': case 't': return va_arg(*args, ptrdiff_t);
+        default: return va_arg(*args, int);
+    }
+}
+
+uint64_t Clay__FrameFormatUnsignedArgument(va_list *args, char length) {
+    switch (length) {
+        case 'H': return (unsigned char)va_arg(*args, unsigned int);
+        case 'h': return (unsigned short)va_arg(*args, unsigned int);
+        case 'l': return va_arg(*args, unsigned long);
+        case 'q': return va_arg(*args, unsigned long long);
+        case 'j': return va_arg(*args, uintmax_t);
+        case 'z': case 't': return va_arg(*args, size_t);
+        default: return va_arg(*args, unsigned int);
+    }
+}
+
+// Returns the string appended since start, or discards it and reports an error if it didn't fit
+Clay_String Clay__EndFrameString(Clay_Context* context, int32_t start) {
+    Clay__charArray *buffer = &context->dynamicStringData;
+    if (buffer->length > buffer->capacity) {
+        buffer->length = start;
+        if (!context->booleanWarnings.frameStringCapacityExceeded) {
+            context->booleanWarnings.frameStringCapacityExceeded = true;
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_FRAME_STRING_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay ran out of space for frame strings. Try using Clay_SetFrameStringCapacity() with a higher value."),
+                .userData = context->errorHandler.userData });
+        }
+        return CLAY__STRING_DEFAULT;
+    }
+    return CLAY__INIT(Clay_String) { .length = buffer->length - start, .chars = buffer->internalArray + start };
+}
+
+Clay_String Clay__IntToString(int32_t integer) {
+    if (integer == 0) {
+        return CLAY__INIT(Clay_String) { .length = 1, .chars = "0" };
+    }
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t start = context->dynamicStringData.length;
+    Clay__FrameStringAppendInteger(&context->dynamicStringData, integer < 0 ? (uint64_t)0 - (uint64_t)integer : (uint64_t)integer, integer < 0, 10);
+    return Clay__EndFrameString(context, start);
+}
+
+void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->renderCommands.length < context->renderCommands.capacity - 1) {
+        Clay_RenderCommandArray_Add(&context->renderCommands, renderCommand);
+    } else {
+        if (!context->booleanWarnings.maxRenderCommandsExceeded) {
+            context->booleanWarnings.maxRenderCommandsExceeded = true;
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay ran out of capacity while attempting to create render commands. This is usually caused by a large amount of wrapping text elements while close to the max element capacity. Try using Clay_SetMaxElementCount() with a higher value."),
+                .userData = context->errorHandler.userData });
+        }
+    }
+}
+
+bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->disableCulling) {
         return false;
@@ -2515,78 +4092,301 @@ bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
            (boundingBox->y + boundingBox->height < 0);
 }
 
-void Clay__CalculateFinalLayout(void) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    // Calculate sizing along the X axis
-    Clay__SizeContainersAlongAxis(true);
+// Clip containers nested deeper than this keep culling against the deepest clip rectangle that fit
+#define CLAY__CULL_CLIP_STACK_CAPACITY 64
 
-    // Wrap text
-    for (int32_t textElementIndex = 0; textElementIndex < context->textElementData.length; ++textElementIndex) {
-        Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex);
-        textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
-        Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)textElementData->elementIndex);
-        Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(containerElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
-        Clay__MeasureTextCacheItem *measureTextCacheItem = Clay__MeasureTextCached(&textElementData->text, textConfig);
-        float lineWidth = 0;
-        float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
-        int32_t lineLengthChars = 0;
-        int32_t lineStartOffset = 0;
-        if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
-            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
-            textElementData->wrappedLines.length++;
+// Returns true if the bounding box is entirely off screen, or entirely outside the active clip rectangle (if there is one)
+bool Clay__ElementIsCulled(Clay_BoundingBox *boundingBox, Clay_BoundingBox *clipBox) {
+    if (Clay__ElementIsOffscreen(boundingBox)) {
+        return true;
+    }
+    if (!clipBox || Clay_GetCurrentContext()->disableCulling) {
+        return false;
+    }
+    return (boundingBox->x >= clipBox->x + clipBox->width) ||
+           (boundingBox->y >= clipBox->y + clipBox->height) ||
+           (boundingBox->x + boundingBox->width <= clipBox->x) ||
+           (boundingBox->y + boundingBox->height <= clipBox->y);
+}
+
+Clay_BoundingBox Clay__IntersectBoundingBoxes(Clay_BoundingBox a, Clay_BoundingBox b) {
+    float left = CLAY__MAX(a.x, b.x);
+    float top = CLAY__MAX(a.y, b.y);
+    float right = CLAY__MIN(a.x + a.width, b.x + b.width);
+    float bottom = CLAY__MIN(a.y + a.height, b.y + b.height);
+    return CLAY__INIT(Clay_BoundingBox) { left, top, CLAY__MAX(right - left, 0), CLAY__MAX(bottom - top, 0) };
+}
+
+// Layers nested deeper than this are not wrapped in LAYER_BEGIN / LAYER_END commands
+#define CLAY__LAYER_STACK_CAPACITY 32
+
+uint32_t Clay__HashColor(uint32_t hash, Clay_Color color) {
+    hash = Clay__HashConfigFloat(hash, color.r);
+    hash = Clay__HashConfigFloat(hash, color.g);
+    hash = Clay__HashConfigFloat(hash, color.b);
+    return Clay__HashConfigFloat(hash, color.a);
+}
+
+uint32_t Clay__HashCornerRadius(uint32_t hash, Clay_CornerRadius cornerRadius) {
+    hash = Clay__HashConfigFloat(hash, cornerRadius.topLeft);
+    hash = Clay__HashConfigFloat(hash, cornerRadius.topRight);
+    hash = Clay__HashConfigFloat(hash, cornerRadius.bottomLeft);
+    return Clay__HashConfigFloat(hash, cornerRadius.bottomRight);
+}
+
+// Hashes everything about a render command that affects how it looks, with its position relative to origin. Ids are left out as they don't change the output.
+uint32_t Clay__HashRenderCommand(uint32_t hash, Clay_RenderCommand *renderCommand, Clay_Vector2 origin) {
+    hash = Clay__HashConfigValue(hash, renderCommand->commandType);
+    hash = Clay__HashConfigValue(hash, (uint32_t)(uintptr_t)renderCommand->userData);
+    // SCISSOR_END commands don't have a bounding box, so their position is meaningless
+    if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_SCISSOR_END && renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_NONE) {
+        hash = Clay__HashConfigFloat(hash, renderCommand->boundingBox.x - origin.x);
+        hash = Clay__HashConfigFloat(hash, renderCommand->boundingBox.y - origin.y);
+        hash = Clay__HashConfigFloat(hash, renderCommand->boundingBox.width);
+        hash = Clay__HashConfigFloat(hash, renderCommand->boundingBox.height);
+    }
+    Clay_RenderData *renderData = &renderCommand->renderData;
+    switch (renderCommand->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            hash = Clay__HashColor(hash, renderData->rectangle.backgroundColor);
+            return Clay__HashCornerRadius(hash, renderData->rectangle.cornerRadius);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            hash = Clay__HashColor(hash, renderData->border.color);
+            hash = Clay__HashCornerRadius(hash, renderData->border.cornerRadius);
+            hash = Clay__HashConfigValue(hash, (uint32_t)renderData->border.width.left | ((uint32_t)renderData->border.width.right << 16));
+            hash = Clay__HashConfigValue(hash, (uint32_t)renderData->border.width.top | ((uint32_t)renderData->border.width.bottom << 16));
+            return Clay__HashConfigValue(hash, renderData->border.width.betweenChildren);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextRenderData *text = &renderData->text;
+            hash = Clay__HashColor(hash, text->textColor);
+            hash = Clay__HashConfigValue(hash, (uint32_t)text->fontId | ((uint32_t)text->fontSize << 16));
+            hash = Clay__HashConfigValue(hash, (uint32_t)text->letterSpacing | ((uint32_t)text->lineHeight << 16));
+            hash = Clay__HashConfigValue(hash, (uint32_t)text->stringContents.length);
+            uint64_t textHash = Clay__HashData((const uint8_t *)text->stringContents.chars, (size_t)text->stringContents.length);
+            hash = Clay__HashConfigValue(hash, (uint32_t)textHash);
+            return Clay__HashConfigValue(hash, (uint32_t)(textHash >> 32));
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            hash = Clay__HashColor(hash, renderData->image.backgroundColor);
+            hash = Clay__HashCornerRadius(hash, renderData->image.cornerRadius);
+            return Clay__HashConfigValue(hash, (uint32_t)(uintptr_t)renderData->image.imageData);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            hash = Clay__HashColor(hash, renderData->custom.backgroundColor);
+            hash = Clay__HashCornerRadius(hash, renderData->custom.cornerRadius);
+            return Clay__HashConfigValue(hash, (uint32_t)(uintptr_t)renderData->custom.customData);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            return Clay__HashConfigValue(hash, (uint32_t)renderData->clip.horizontal | ((uint32_t)renderData->clip.vertical << 1));
+        }
+        case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+        case CLAY_RENDER_COMMAND_TYPE_LAYER_END: {
+            return Clay__HashConfigValue(hash, renderData->layer.contentHash);
+        }
+        default: return hash;
+    }
+}
+
+// Grows the LAYER_BEGIN command at layerStartIndex to fit all of the commands inside the layer, fills in its content hash, and adds the matching LAYER_END
+void Clay__CloseLayer(int32_t layerStartIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_RenderCommand *layerBegin = Clay_RenderCommandArray_Get(&context->renderCommands, layerStartIndex);
+    Clay_BoundingBox bounds = layerBegin->boundingBox;
+    float right = bounds.x + bounds.width;
+    float bottom = bounds.y + bounds.height;
+    // Children can overflow the layer element, the layer needs to be large enough that caching it never cuts them off
+    for (int32_t i = layerStartIndex + 1; i < context->renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &context->renderCommands.internalArray[i];
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END || renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_NONE) {
             continue;
         }
-        float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, textConfig, context->measureTextUserData).width;
-        int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
-        while (wordIndex != -1) {
-            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
-                break;
+        Clay_BoundingBox box = renderCommand->boundingBox;
+        bounds.x = CLAY__MIN(bounds.x, box.x);
+        bounds.y = CLAY__MIN(bounds.y, box.y);
+        right = CLAY__MAX(right, box.x + box.width);
+        bottom = CLAY__MAX(bottom, box.y + box.height);
+    }
+    bounds.width = right - bounds.x;
+    bounds.height = bottom - bounds.y;
+    Clay_Vector2 origin = { bounds.x, bounds.y };
+    uint32_t contentHash = 0;
+    for (int32_t i = layerStartIndex + 1; i < context->renderCommands.length; ++i) {
+        contentHash = Clay__HashRenderCommand(contentHash, &context->renderCommands.internalArray[i], origin);
+    }
+    layerBegin->boundingBox = bounds;
+    layerBegin->renderData.layer.contentHash = contentHash;
+    Clay_RenderCommand layerEnd = *layerBegin;
+    layerEnd.commandType = CLAY_RENDER_COMMAND_TYPE_LAYER_END;
+    Clay__AddRenderCommand(layerEnd);
+}
+
+void Clay__SortTreeRootsByZIndex(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
+    while (sortMax > 0) { // todo dumb bubble sort
+        for (int32_t i = 0; i < sortMax; ++i) {
+            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
+            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
+            if (next.zIndex < current.zIndex) {
+                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
+                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
             }
-            Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
-            // Only word on the line is too large, just render it anyway
-            if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
-                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
-                textElementData->wrappedLines.length++;
-                wordIndex = measuredWord->next;
-                lineStartOffset = measuredWord->startOffset + measuredWord->length;
+        }
+        sortMax--;
+    }
+}
+
+void Clay__AddWrappedTextLine(Clay__WrappedTextLineArray *wrappedTextLines, Clay__TextElementData *textElementData, Clay__WrappedTextLine line) {
+    if (wrappedTextLines) {
+        // The final line of an element that was cut off by Clay__WrapTextElement() is dropped, so that the element's lines stay within the array
+        if (wrappedTextLines->length >= wrappedTextLines->capacity) {
+            return;
+        }
+        Clay__WrappedTextLineArray_Add(wrappedTextLines, line);
+    }
+    textElementData->wrappedLines.length++;
+}
+
+// Wraps a text element to the width of its container, appending the lines to wrappedTextLines. If wrappedTextLines is NULL, the lines
+// are only counted in textElementData->wrappedLines.length. Nothing else is written, so separate elements can be wrapped by parallel jobs.
+void Clay__WrapTextElement(Clay_Context *context, Clay__TextElementData *textElementData, Clay__WrappedTextLineArray *wrappedTextLines) {
+    textElementData->wrappedLines.length = 0;
+    if (wrappedTextLines) {
+        textElementData->wrappedLines.internalArray = &wrappedTextLines->internalArray[wrappedTextLines->length];
+    }
+    Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)textElementData->elementIndex);
+    Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(containerElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
+    Clay__MeasureTextCacheItem *measureTextCacheItem = textElementData->measureTextCacheItem;
+    float lineWidth = 0;
+    float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
+    int32_t lineLengthChars = 0;
+    int32_t lineStartOffset = 0;
+    if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
+        Clay__AddWrappedTextLine(wrappedTextLines, textElementData, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
+        return;
+    }
+    float spaceWidth = context->measureTextFunction(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, textConfig, context->measureTextUserData).width;
+    int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
+    while (wordIndex != -1) {
+        if (wrappedTextLines && wrappedTextLines->length > wrappedTextLines->capacity - 1) {
+            if (!context->booleanWarnings.maxWrappedTextLinesExceeded) {
+                context->booleanWarnings.maxWrappedTextLinesExceeded = true;
+                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                    .errorType = CLAY_ERROR_TYPE_WRAPPED_TEXT_LINE_CAPACITY_EXCEEDED,
+                    .errorText = CLAY_STRING("Clay ran out of capacity while wrapping text, and the remaining lines were cut off. Try using Clay_SetMaxWrappedTextLineCount() with a higher value."),
+                    .userData = context->errorHandler.userData });
             }
-            // measuredWord->length == 0 means a newline character
-            else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerElement->dimensions.width) {
-                // Wrapped text lines list has overflowed, just render out the line
-                bool finalCharIsSpace = textElementData->text.chars[CLAY__MAX(lineStartOffset + lineLengthChars - 1, 0)] == ' ';
-                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth + (finalCharIsSpace ? -spaceWidth : 0), lineHeight }, { .length = lineLengthChars + (finalCharIsSpace ? -1 : 0), .chars = &textElementData->text.chars[lineStartOffset] } });
-                textElementData->wrappedLines.length++;
-                if (lineLengthChars == 0 || measuredWord->length == 0) {
-                    wordIndex = measuredWord->next;
-                }
-                lineWidth = 0;
-                lineLengthChars = 0;
-                lineStartOffset = measuredWord->startOffset;
-            } else {
-                lineWidth += measuredWord->width + textConfig->letterSpacing;
-                lineLengthChars += measuredWord->length;
+            break;
+        }
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+        // Only word on the line is too large, just render it anyway
+        if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
+            Clay__AddWrappedTextLine(wrappedTextLines, textElementData, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
+            wordIndex = measuredWord->next;
+            lineStartOffset = measuredWord->startOffset + measuredWord->length;
+        }
+        // measuredWord->length == 0 means a newline character
+        else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerElement->dimensions.width) {
+            // Wrapped text lines list has overflowed, just render out the line
+            bool finalCharIsSpace = textElementData->text.chars[CLAY__MAX(lineStartOffset + lineLengthChars - 1, 0)] == ' ';
+            Clay__AddWrappedTextLine(wrappedTextLines, textElementData, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth + (finalCharIsSpace ? -spaceWidth : 0), lineHeight }, { .length = lineLengthChars + (finalCharIsSpace ? -1 : 0), .chars = &textElementData->text.chars[lineStartOffset] } });
+            if (lineLengthChars == 0 || measuredWord->length == 0) {
                 wordIndex = measuredWord->next;
             }
+            lineWidth = 0;
+            lineLengthChars = 0;
+            lineStartOffset = measuredWord->startOffset;
+        } else {
+            lineWidth += measuredWord->width + textConfig->letterSpacing;
+            lineLengthChars += measuredWord->length;
+            wordIndex = measuredWord->next;
         }
-        if (lineLengthChars > 0) {
-            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth - textConfig->letterSpacing, lineHeight }, {.length = lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
-            textElementData->wrappedLines.length++;
-        }
+    }
+    if (lineLengthChars > 0) {
+        Clay__AddWrappedTextLine(wrappedTextLines, textElementData, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth - textConfig->letterSpacing, lineHeight }, {.length = lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
+    }
+    if (wrappedTextLines) {
         containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
     }
+}
+
+typedef struct {
+    Clay_Context *context;
+    int32_t jobElementCount;
+    bool countOnly;
+} Clay__WrapTextJobs;
+
+void Clay__WrapTextJob(int32_t jobIndex, void *jobData) {
+    Clay__WrapTextJobs *jobs = (Clay__WrapTextJobs *)jobData;
+    Clay_Context *context = jobs->context;
+    int32_t end = CLAY__MIN((jobIndex + 1) * jobs->jobElementCount, context->textElementData.length);
+    for (int32_t textElementIndex = jobIndex * jobs->jobElementCount; textElementIndex < end; ++textElementIndex) {
+        Clay__TextElementData *textElementData = &context->textElementData.internalArray[textElementIndex];
+        if (jobs->countOnly) {
+            Clay__WrapTextElement(context, textElementData, NULL);
+        } else {
+            Clay__WrappedTextLineArray lines = { .capacity = textElementData->wrappedLines.length, .length = 0, .internalArray = textElementData->wrappedLines.internalArray };
+            Clay__WrapTextElement(context, textElementData, &lines);
+        }
+    }
+}
+
+// Wraps text in two parallel passes. The first counts each element's lines, which are then reserved in declaration order so that
+// the second pass can write them to the same place in wrappedTextLines as wrapping on a single thread would.
+void Clay__WrapTextInParallel(Clay_Context *context, int32_t jobElementCount) {
+    Clay__WrapTextJobs jobs = { .context = context, .jobElementCount = jobElementCount, .countOnly = true };
+    int32_t jobCount = (context->textElementData.length + jobElementCount - 1) / jobElementCount;
+    context->parallelExecutor.parallelForFunction(jobCount, Clay__WrapTextJob, &jobs, context->parallelExecutor.userData);
+    int32_t lineCount = context->wrappedTextLines.length;
+    for (int32_t textElementIndex = 0; textElementIndex < context->textElementData.length; ++textElementIndex) {
+        Clay__TextElementData *textElementData = &context->textElementData.internalArray[textElementIndex];
+        textElementData->wrappedLines.internalArray = &context->wrappedTextLines.internalArray[lineCount];
+        lineCount += textElementData->wrappedLines.length;
+    }
+    // Fall back to a single thread if the lines don't fit, so they are cut off in the same place
+    if (lineCount > context->wrappedTextLines.capacity) {
+        for (int32_t textElementIndex = 0; textElementIndex < context->textElementData.length; ++textElementIndex) {
+            Clay__WrapTextElement(context, &context->textElementData.internalArray[textElementIndex], &context->wrappedTextLines);
+        }
+        return;
+    }
+    context->wrappedTextLines.length = lineCount;
+    jobs.countOnly = false;
+    context->parallelExecutor.parallelForFunction(jobCount, Clay__WrapTextJob, &jobs, context->parallelExecutor.userData);
+}
+
+// Sizes the trees from firstRootIndex onwards, wrapping the text elements and scaling the aspect ratio elements they contain.
+// The text and aspect ratio elements of those trees start at firstTextElementIndex and firstAspectRatioElementIndex.
+void Clay__SizeLayout(Clay_Context* context, int32_t firstRootIndex, int32_t firstTextElementIndex, int32_t firstAspectRatioElementIndex) {
+    int32_t minimumJobElementCount = context->parallelExecutor.minimumJobElementCount > 0 ? context->parallelExecutor.minimumJobElementCount : CLAY__PARALLEL_DEFAULT_JOB_ELEMENT_COUNT;
+    // Calculate sizing along the X axis
+    Clay__SizeContainersAlongAxis(true, firstRootIndex);
+
+    // Wrap text
+    if (context->parallelExecutor.parallelForFunction && !context->measuring && context->textElementData.length >= minimumJobElementCount * 2) {
+        Clay__WrapTextInParallel(context, CLAY__MAX(minimumJobElementCount, (context->textElementData.length + CLAY__PARALLEL_MAX_JOBS - 1) / CLAY__PARALLEL_MAX_JOBS));
+    } else {
+        for (int32_t textElementIndex = firstTextElementIndex; textElementIndex < context->textElementData.length; ++textElementIndex) {
+            Clay__WrapTextElement(context, Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex), &context->wrappedTextLines);
+        }
+    }
 
     // Scale vertical heights according to aspect ratio
-    for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
+    for (int32_t i = firstAspectRatioElementIndex; i < context->aspectRatioElementIndexes.length; ++i) {
         Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i));
         Clay_AspectRatioElementConfig *config = Clay__FindElementConfigWithType(aspectElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT).aspectRatioElementConfig;
         aspectElement->dimensions.height = (1 / config->aspectRatio) * aspectElement->dimensions.width;
         aspectElement->layoutConfig->sizing.height.size.minMax.max = aspectElement->dimensions.height;
+        context->layoutElementSizing.internalArray[Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i)].sizing[1].size.minMax.max = aspectElement->dimensions.height;
     }
 
     // Propagate effect of text wrapping, aspect scaling etc. on height of parents
     Clay__LayoutElementTreeNodeArray dfsBuffer = context->layoutElementTreeNodeArray1;
     dfsBuffer.length = 0;
-    for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
+    for (int32_t i = firstRootIndex; i < context->layoutElementTreeRoots.length; ++i) {
         Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
         context->treeNodeVisited.internalArray[dfsBuffer.length] = false;
         Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex) });
@@ -2632,505 +4432,942 @@ void Clay__CalculateFinalLayout(void) {
     }
 
     // Calculate sizing along the Y axis
-    Clay__SizeContainersAlongAxis(false);
+    Clay__SizeContainersAlongAxis(false, firstRootIndex);
 
     // Scale horizontal widths according to aspect ratio
-    for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
+    for (int32_t i = firstAspectRatioElementIndex; i < context->aspectRatioElementIndexes.length; ++i) {
         Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i));
         Clay_AspectRatioElementConfig *config = Clay__FindElementConfigWithType(aspectElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT).aspectRatioElementConfig;
         aspectElement->dimensions.width = config->aspectRatio * aspectElement->dimensions.height;
     }
+}
 
-    // Sort tree roots by z-index
-    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
-    while (sortMax > 0) { // todo dumb bubble sort
-        for (int32_t i = 0; i < sortMax; ++i) {
-            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
-            if (next.zIndex < current.zIndex) {
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
+// Positions the elements of one tree and appends its render commands
+void Clay__PositionTree(Clay_Context* context, Clay__LayoutElementTreeRoot *root) {
+    Clay__LayoutElementTreeNodeArray dfsBuffer = context->layoutElementTreeNodeArray1;
+    dfsBuffer.length = 0;
+    // The effective scissor at each level of the DFS, i.e. the intersection of every enclosing clip rectangle
+    Clay_BoundingBox cullClipStack[CLAY__CULL_CLIP_STACK_CAPACITY];
+    int32_t cullClipDepth = 0;
+    // The index of the LAYER_BEGIN command for each open layer, or -1 if the layer was culled
+    int32_t layerStartIndexes[CLAY__LAYER_STACK_CAPACITY];
+    int32_t layerDepth = 0;
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
+    Clay_Vector2 rootPosition = CLAY__DEFAULT_STRUCT;
+    Clay_LayoutElementHashMapItem *parentHashMapItem = Clay__GetHashMapItem(root->parentId);
+    // Position root floating containers
+    if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING) && parentHashMapItem) {
+        Clay_FloatingElementConfig *config = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
+        Clay_Dimensions rootDimensions = rootElement->dimensions;
+        Clay_BoundingBox parentBoundingBox = parentHashMapItem->boundingBox;
+        // Set X position
+        Clay_Vector2 targetAttachPosition = CLAY__DEFAULT_STRUCT;
+        switch (config->attachPoints.parent) {
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x; break;
+            case CLAY_ATTACH_POINT_CENTER_TOP:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + (parentBoundingBox.width / 2); break;
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + parentBoundingBox.width; break;
+        }
+        switch (config->attachPoints.element) {
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM: break;
+            case CLAY_ATTACH_POINT_CENTER_TOP:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x -= (rootDimensions.width / 2); break;
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x -= rootDimensions.width; break;
+        }
+        switch (config->attachPoints.parent) { // I know I could merge the x and y switch statements, but this is easier to read
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_CENTER_TOP: targetAttachPosition.y = parentBoundingBox.y; break;
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y = parentBoundingBox.y + (parentBoundingBox.height / 2); break;
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y = parentBoundingBox.y + parentBoundingBox.height; break;
+        }
+        switch (config->attachPoints.element) {
+            case CLAY_ATTACH_POINT_LEFT_TOP:
+            case CLAY_ATTACH_POINT_RIGHT_TOP:
+            case CLAY_ATTACH_POINT_CENTER_TOP: break;
+            case CLAY_ATTACH_POINT_LEFT_CENTER:
+            case CLAY_ATTACH_POINT_CENTER_CENTER:
+            case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y -= (rootDimensions.height / 2); break;
+            case CLAY_ATTACH_POINT_LEFT_BOTTOM:
+            case CLAY_ATTACH_POINT_CENTER_BOTTOM:
+            case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y -= rootDimensions.height; break;
+        }
+        targetAttachPosition.x += config->offset.x;
+        targetAttachPosition.y += config->offset.y;
+        rootPosition = targetAttachPosition;
+    }
+    if (root->clipElementId) {
+        Clay_LayoutElementHashMapItem *clipHashMapItem = Clay__GetHashMapItem(root->clipElementId);
+        if (clipHashMapItem) {
+            // Floating elements that are attached to scrolling contents won't be correctly positioned if external scroll handling is enabled, fix here
+            if (context->externalScrollHandlingEnabled) {
+                Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(clipHashMapItem->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+                if (clipConfig->horizontal) {
+                    rootPosition.x += clipConfig->childOffset.x;
+                }
+                if (clipConfig->vertical) {
+                    rootPosition.y += clipConfig->childOffset.y;
+                }
             }
+            Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
+                .boundingBox = clipHashMapItem->boundingBox,
+                .userData = 0,
+                .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 10).id, // TODO need a better strategy for managing derived ids
+                .zIndex = root->zIndex,
+                .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START,
+            });
+            cullClipStack[cullClipDepth++] = clipHashMapItem->boundingBox;
         }
-        sortMax--;
     }
+    Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = { .x = (float)rootElement->layoutConfig->padding.left, .y = (float)rootElement->layoutConfig->padding.top } });
 
-    // Calculate final positions and generate render commands
-    context->renderCommands.length = 0;
-    dfsBuffer.length = 0;
-    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
-        dfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
-        Clay_Vector2 rootPosition = CLAY__DEFAULT_STRUCT;
-        Clay_LayoutElementHashMapItem *parentHashMapItem = Clay__GetHashMapItem(root->parentId);
-        // Position root floating containers
-        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING) && parentHashMapItem) {
-            Clay_FloatingElementConfig *config = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
-            Clay_Dimensions rootDimensions = rootElement->dimensions;
-            Clay_BoundingBox parentBoundingBox = parentHashMapItem->boundingBox;
-            // Set X position
-            Clay_Vector2 targetAttachPosition = CLAY__DEFAULT_STRUCT;
-            switch (config->attachPoints.parent) {
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x; break;
-                case CLAY_ATTACH_POINT_CENTER_TOP:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + (parentBoundingBox.width / 2); break;
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x = parentBoundingBox.x + parentBoundingBox.width; break;
+    context->treeNodeVisited.internalArray[0] = false;
+    while (dfsBuffer.length > 0) {
+        Clay__LayoutElementTreeNode *currentElementTreeNode = Clay__LayoutElementTreeNodeArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
+        Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
+        Clay_LayoutConfig *layoutConfig = currentElement->layoutConfig;
+        Clay_Vector2 scrollOffset = CLAY__DEFAULT_STRUCT;
+        Clay_BoundingBox *cullClipBox = cullClipDepth > 0 ? &cullClipStack[CLAY__MIN(cullClipDepth, CLAY__CULL_CLIP_STACK_CAPACITY) - 1] : CLAY__NULL;
+
+        // This will only be run a single time for each element in downwards DFS order
+        if (!context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
+            context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
+
+            Clay_BoundingBox currentElementBoundingBox = { currentElementTreeNode->position.x, currentElementTreeNode->position.y, currentElement->dimensions.width, currentElement->dimensions.height };
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+                Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
+                Clay_Dimensions expand = floatingElementConfig->expand;
+                currentElementBoundingBox.x -= expand.width;
+                currentElementBoundingBox.width += expand.width * 2;
+                currentElementBoundingBox.y -= expand.height;
+                currentElementBoundingBox.height += expand.height * 2;
+            }
+            currentElementBoundingBox = Clay__SnapBoundingBox(currentElementBoundingBox, context->pixelSnapGridSize);
+
+            Clay__ScrollContainerDataInternal *scrollContainerData = CLAY__NULL;
+            // Apply scroll offsets to container
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
+                Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+
+                // This linear scan could theoretically be slow under very strange conditions, but I can't imagine a real UI with more than a few 10's of scroll containers
+                for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
+                    Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+                    if (mapping->layoutElement == currentElement) {
+                        scrollContainerData = mapping;
+                        mapping->boundingBox = currentElementBoundingBox;
+                        mapping->elementDimensions = currentElement->dimensions;
+                        scrollOffset = clipConfig->childOffset;
+                        if (context->externalScrollHandlingEnabled) {
+                            scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(currentElement->id);
+            if (hashMapItem) {
+                hashMapItem->boundingBox = currentElementBoundingBox;
+                if (hashMapItem->idAlias) {
+                    Clay_LayoutElementHashMapItem *hashMapItemAlias = Clay__GetHashMapItem(hashMapItem->idAlias);
+                    if (hashMapItemAlias) {
+                        hashMapItemAlias->boundingBox = currentElementBoundingBox;
+                    }
+                }
+            }
+
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_LAYER)) {
+                int32_t layerStartIndex = -1;
+                if (layerDepth < CLAY__LAYER_STACK_CAPACITY && !Clay__ElementIsCulled(&currentElementBoundingBox, cullClipBox)) {
+                    Clay_SharedElementConfig *sharedConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig;
+                    int32_t renderCommandCount = context->renderCommands.length;
+                    Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
+                        .boundingBox = currentElementBoundingBox,
+                        .userData = sharedConfig ? sharedConfig->userData : 0,
+                        .id = currentElement->id,
+                        .zIndex = root->zIndex,
+                        .commandType = CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN,
+                    });
+                    // Adding the command fails if the render command array is full
+                    if (context->renderCommands.length > renderCommandCount) {
+                        layerStartIndex = renderCommandCount;
+                    }
+                }
+                if (layerDepth < CLAY__LAYER_STACK_CAPACITY) {
+                    layerStartIndexes[layerDepth] = layerStartIndex;
+                }
+                layerDepth++;
+            }
+
+            int32_t sortedConfigIndexes[20];
+            for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
+                sortedConfigIndexes[elementConfigIndex] = elementConfigIndex;
             }
-            switch (config->attachPoints.element) {
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM: break;
-                case CLAY_ATTACH_POINT_CENTER_TOP:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM: targetAttachPosition.x -= (rootDimensions.width / 2); break;
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.x -= rootDimensions.width; break;
+            int32_t sortMax = currentElement->elementConfigs.length - 1;
+            while (sortMax > 0) { // todo dumb bubble sort
+                for (int32_t i = 0; i < sortMax; ++i) {
+                    int32_t current = sortedConfigIndexes[i];
+                    int32_t next = sortedConfigIndexes[i + 1];
+                    Clay__ElementConfigType currentType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, current)->type;
+                    Clay__ElementConfigType nextType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, next)->type;
+                    if (nextType == CLAY__ELEMENT_CONFIG_TYPE_CLIP || currentType == CLAY__ELEMENT_CONFIG_TYPE_BORDER) {
+                        sortedConfigIndexes[i] = next;
+                        sortedConfigIndexes[i + 1] = current;
+                    }
+                }
+                sortMax--;
             }
-            switch (config->attachPoints.parent) { // I know I could merge the x and y switch statements, but this is easier to read
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_CENTER_TOP: targetAttachPosition.y = parentBoundingBox.y; break;
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y = parentBoundingBox.y + (parentBoundingBox.height / 2); break;
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y = parentBoundingBox.y + parentBoundingBox.height; break;
+
+            bool emitRectangle = false;
+            // Create the render commands for this element
+            Clay_SharedElementConfig *sharedConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig;
+            if (sharedConfig && sharedConfig->backgroundColor.a > 0) {
+               emitRectangle = true;
             }
-            switch (config->attachPoints.element) {
-                case CLAY_ATTACH_POINT_LEFT_TOP:
-                case CLAY_ATTACH_POINT_RIGHT_TOP:
-                case CLAY_ATTACH_POINT_CENTER_TOP: break;
-                case CLAY_ATTACH_POINT_LEFT_CENTER:
-                case CLAY_ATTACH_POINT_CENTER_CENTER:
-                case CLAY_ATTACH_POINT_RIGHT_CENTER: targetAttachPosition.y -= (rootDimensions.height / 2); break;
-                case CLAY_ATTACH_POINT_LEFT_BOTTOM:
-                case CLAY_ATTACH_POINT_CENTER_BOTTOM:
-                case CLAY_ATTACH_POINT_RIGHT_BOTTOM: targetAttachPosition.y -= rootDimensions.height; break;
+            else if (!sharedConfig) {
+                emitRectangle = false;
+                sharedConfig = &Clay_SharedElementConfig_DEFAULT;
             }
-            targetAttachPosition.x += config->offset.x;
-            targetAttachPosition.y += config->offset.y;
-            rootPosition = targetAttachPosition;
-        }
-        if (root->clipElementId) {
-            Clay_LayoutElementHashMapItem *clipHashMapItem = Clay__GetHashMapItem(root->clipElementId);
-            if (clipHashMapItem) {
-                // Floating elements that are attached to scrolling contents won't be correctly positioned if external scroll handling is enabled, fix here
-                if (context->externalScrollHandlingEnabled) {
-                    Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(clipHashMapItem->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                    if (clipConfig->horizontal) {
-                        rootPosition.x += clipConfig->childOffset.x;
+            for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
+                Clay_ElementConfig *elementConfig = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, sortedConfigIndexes[elementConfigIndex]);
+                Clay_RenderCommand renderCommand = {
+                    .boundingBox = currentElementBoundingBox,
+                    .userData = sharedConfig->userData,
+                    .id = currentElement->id,
+                };
+
+                bool offscreen = Clay__ElementIsCulled(&currentElementBoundingBox, cullClipBox);
+                // Culling - Don't bother to generate render commands for rectangles entirely outside the screen or the enclosing clip rectangles - this won't stop their children from being rendered if they overflow
+                bool shouldRender = !offscreen;
+                switch (elementConfig->type) {
+                    case CLAY__ELEMENT_CONFIG_TYPE_ASPECT:
+                    case CLAY__ELEMENT_CONFIG_TYPE_FLOATING:
+                    case CLAY__ELEMENT_CONFIG_TYPE_SHARED:
+                    case CLAY__ELEMENT_CONFIG_TYPE_BORDER:
+                    case CLAY__ELEMENT_CONFIG_TYPE_LAYER: {
+                        shouldRender = false;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_CLIP: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START;
+                        renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
+                            .clip = {
+                                .horizontal = elementConfig->config.clipElementConfig->horizontal,
+                                .vertical = elementConfig->config.clipElementConfig->vertical,
+                            }
+                        };
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_IMAGE;
+                        renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
+                            .image = {
+                                .backgroundColor = sharedConfig->backgroundColor,
+                                .cornerRadius = sharedConfig->cornerRadius,
+                                .imageData = elementConfig->config.imageElementConfig->imageData,
+                           }
+                        };
+                        emitRectangle = false;
+                        break;
+                    }
+                    case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
+                        if (!shouldRender) {
+                            break;
+                        }
+                        shouldRender = false;
+                        Clay_ElementConfigUnion configUnion = elementConfig->config;
+                        Clay_TextElementConfig *textElementConfig = configUnion.textElementConfig;
+                        float naturalLineHeight = currentElement->childrenOrTextContent.textElementData->preferredDimensions.height;
+                        float finalLineHeight = textElementConfig->lineHeight > 0 ? (float)textElementConfig->lineHeight : naturalLineHeight;
+                        float lineHeightOffset = (finalLineHeight - naturalLineHeight) / 2;
+                        float yPosition = lineHeightOffset;
+                        int32_t firstLineIndex = 0;
+                        // Every line advances by the same height, so lines above the visible region are skipped without visiting them.
+                        // One line is kept in hand so that rounding never skips a line that is partly visible.
+                        if (!context->disableCulling && finalLineHeight > 0 && currentElement->childrenOrTextContent.textElementData->wrappedLines.length > 1) {
+                            float visibleTop = cullClipBox ? CLAY__MAX(cullClipBox->y, 0) : 0;
+                            float hiddenLines = (visibleTop - (currentElementBoundingBox.y + lineHeightOffset)) / finalLineHeight - 1;
+                            if (hiddenLines >= 1) {
+                                firstLineIndex = (int32_t)CLAY__MIN(hiddenLines, (float)currentElement->childrenOrTextContent.textElementData->wrappedLines.length);
+                                yPosition += (float)firstLineIndex * finalLineHeight;
+                            }
+                        }
+                        for (int32_t lineIndex = firstLineIndex; lineIndex < currentElement->childrenOrTextContent.textElementData->wrappedLines.length; ++lineIndex) {
+                            Clay__WrappedTextLine *wrappedLine = Clay__WrappedTextLineArraySlice_Get(&currentElement->childrenOrTextContent.textElementData->wrappedLines, lineIndex);
+                            if (wrappedLine->line.length == 0) {
+                                yPosition += finalLineHeight;
+                                continue;
+                            }
+                            float offset = (currentElementBoundingBox.width - wrappedLine->dimensions.width);
+                            if (textElementConfig->textAlignment == CLAY_TEXT_ALIGN_LEFT) {
+                                offset = 0;
+                            }
+                            if (textElementConfig->textAlignment == CLAY_TEXT_ALIGN_CENTER) {
+                                offset /= 2;
+                            }
+                            Clay_BoundingBox lineBoundingBox = Clay__SnapBoundingBox(CLAY__INIT(Clay_BoundingBox) { currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height }, context->pixelSnapGridSize);
+                            if (Clay__ElementIsCulled(&lineBoundingBox, cullClipBox)) {
+                                yPosition += finalLineHeight;
+                                // Lines only move downwards, so once one is below the clip rectangle the rest are too
+                                if (cullClipBox && lineBoundingBox.y >= cullClipBox->y + cullClipBox->height) {
+                                    break;
+                                }
+                                continue;
+                            }
+                            Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
+                                .boundingBox = lineBoundingBox,
+                                .renderData = { .text = {
+                                    .stringContents = CLAY__INIT(Clay_StringSlice) { .length = wrappedLine->line.length, .chars = wrappedLine->line.chars, .baseChars = currentElement->childrenOrTextContent.textElementData->text.chars },
+                                    .textColor = textElementConfig->textColor,
+                                    .fontId = textElementConfig->fontId,
+                                    .fontSize = textElementConfig->fontSize,
+                                    .letterSpacing = textElementConfig->letterSpacing,
+                                    .lineHeight = textElementConfig->lineHeight,
+                                }},
+                                .userData = textElementConfig->userData,
+                                .id = Clay__HashNumber(lineIndex, currentElement->id).id,
+                                .zIndex = root->zIndex,
+                                .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT,
+                            });
+                            yPosition += finalLineHeight;
+
+                            if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > context->layoutDimensions.height)) {
+                                break;
+                            }
+                        }
+                        break;
                     }
-                    if (clipConfig->vertical) {
-                        rootPosition.y += clipConfig->childOffset.y;
+                    case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: {
+                        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_CUSTOM;
+                        renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
+                            .custom = {
+                                .backgroundColor = sharedConfig->backgroundColor,
+                                .cornerRadius = sharedConfig->cornerRadius,
+                                .customData = elementConfig->config.customElementConfig->customData,
+                            }
+                        };
+                        emitRectangle = false;
+                        break;
                     }
+                    default: break;
+                }
+                if (shouldRender) {
+                    Clay__AddRenderCommand(renderCommand);
+                }
+                if (offscreen) {
+                    // NOTE: You may be tempted to try an early return / continue if an element is off screen. Why bother calculating layout for its children, right?
+                    // Unfortunately, a FLOATING_CONTAINER may be defined that attaches to a child or grandchild of this element, which is large enough to still
+                    // be on screen, even if this element isn't. That depends on this element and it's children being laid out correctly (even if they are entirely off screen)
                 }
+            }
+
+            if (emitRectangle && !Clay__ElementIsCulled(&currentElementBoundingBox, cullClipBox)) {
                 Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                    .boundingBox = clipHashMapItem->boundingBox,
-                    .userData = 0,
-                    .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 10).id, // TODO need a better strategy for managing derived ids
+                    .boundingBox = currentElementBoundingBox,
+                    .renderData = { .rectangle = {
+                            .backgroundColor = sharedConfig->backgroundColor,
+                            .cornerRadius = sharedConfig->cornerRadius,
+                    }},
+                    .userData = sharedConfig->userData,
+                    .id = currentElement->id,
                     .zIndex = root->zIndex,
-                    .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START,
+                    .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
                 });
             }
-        }
-        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = { .x = (float)rootElement->layoutConfig->padding.left, .y = (float)rootElement->layoutConfig->padding.top } });
 
-        context->treeNodeVisited.internalArray[0] = false;
-        while (dfsBuffer.length > 0) {
-            Clay__LayoutElementTreeNode *currentElementTreeNode = Clay__LayoutElementTreeNodeArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
-            Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
-            Clay_LayoutConfig *layoutConfig = currentElement->layoutConfig;
-            Clay_Vector2 scrollOffset = CLAY__DEFAULT_STRUCT;
-
-            // This will only be run a single time for each element in downwards DFS order
-            if (!context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
-                context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
-
-                Clay_BoundingBox currentElementBoundingBox = { currentElementTreeNode->position.x, currentElementTreeNode->position.y, currentElement->dimensions.width, currentElement->dimensions.height };
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
-                    Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
-                    Clay_Dimensions expand = floatingElementConfig->expand;
-                    currentElementBoundingBox.x -= expand.width;
-                    currentElementBoundingBox.width += expand.width * 2;
-                    currentElementBoundingBox.y -= expand.height;
-                    currentElementBoundingBox.height += expand.height * 2;
+            // Children of a clip container can only be seen inside both its bounding box and every clip rectangle above it
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
+                if (cullClipDepth < CLAY__CULL_CLIP_STACK_CAPACITY) {
+                    cullClipStack[cullClipDepth] = cullClipBox ? Clay__IntersectBoundingBoxes(*cullClipBox, currentElementBoundingBox) : currentElementBoundingBox;
                 }
+                cullClipDepth++;
+            }
 
-                Clay__ScrollContainerDataInternal *scrollContainerData = CLAY__NULL;
-                // Apply scroll offsets to container
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
-                    Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-
-                    // This linear scan could theoretically be slow under very strange conditions, but I can't imagine a real UI with more than a few 10's of scroll containers
-                    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            scrollContainerData = mapping;
-                            mapping->boundingBox = currentElementBoundingBox;
-                            scrollOffset = clipConfig->childOffset;
-                            if (context->externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
-                            }
-                            break;
-                        }
+            // Setup initial on-axis alignment
+            if (!Clay__ElementHasConfig(currentElementTreeNode->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+                Clay_Dimensions contentSize = {0,0};
+                if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                    for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
+                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                        contentSize.width += childElement->dimensions.width;
+                        contentSize.height = CLAY__MAX(contentSize.height, childElement->dimensions.height);
                     }
-                }
-
-                Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(currentElement->id);
-                if (hashMapItem) {
-                    hashMapItem->boundingBox = currentElementBoundingBox;
-                    if (hashMapItem->idAlias) {
-                        Clay_LayoutElementHashMapItem *hashMapItemAlias = Clay__GetHashMapItem(hashMapItem->idAlias);
-                        if (hashMapItemAlias) {
-                            hashMapItemAlias->boundingBox = currentElementBoundingBox;
-                        }
+                    contentSize.width += (float)(CLAY__MAX(currentElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
+                    float extraSpace = currentElement->dimensions.width - (float)(layoutConfig->padding.left + layoutConfig->padding.right) - contentSize.width;
+                    switch (layoutConfig->childAlignment.x) {
+                        case CLAY_ALIGN_X_LEFT: extraSpace = 0; break;
+                        case CLAY_ALIGN_X_CENTER: extraSpace /= 2; break;
+                        default: break;
+                    }
+                    currentElementTreeNode->nextChildOffset.x += extraSpace;
+                    extraSpace = CLAY__MAX(0, extraSpace);
+                } else {
+                    for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
+                        Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                        contentSize.width = CLAY__MAX(contentSize.width, childElement->dimensions.width);
+                        contentSize.height += childElement->dimensions.height;
+                    }
+                    contentSize.height += (float)(CLAY__MAX(currentElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
+                    float extraSpace = currentElement->dimensions.height - (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) - contentSize.height;
+                    switch (layoutConfig->childAlignment.y) {
+                        case CLAY_ALIGN_Y_TOP: extraSpace = 0; break;
+                        case CLAY_ALIGN_Y_CENTER: extraSpace /= 2; break;
+                        default: break;
                     }
+                    extraSpace = CLAY__MAX(0, extraSpace);
+                    currentElementTreeNode->nextChildOffset.y += extraSpace;
                 }
 
-                int32_t sortedConfigIndexes[20];
-                for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    sortedConfigIndexes[elementConfigIndex] = elementConfigIndex;
+                if (scrollContainerData) {
+                    scrollContainerData->contentSize = CLAY__INIT(Clay_Dimensions) { contentSize.width + (float)(layoutConfig->padding.left + layoutConfig->padding.right), contentSize.height + (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) };
                 }
-                sortMax = currentElement->elementConfigs.length - 1;
-                while (sortMax > 0) { // todo dumb bubble sort
-                    for (int32_t i = 0; i < sortMax; ++i) {
-                        int32_t current = sortedConfigIndexes[i];
-                        int32_t next = sortedConfigIndexes[i + 1];
-                        Clay__ElementConfigType currentType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, current)->type;
-                        Clay__ElementConfigType nextType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, next)->type;
-                        if (nextType == CLAY__ELEMENT_CONFIG_TYPE_CLIP || currentType == CLAY__ELEMENT_CONFIG_TYPE_BORDER) {
-                            sortedConfigIndexes[i] = next;
-                            sortedConfigIndexes[i + 1] = current;
+            }
+        }
+        else {
+            // DFS is returning upwards backwards
+            bool closeClipElement = false;
+            Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+            if (clipConfig) {
+                closeClipElement = true;
+                for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
+                    Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+                    if (mapping->layoutElement == currentElement) {
+                        scrollOffset = clipConfig->childOffset;
+                        if (context->externalScrollHandlingEnabled) {
+                            scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
                         }
+                        break;
                     }
-                    sortMax--;
                 }
+            }
 
-                bool emitRectangle = false;
-                // Create the render commands for this element
-                Clay_SharedElementConfig *sharedConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig;
-                if (sharedConfig && sharedConfig->backgroundColor.a > 0) {
-                   emitRectangle = true;
-                }
-                else if (!sharedConfig) {
-                    emitRectangle = false;
-                    sharedConfig = &Clay_SharedElementConfig_DEFAULT;
-                }
-                for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    Clay_ElementConfig *elementConfig = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, sortedConfigIndexes[elementConfigIndex]);
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER)) {
+                Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
+                Clay_BoundingBox currentElementBoundingBox = currentElementData->boundingBox;
+
+                // Culling - Don't bother to generate render commands for rectangles entirely outside the screen or the enclosing clip rectangles - this won't stop their children from being rendered if they overflow
+                if (!Clay__ElementIsCulled(&currentElementBoundingBox, cullClipBox)) {
+                    Clay_SharedElementConfig *sharedConfig = Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED) ? Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig : &Clay_SharedElementConfig_DEFAULT;
+                    Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER).borderElementConfig;
                     Clay_RenderCommand renderCommand = {
-                        .boundingBox = currentElementBoundingBox,
-                        .userData = sharedConfig->userData,
-                        .id = currentElement->id,
+                            .boundingBox = currentElementBoundingBox,
+                            .renderData = { .border = {
+                                .color = borderConfig->color,
+                                .cornerRadius = sharedConfig->cornerRadius,
+                                .width = borderConfig->width
+                            }},
+                            .userData = sharedConfig->userData,
+                            .id = Clay__HashNumber(currentElement->id, currentElement->childrenOrTextContent.children.length).id,
+                            .commandType = CLAY_RENDER_COMMAND_TYPE_BORDER,
                     };
-
-                    bool offscreen = Clay__ElementIsOffscreen(&currentElementBoundingBox);
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
-                    bool shouldRender = !offscreen;
-                    switch (elementConfig->type) {
-                        case CLAY__ELEMENT_CONFIG_TYPE_ASPECT:
-                        case CLAY__ELEMENT_CONFIG_TYPE_FLOATING:
-                        case CLAY__ELEMENT_CONFIG_TYPE_SHARED:
-                        case CLAY__ELEMENT_CONFIG_TYPE_BORDER: {
-                            shouldRender = false;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_CLIP: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START;
-                            renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
-                                .clip = {
-                                    .horizontal = elementConfig->config.clipElementConfig->horizontal,
-                                    .vertical = elementConfig->config.clipElementConfig->vertical,
+                    Clay__AddRenderCommand(renderCommand);
+                    if (borderConfig->width.betweenChildren > 0 && borderConfig->color.a > 0) {
+                        float halfGap = layoutConfig->childGap / 2;
+                        Clay_Vector2 borderOffset = { (float)layoutConfig->padding.left - halfGap, (float)layoutConfig->padding.top - halfGap };
+                        if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                            for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
+                                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                                Clay_BoundingBox dividerBoundingBox = Clay__SnapBoundingBox(CLAY__INIT(Clay_BoundingBox) { currentElementBoundingBox.x + borderOffset.x + scrollOffset.x, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->width.betweenChildren, currentElement->dimensions.height }, context->pixelSnapGridSize);
+                                if (i > 0 && !Clay__ElementIsCulled(&dividerBoundingBox, cullClipBox)) {
+                                    Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
+                                        .boundingBox = dividerBoundingBox,
+                                        .renderData = { .rectangle = {
+                                            .backgroundColor = borderConfig->color,
+                                        } },
+                                        .userData = sharedConfig->userData,
+                                        .id = Clay__HashNumber(currentElement->id, currentElement->childrenOrTextContent.children.length + 1 + i).id,
+                                        .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
+                                    });
                                 }
-                            };
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_IMAGE: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_IMAGE;
-                            renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
-                                .image = {
-                                    .backgroundColor = sharedConfig->backgroundColor,
-                                    .cornerRadius = sharedConfig->cornerRadius,
-                                    .imageData = elementConfig->config.imageElementConfig->imageData,
-                               }
-                            };
-                            emitRectangle = false;
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
-                            if (!shouldRender) {
-                                break;
+                                borderOffset.x += (childElement->dimensions.width + (float)layoutConfig->childGap);
                             }
-                            shouldRender = false;
-                            Clay_ElementConfigUnion configUnion = elementConfig->config;
-                            Clay_TextElementConfig *textElementConfig = configUnion.textElementConfig;
-                            float naturalLineHeight = currentElement->childrenOrTextContent.textElementData->preferredDimensions.height;
-                            float finalLineHeight = textElementConfig->lineHeight > 0 ? (float)textElementConfig->lineHeight : naturalLineHeight;
-                            float lineHeightOffset = (finalLineHeight - naturalLineHeight) / 2;
-                            float yPosition = lineHeightOffset;
-                            for (int32_t lineIndex = 0; lineIndex < currentElement->childrenOrTextContent.textElementData->wrappedLines.length; ++lineIndex) {
-                                Clay__WrappedTextLine *wrappedLine = Clay__WrappedTextLineArraySlice_Get(&currentElement->childrenOrTextContent.textElementData->wrappedLines, lineIndex);
-                                if (wrappedLine->line.length == 0) {
-                                    yPosition += finalLineHeight;
-                                    continue;
-                                }
-                                float offset = (currentElementBoundingBox.width - wrappedLine->dimensions.width);
-                                if (textElementConfig->textAlignment == CLAY_TEXT_ALIGN_LEFT) {
-                                    offset = 0;
-                                }
-                                if (textElementConfig->textAlignment == CLAY_TEXT_ALIGN_CENTER) {
-                                    offset /= 2;
-                                }
-                                Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                    .boundingBox = { currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height },
-                                    .renderData = { .text = {
-                                        .stringContents = CLAY__INIT(Clay_StringSlice) { .length = wrappedLine->line.length, .chars = wrappedLine->line.chars, .baseChars = currentElement->childrenOrTextContent.textElementData->text.chars },
-                                        .textColor = textElementConfig->textColor,
-                                        .fontId = textElementConfig->fontId,
-                                        .fontSize = textElementConfig->fontSize,
-                                        .letterSpacing = textElementConfig->letterSpacing,
-                                        .lineHeight = textElementConfig->lineHeight,
-                                    }},
-                                    .userData = textElementConfig->userData,
-                                    .id = Clay__HashNumber(lineIndex, currentElement->id).id,
-                                    .zIndex = root->zIndex,
-                                    .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT,
-                                });
-                                yPosition += finalLineHeight;
-
-                                if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > context->layoutDimensions.height)) {
-                                    break;
+                        } else {
+                            for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
+                                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                                Clay_BoundingBox dividerBoundingBox = Clay__SnapBoundingBox(CLAY__INIT(Clay_BoundingBox) { currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y, currentElement->dimensions.width, (float)borderConfig->width.betweenChildren }, context->pixelSnapGridSize);
+                                if (i > 0 && !Clay__ElementIsCulled(&dividerBoundingBox, cullClipBox)) {
+                                    Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
+                                        .boundingBox = dividerBoundingBox,
+                                        .renderData = { .rectangle = {
+                                                .backgroundColor = borderConfig->color,
+                                        } },
+                                        .userData = sharedConfig->userData,
+                                        .id = Clay__HashNumber(currentElement->id, currentElement->childrenOrTextContent.children.length + 1 + i).id,
+                                        .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
+                                    });
                                 }
+                                borderOffset.y += (childElement->dimensions.height + (float)layoutConfig->childGap);
                             }
-                            break;
-                        }
-                        case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: {
-                            renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_CUSTOM;
-                            renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
-                                .custom = {
-                                    .backgroundColor = sharedConfig->backgroundColor,
-                                    .cornerRadius = sharedConfig->cornerRadius,
-                                    .customData = elementConfig->config.customElementConfig->customData,
-                                }
-                            };
-                            emitRectangle = false;
-                            break;
                         }
-                        default: break;
-                    }
-                    if (shouldRender) {
-                        Clay__AddRenderCommand(renderCommand);
-                    }
-                    if (offscreen) {
-                        // NOTE: You may be tempted to try an early return / continue if an element is off screen. Why bother calculating layout for its children, right?
-                        // Unfortunately, a FLOATING_CONTAINER may be defined that attaches to a child or grandchild of this element, which is large enough to still
-                        // be on screen, even if this element isn't. That depends on this element and it's children being laid out correctly (even if they are entirely off screen)
                     }
                 }
-
-                if (emitRectangle) {
-                    Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                        .boundingBox = currentElementBoundingBox,
-                        .renderData = { .rectangle = {
-                                .backgroundColor = sharedConfig->backgroundColor,
-                                .cornerRadius = sharedConfig->cornerRadius,
-                        }},
-                        .userData = sharedConfig->userData,
-                        .id = currentElement->id,
-                        .zIndex = root->zIndex,
-                        .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
-                    });
+            }
+            // This exists because the scissor needs to end _after_ borders between elements
+            if (closeClipElement) {
+                Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
+                    .id = Clay__HashNumber(currentElement->id, rootElement->childrenOrTextContent.children.length + 11).id,
+                    .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END,
+                });
+                cullClipDepth--;
+            }
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_LAYER)) {
+                layerDepth--;
+                if (layerDepth < CLAY__LAYER_STACK_CAPACITY && layerStartIndexes[layerDepth] >= 0) {
+                    Clay__CloseLayer(layerStartIndexes[layerDepth]);
                 }
+            }
 
-                // Setup initial on-axis alignment
-                if (!Clay__ElementHasConfig(currentElementTreeNode->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
-                    Clay_Dimensions contentSize = {0,0};
-                    if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                        for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
-                            contentSize.width += childElement->dimensions.width;
-                            contentSize.height = CLAY__MAX(contentSize.height, childElement->dimensions.height);
-                        }
-                        contentSize.width += (float)(CLAY__MAX(currentElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
-                        float extraSpace = currentElement->dimensions.width - (float)(layoutConfig->padding.left + layoutConfig->padding.right) - contentSize.width;
-                        switch (layoutConfig->childAlignment.x) {
-                            case CLAY_ALIGN_X_LEFT: extraSpace = 0; break;
-                            case CLAY_ALIGN_X_CENTER: extraSpace /= 2; break;
-                            default: break;
-                        }
-                        currentElementTreeNode->nextChildOffset.x += extraSpace;
-                        extraSpace = CLAY__MAX(0, extraSpace);
-                    } else {
-                        for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
-                            contentSize.width = CLAY__MAX(contentSize.width, childElement->dimensions.width);
-                            contentSize.height += childElement->dimensions.height;
-                        }
-                        contentSize.height += (float)(CLAY__MAX(currentElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
-                        float extraSpace = currentElement->dimensions.height - (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) - contentSize.height;
-                        switch (layoutConfig->childAlignment.y) {
-                            case CLAY_ALIGN_Y_TOP: extraSpace = 0; break;
-                            case CLAY_ALIGN_Y_CENTER: extraSpace /= 2; break;
-                            default: break;
-                        }
-                        extraSpace = CLAY__MAX(0, extraSpace);
-                        currentElementTreeNode->nextChildOffset.y += extraSpace;
-                    }
+            dfsBuffer.length--;
+            continue;
+        }
 
-                    if (scrollContainerData) {
-                        scrollContainerData->contentSize = CLAY__INIT(Clay_Dimensions) { contentSize.width + (float)(layoutConfig->padding.left + layoutConfig->padding.right), contentSize.height + (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) };
+        // Add children to the DFS buffer
+        if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+            dfsBuffer.length += currentElement->childrenOrTextContent.children.length;
+            for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
+                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                // Alignment along non layout axis
+                if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                    currentElementTreeNode->nextChildOffset.y = currentElement->layoutConfig->padding.top;
+                    float whiteSpaceAroundChild = currentElement->dimensions.height - (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) - childElement->dimensions.height;
+                    switch (layoutConfig->childAlignment.y) {
+                        case CLAY_ALIGN_Y_TOP: break;
+                        case CLAY_ALIGN_Y_CENTER: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild / 2; break;
+                        case CLAY_ALIGN_Y_BOTTOM: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild; break;
                     }
-                }
-            }
-            else {
-                // DFS is returning upwards backwards
-                bool closeClipElement = false;
-                Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                if (clipConfig) {
-                    closeClipElement = true;
-                    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            scrollOffset = clipConfig->childOffset;
-                            if (context->externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
-                            }
-                            break;
-                        }
+                } else {
+                    currentElementTreeNode->nextChildOffset.x = currentElement->layoutConfig->padding.left;
+                    float whiteSpaceAroundChild = currentElement->dimensions.width - (float)(layoutConfig->padding.left + layoutConfig->padding.right) - childElement->dimensions.width;
+                    switch (layoutConfig->childAlignment.x) {
+                        case CLAY_ALIGN_X_LEFT: break;
+                        case CLAY_ALIGN_X_CENTER: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild / 2; break;
+                        case CLAY_ALIGN_X_RIGHT: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild; break;
                     }
                 }
 
-                if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER)) {
-                    Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
-                    Clay_BoundingBox currentElementBoundingBox = currentElementData->boundingBox;
-
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
-                    if (!Clay__ElementIsOffscreen(&currentElementBoundingBox)) {
-                        Clay_SharedElementConfig *sharedConfig = Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED) ? Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig : &Clay_SharedElementConfig_DEFAULT;
-                        Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER).borderElementConfig;
-                        Clay_RenderCommand renderCommand = {
-                                .boundingBox = currentElementBoundingBox,
-                                .renderData = { .border = {
-                                    .color = borderConfig->color,
-                                    .cornerRadius = sharedConfig->cornerRadius,
-                                    .width = borderConfig->width
-                                }},
-                                .userData = sharedConfig->userData,
-                                .id = Clay__HashNumber(currentElement->id, currentElement->childrenOrTextContent.children.length).id,
-                                .commandType = CLAY_RENDER_COMMAND_TYPE_BORDER,
-                        };
-                        Clay__AddRenderCommand(renderCommand);
-                        if (borderConfig->width.betweenChildren > 0 && borderConfig->color.a > 0) {
-                            float halfGap = layoutConfig->childGap / 2;
-                            Clay_Vector2 borderOffset = { (float)layoutConfig->padding.left - halfGap, (float)layoutConfig->padding.top - halfGap };
-                            if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                                for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
-                                    if (i > 0) {
-                                        Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                            .boundingBox = { currentElementBoundingBox.x + borderOffset.x + scrollOffset.x, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->width.betweenChildren, currentElement->dimensions.height },
-                                            .renderData = { .rectangle = {
-                                                .backgroundColor = borderConfig->color,
-                                            } },
-                                            .userData = sharedConfig->userData,
-                                            .id = Clay__HashNumber(currentElement->id, currentElement->childrenOrTextContent.children.length + 1 + i).id,
-                                            .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
-                                        });
-                                    }
-                                    borderOffset.x += (childElement->dimensions.width + (float)layoutConfig->childGap);
-                                }
-                            } else {
-                                for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
-                                    if (i > 0) {
-                                        Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                            .boundingBox = { currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y, currentElement->dimensions.width, (float)borderConfig->width.betweenChildren },
-                                            .renderData = { .rectangle = {
-                                                    .backgroundColor = borderConfig->color,
-                                            } },
-                                            .userData = sharedConfig->userData,
-                                            .id = Clay__HashNumber(currentElement->id, currentElement->childrenOrTextContent.children.length + 1 + i).id,
-                                            .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
-                                        });
-                                    }
-                                    borderOffset.y += (childElement->dimensions.height + (float)layoutConfig->childGap);
-                                }
-                            }
-                        }
-                    }
+                Clay_Vector2 childPosition = {
+                    currentElementTreeNode->position.x + currentElementTreeNode->nextChildOffset.x + scrollOffset.x,
+                    currentElementTreeNode->position.y + currentElementTreeNode->nextChildOffset.y + scrollOffset.y,
+                };
+
+                // DFS buffer elements need to be added in reverse because stack traversal happens backwards
+                uint32_t newNodeIndex = dfsBuffer.length - 1 - i;
+                dfsBuffer.internalArray[newNodeIndex] = CLAY__INIT(Clay__LayoutElementTreeNode) {
+                    .layoutElement = childElement,
+                    .position = { childPosition.x, childPosition.y },
+                    .nextChildOffset = { .x = (float)childElement->layoutConfig->padding.left, .y = (float)childElement->layoutConfig->padding.top },
+                };
+                context->treeNodeVisited.internalArray[newNodeIndex] = false;
+
+                // Update parent offsets
+                if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
+                    currentElementTreeNode->nextChildOffset.x += childElement->dimensions.width + (float)layoutConfig->childGap;
+                } else {
+                    currentElementTreeNode->nextChildOffset.y += childElement->dimensions.height + (float)layoutConfig->childGap;
                 }
-                // This exists because the scissor needs to end _after_ borders between elements
-                if (closeClipElement) {
-                    Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                        .id = Clay__HashNumber(currentElement->id, rootElement->childrenOrTextContent.children.length + 11).id,
-                        .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END,
-                    });
+            }
+        }
+    }
+
+    if (root->clipElementId) {
+        Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 11).id, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
+    }
+}
+
+void Clay__CalculateFinalLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__SizeLayout(context, 0, 0, 0);
+
+    // Sort tree roots by z-index
+    Clay__SortTreeRootsByZIndex();
+
+    // Calculate final positions and generate render commands
+    context->renderCommands.length = 0;
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        root->renderCommandStart = context->renderCommands.length;
+        Clay__PositionTree(context, root);
+        root->renderCommandCount = context->renderCommands.length - root->renderCommandStart;
+    }
+}
+
+// Commands can only join one of this many most recent batches in their region, which bounds the cost per command
+#define CLAY__DRAW_BATCH_LOOKBACK 16
+// Batches with more commands than this are treated as overlapping any command that overlaps their bounds
+#define CLAY__DRAW_BATCH_OVERLAP_CHECK_LIMIT 32
+
+// A bounding box grown outwards to whole pixels, so commands that share a partially covered pixel count as overlapping
+typedef struct {
+    float left, top, right, bottom;
+} Clay__DrawBounds;
+
+typedef struct {
+    int32_t batchIndex;
+    int32_t lastCommandIndex;
+    Clay__DrawBounds bounds;
+} Clay__OpenDrawBatch;
+
+float Clay__FloorToPixel(float value) {
+    // Floats this large are already whole numbers, and the cast below would overflow
+    if (!(value > -8388608.f && value < 8388608.f)) {
+        return value;
+    }
+    float truncated = (float)(int32_t)value;
+    return truncated > value ? truncated - 1 : truncated;
+}
+
+Clay__DrawBounds Clay__GetDrawBounds(Clay_BoundingBox boundingBox) {
+    return CLAY__INIT(Clay__DrawBounds) {
+        .left = Clay__FloorToPixel(boundingBox.x),
+        .top = Clay__FloorToPixel(boundingBox.y),
+        .right = -Clay__FloorToPixel(-(boundingBox.x + boundingBox.width)),
+        .bottom = -Clay__FloorToPixel(-(boundingBox.y + boundingBox.height)),
+    };
+}
+
+bool Clay__DrawBoundsOverlap(Clay__DrawBounds a, Clay__DrawBounds b) {
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+uint32_t Clay__GetDrawBatchKey(Clay_RenderCommand *renderCommand) {
+    uint32_t key = (uint32_t)renderCommand->commandType << 28;
+    if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+        key |= renderCommand->renderData.text.fontId;
+    } else if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_IMAGE) {
+        uint64_t imageData = (uint64_t)(uintptr_t)renderCommand->renderData.image.imageData;
+        key |= (uint32_t)(imageData ^ (imageData >> 28) ^ (imageData >> 56)) & 0x0FFFFFFF;
+    }
+    return key;
+}
+
+// Commands that have to stay exactly where they are, and that no other command can be moved across
+bool Clay__IsDrawBatchBarrier(Clay_RenderCommandType commandType) {
+    return commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START
+        || commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END
+        || commandType == CLAY_RENDER_COMMAND_TYPE_CUSTOM
+        || commandType == CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN
+        || commandType == CLAY_RENDER_COMMAND_TYPE_LAYER_END
+        || commandType == CLAY_RENDER_COMMAND_TYPE_NONE;
+}
+
+// While planning, batch->startIndex holds the first command of the batch and nextCommand links the rest
+bool Clay__DrawBatchOverlaps(Clay_DrawBatch *batch, Clay__DrawBounds bounds, int32_t *nextCommand) {
+    if (batch->count > CLAY__DRAW_BATCH_OVERLAP_CHECK_LIMIT) {
+        return true;
+    }
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t commandIndex = batch->startIndex; commandIndex != -1; commandIndex = nextCommand[commandIndex]) {
+        if (Clay__DrawBoundsOverlap(bounds, Clay__GetDrawBounds(context->renderCommands.internalArray[commandIndex].boundingBox))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Writes the commands of every batch from firstBatchIndex onwards into the command order, batch by batch
+int32_t Clay__FlushDrawBatches(int32_t firstBatchIndex, int32_t orderedCount, int32_t *nextCommand) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t batchIndex = firstBatchIndex; batchIndex < context->drawBatches.length; ++batchIndex) {
+        Clay_DrawBatch *batch = &context->drawBatches.internalArray[batchIndex];
+        int32_t commandIndex = batch->startIndex;
+        batch->startIndex = orderedCount;
+        for (; commandIndex != -1; commandIndex = nextCommand[commandIndex]) {
+            context->drawBatchCommandOrder.internalArray[orderedCount++] = commandIndex;
+        }
+    }
+    return orderedCount;
+}
+
+void Clay__PlanDrawBatches(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_RenderCommandArray *renderCommands = &context->renderCommands;
+    Clay_DrawBatchArray *drawBatches = &context->drawBatches;
+    // The element index buffer is free once the final layout has been calculated
+    int32_t *nextCommand = context->reusableElementIndexBuffer.internalArray;
+    int32_t *commandOrder = context->drawBatchCommandOrder.internalArray;
+    Clay__OpenDrawBatch openBatches[CLAY__DRAW_BATCH_LOOKBACK];
+    int32_t openBatchCount = 0;
+    int32_t regionFirstBatch = 0;
+    int32_t orderedCount = 0;
+    drawBatches->length = 0;
+
+    for (int32_t i = 0; i < renderCommands->length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands->internalArray[i];
+        uint32_t key = Clay__GetDrawBatchKey(renderCommand);
+        nextCommand[i] = -1;
+        bool barrier = Clay__IsDrawBatchBarrier(renderCommand->commandType);
+        // Commands are sorted by zIndex, so a change of zIndex also starts a new region
+        if (barrier || (i > 0 && renderCommand->zIndex != renderCommands->internalArray[i - 1].zIndex)) {
+            orderedCount = Clay__FlushDrawBatches(regionFirstBatch, orderedCount, nextCommand);
+            regionFirstBatch = drawBatches->length;
+            openBatchCount = 0;
+        }
+        if (barrier) {
+            Clay_DrawBatchArray_Add(drawBatches, CLAY__INIT(Clay_DrawBatch) { .startIndex = i, .count = 1, .key = key });
+            continue;
+        }
+
+        Clay__DrawBounds bounds = Clay__GetDrawBounds(renderCommand->boundingBox);
+        int32_t targetBatch = -1;
+        for (int32_t j = openBatchCount - 1; j >= 0; --j) {
+            Clay_DrawBatch *batch = &drawBatches->internalArray[openBatches[j].batchIndex];
+            if (batch->key == key) {
+                targetBatch = j;
+                break;
+            }
+            // This command would be moved in front of every command in newer batches, so it can't pass one it overlaps
+            if (Clay__DrawBoundsOverlap(bounds, openBatches[j].bounds) && Clay__DrawBatchOverlaps(batch, bounds, nextCommand)) {
+                break;
+            }
+        }
+
+        if (targetBatch >= 0) {
+            Clay__OpenDrawBatch *openBatch = &openBatches[targetBatch];
+            nextCommand[openBatch->lastCommandIndex] = i;
+            openBatch->lastCommandIndex = i;
+            openBatch->bounds.left = CLAY__MIN(openBatch->bounds.left, bounds.left);
+            openBatch->bounds.top = CLAY__MIN(openBatch->bounds.top, bounds.top);
+            openBatch->bounds.right = CLAY__MAX(openBatch->bounds.right, bounds.right);
+            openBatch->bounds.bottom = CLAY__MAX(openBatch->bounds.bottom, bounds.bottom);
+            drawBatches->internalArray[openBatch->batchIndex].count++;
+        } else {
+            if (openBatchCount == CLAY__DRAW_BATCH_LOOKBACK) {
+                for (int32_t j = 1; j < openBatchCount; ++j) {
+                    openBatches[j - 1] = openBatches[j];
                 }
+                openBatchCount--;
+            }
+            openBatches[openBatchCount++] = CLAY__INIT(Clay__OpenDrawBatch) { .batchIndex = drawBatches->length, .lastCommandIndex = i, .bounds = bounds };
+            Clay_DrawBatchArray_Add(drawBatches, CLAY__INIT(Clay_DrawBatch) { .startIndex = i, .count = 1, .key = key });
+        }
+    }
+    Clay__FlushDrawBatches(regionFirstBatch, orderedCount, nextCommand);
 
-                dfsBuffer.length--;
-                continue;
+    // Move each command to its planned position by following the cycles of the permutation, nextCommand now marks visited positions
+    for (int32_t i = 0; i < renderCommands->length; ++i) {
+        nextCommand[i] = 0;
+    }
+    for (int32_t start = 0; start < renderCommands->length; ++start) {
+        if (nextCommand[start] || commandOrder[start] == start) {
+            continue;
+        }
+        Clay_RenderCommand first = renderCommands->internalArray[start];
+        int32_t position = start;
+        while (true) {
+            nextCommand[position] = 1;
+            int32_t source = commandOrder[position];
+            if (source == start) {
+                renderCommands->internalArray[position] = first;
+                break;
             }
+            renderCommands->internalArray[position] = renderCommands->internalArray[source];
+            position = source;
+        }
+    }
 
-            // Add children to the DFS buffer
-            if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
-                dfsBuffer.length += currentElement->childrenOrTextContent.children.length;
-                for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
-                    // Alignment along non layout axis
-                    if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                        currentElementTreeNode->nextChildOffset.y = currentElement->layoutConfig->padding.top;
-                        float whiteSpaceAroundChild = currentElement->dimensions.height - (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) - childElement->dimensions.height;
-                        switch (layoutConfig->childAlignment.y) {
-                            case CLAY_ALIGN_Y_TOP: break;
-                            case CLAY_ALIGN_Y_CENTER: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild / 2; break;
-                            case CLAY_ALIGN_Y_BOTTOM: currentElementTreeNode->nextChildOffset.y += whiteSpaceAroundChild; break;
-                        }
-                    } else {
-                        currentElementTreeNode->nextChildOffset.x = currentElement->layoutConfig->padding.left;
-                        float whiteSpaceAroundChild = currentElement->dimensions.width - (float)(layoutConfig->padding.left + layoutConfig->padding.right) - childElement->dimensions.width;
-                        switch (layoutConfig->childAlignment.x) {
-                            case CLAY_ALIGN_X_LEFT: break;
-                            case CLAY_ALIGN_X_CENTER: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild / 2; break;
-                            case CLAY_ALIGN_X_RIGHT: currentElementTreeNode->nextChildOffset.x += whiteSpaceAroundChild; break;
-                        }
-                    }
+    // Regions end on barriers, so neighbouring batches with the same key can still be merged
+    int32_t mergedLength = 0;
+    for (int32_t i = 0; i < drawBatches->length; ++i) {
+        Clay_DrawBatch batch = drawBatches->internalArray[i];
+        if (mergedLength > 0 && drawBatches->internalArray[mergedLength - 1].key == batch.key) {
+            drawBatches->internalArray[mergedLength - 1].count += batch.count;
+        } else {
+            drawBatches->internalArray[mergedLength++] = batch;
+        }
+    }
+    drawBatches->length = mergedLength;
+}
 
-                    Clay_Vector2 childPosition = {
-                        currentElementTreeNode->position.x + currentElementTreeNode->nextChildOffset.x + scrollOffset.x,
-                        currentElementTreeNode->position.y + currentElementTreeNode->nextChildOffset.y + scrollOffset.y,
-                    };
+// The number of opaque rectangles remembered while culling, the smallest is replaced once this is reached
+#define CLAY__OCCLUDER_CAPACITY 64
+// The maximum nesting of clip regions tracked while culling, opaque rectangles inside deeper regions are not used as occluders
+#define CLAY__OCCLUSION_CLIP_DEPTH 32
+// Bounds the work spent splitting a single command against the occluders
+#define CLAY__OCCLUSION_TEST_BUDGET 64
 
-                    // DFS buffer elements need to be added in reverse because stack traversal happens backwards
-                    uint32_t newNodeIndex = dfsBuffer.length - 1 - i;
-                    dfsBuffer.internalArray[newNodeIndex] = CLAY__INIT(Clay__LayoutElementTreeNode) {
-                        .layoutElement = childElement,
-                        .position = { childPosition.x, childPosition.y },
-                        .nextChildOffset = { .x = (float)childElement->layoutConfig->padding.left, .y = (float)childElement->layoutConfig->padding.top },
-                    };
-                    context->treeNodeVisited.internalArray[newNodeIndex] = false;
+typedef struct {
+    Clay__DrawBounds occluders[CLAY__OCCLUDER_CAPACITY];
+    int32_t occluderCount;
+    int32_t budget;
+} Clay__OcclusionState;
+
+bool Clay__DrawBoundsContain(Clay__DrawBounds outer, Clay__DrawBounds inner) {
+    return inner.left >= outer.left && inner.right <= outer.right && inner.top >= outer.top && inner.bottom <= outer.bottom;
+}
+
+// Returns true if bounds is completely covered by the union of the occluders from firstOccluder onwards.
+// The parts of bounds outside an occluder are split into up to four pieces and tested against the remaining occluders.
+bool Clay__IsOccluded(Clay__OcclusionState *state, Clay__DrawBounds bounds, int32_t firstOccluder) {
+    for (int32_t i = firstOccluder; i < state->occluderCount; ++i) {
+        Clay__DrawBounds occluder = state->occluders[i];
+        if (!Clay__DrawBoundsOverlap(bounds, occluder)) {
+            continue;
+        }
+        if (Clay__DrawBoundsContain(occluder, bounds)) {
+            return true;
+        }
+        if (--state->budget <= 0) {
+            return false;
+        }
+        Clay__DrawBounds pieces[4];
+        int32_t pieceCount = 0;
+        if (bounds.top < occluder.top) {
+            pieces[pieceCount++] = CLAY__INIT(Clay__DrawBounds) { bounds.left, bounds.top, bounds.right, occluder.top };
+        }
+        if (bounds.bottom > occluder.bottom) {
+            pieces[pieceCount++] = CLAY__INIT(Clay__DrawBounds) { bounds.left, occluder.bottom, bounds.right, bounds.bottom };
+        }
+        float middleTop = CLAY__MAX(bounds.top, occluder.top);
+        float middleBottom = CLAY__MIN(bounds.bottom, occluder.bottom);
+        if (bounds.left < occluder.left) {
+            pieces[pieceCount++] = CLAY__INIT(Clay__DrawBounds) { bounds.left, middleTop, occluder.left, middleBottom };
+        }
+        if (bounds.right > occluder.right) {
+            pieces[pieceCount++] = CLAY__INIT(Clay__DrawBounds) { occluder.right, middleTop, bounds.right, middleBottom };
+        }
+        for (int32_t j = 0; j < pieceCount; ++j) {
+            if (!Clay__IsOccluded(state, pieces[j], i + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void Clay__AddOccluder(Clay__OcclusionState *state, Clay__DrawBounds occluder) {
+    if (occluder.right <= occluder.left || occluder.bottom <= occluder.top) {
+        return;
+    }
+    if (state->occluderCount < CLAY__OCCLUDER_CAPACITY) {
+        state->occluders[state->occluderCount++] = occluder;
+        return;
+    }
+    int32_t smallestIndex = 0;
+    float smallestArea = CLAY__MAXFLOAT;
+    for (int32_t i = 0; i < state->occluderCount; ++i) {
+        Clay__DrawBounds existing = state->occluders[i];
+        float area = (existing.right - existing.left) * (existing.bottom - existing.top);
+        if (area < smallestArea) {
+            smallestArea = area;
+            smallestIndex = i;
+        }
+    }
+    if ((occluder.right - occluder.left) * (occluder.bottom - occluder.top) > smallestArea) {
+        state->occluders[smallestIndex] = occluder;
+    }
+}
+
+// Walks the render commands from front to back, remembering opaque rectangles and dropping commands that are hidden behind them.
+void Clay__CullOccludedRenderCommands(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_RenderCommandArray *renderCommands = &context->renderCommands;
+    // For each SCISSOR_END, the index of its SCISSOR_START. The element index buffer is free once the final layout has been calculated.
+    int32_t *scissorStartIndex = context->reusableElementIndexBuffer.internalArray;
+    int32_t openScissorCount = 0;
+    for (int32_t i = 0; i < renderCommands->length; ++i) {
+        Clay_RenderCommandType commandType = renderCommands->internalArray[i].commandType;
+        if (commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START) {
+            context->openClipElementStack.internalArray[openScissorCount++] = i;
+        } else if (commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+            scissorStartIndex[i] = openScissorCount > 0 ? context->openClipElementStack.internalArray[--openScissorCount] : -1;
+        }
+    }
 
-                    // Update parent offsets
-                    if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
-                        currentElementTreeNode->nextChildOffset.x += childElement->dimensions.width + (float)layoutConfig->childGap;
-                    } else {
-                        currentElementTreeNode->nextChildOffset.y += childElement->dimensions.height + (float)layoutConfig->childGap;
+    Clay__OcclusionState state;
+    state.occluderCount = 0;
+    // Occluders are clipped to every enclosing scissor, which is never more than a renderer actually draws
+    Clay__DrawBounds clipStack[CLAY__OCCLUSION_CLIP_DEPTH];
+    int32_t clipDepth = 0;
+    int32_t writeIndex = renderCommands->length;
+    for (int32_t i = renderCommands->length - 1; i >= 0; --i) {
+        Clay_RenderCommand *renderCommand = &renderCommands->internalArray[i];
+        bool occluded = false;
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                if (clipDepth < CLAY__OCCLUSION_CLIP_DEPTH) {
+                    // An unmatched SCISSOR_END clips to nothing, so nothing inside it is used as an occluder
+                    Clay__DrawBounds clip = CLAY__DEFAULT_STRUCT;
+                    if (scissorStartIndex[i] >= 0) {
+                        Clay_BoundingBox clipBox = renderCommands->internalArray[scissorStartIndex[i]].boundingBox;
+                        clip = CLAY__INIT(Clay__DrawBounds) { clipBox.x, clipBox.y, clipBox.x + clipBox.width, clipBox.y + clipBox.height };
+                    }
+                    if (clipDepth > 0) {
+                        Clay__DrawBounds parent = clipStack[clipDepth - 1];
+                        clip.left = CLAY__MAX(clip.left, parent.left);
+                        clip.top = CLAY__MAX(clip.top, parent.top);
+                        clip.right = CLAY__MIN(clip.right, parent.right);
+                        clip.bottom = CLAY__MIN(clip.bottom, parent.bottom);
+                    }
+                    clipStack[clipDepth] = clip;
+                }
+                clipDepth++;
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                clipDepth = CLAY__MAX(clipDepth - 1, 0);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: {
+                // A cached layer has to contain everything it draws, so nothing drawn after it can cull the commands inside it
+                state.occluderCount = 0;
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                Clay__DrawBounds bounds = Clay__GetDrawBounds(renderCommand->boundingBox);
+                state.budget = CLAY__OCCLUSION_TEST_BUDGET;
+                occluded = Clay__IsOccluded(&state, bounds, 0);
+                Clay_RectangleRenderData *rectangle = &renderCommand->renderData.rectangle;
+                Clay_CornerRadius radius = rectangle->cornerRadius;
+                if (!occluded && renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE && rectangle->backgroundColor.a >= 255
+                    && radius.topLeft == 0 && radius.topRight == 0 && radius.bottomLeft == 0 && radius.bottomRight == 0 && clipDepth <= CLAY__OCCLUSION_CLIP_DEPTH) {
+                    // Only pixels the rectangle covers completely hide what is underneath
+                    Clay_BoundingBox box = renderCommand->boundingBox;
+                    Clay__DrawBounds occluder = {
+                        -Clay__FloorToPixel(-box.x),
+                        -Clay__FloorToPixel(-box.y),
+                        Clay__FloorToPixel(box.x + box.width),
+                        Clay__FloorToPixel(box.y + box.height),
+                    };
+                    if (clipDepth > 0) {
+                        Clay__DrawBounds clip = clipStack[clipDepth - 1];
+                        occluder.left = CLAY__MAX(occluder.left, -Clay__FloorToPixel(-clip.left));
+                        occluder.top = CLAY__MAX(occluder.top, -Clay__FloorToPixel(-clip.top));
+                        occluder.right = CLAY__MIN(occluder.right, Clay__FloorToPixel(clip.right));
+                        occluder.bottom = CLAY__MIN(occluder.bottom, Clay__FloorToPixel(clip.bottom));
                     }
+                    Clay__AddOccluder(&state, occluder);
                 }
+                break;
             }
+            default: break;
         }
-
-        if (root->clipElementId) {
-            Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 11).id, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
+        if (!occluded) {
+            renderCommands->internalArray[--writeIndex] = *renderCommand;
         }
     }
+    int32_t remaining = renderCommands->length - writeIndex;
+    for (int32_t i = 0; i < remaining; ++i) {
+        renderCommands->internalArray[i] = renderCommands->internalArray[writeIndex + i];
+    }
+    renderCommands->length = remaining;
 }
 
 CLAY_WASM_EXPORT("Clay_GetPointerOverIds")
@@ -3148,7 +5385,6 @@ const int32_t CLAY__DEBUGVIEW_ROW_HEIGHT = 30;
 const int32_t CLAY__DEBUGVIEW_OUTER_PADDING = 10;
 const int32_t CLAY__DEBUGVIEW_INDENT_WIDTH = 16;
 Clay_TextElementConfig Clay__DebugView_TextNameConfig = {.textColor = {238, 226, 231, 255}, .fontSize = 16, .wrapMode = CLAY_TEXT_WRAP_NONE };
-Clay_LayoutConfig Clay__DebugView_ScrollViewItemLayoutConfig = CLAY__DEFAULT_STRUCT;
 
 typedef struct {
     Clay_String label;
@@ -3165,6 +5401,7 @@ Clay__DebugElementConfigTypeLabelConfig Clay__DebugGetElementConfigTypeLabel(Cla
         case CLAY__ELEMENT_CONFIG_TYPE_CLIP: return CLAY__INIT(Clay__DebugElementConfigTypeLabelConfig) {CLAY_STRING("Scroll"), {242, 196, 90, 255} };
         case CLAY__ELEMENT_CONFIG_TYPE_BORDER: return CLAY__INIT(Clay__DebugElementConfigTypeLabelConfig) {CLAY_STRING("Border"), {108, 91, 123, 255} };
         case CLAY__ELEMENT_CONFIG_TYPE_CUSTOM: return CLAY__INIT(Clay__DebugElementConfigTypeLabelConfig) { CLAY_STRING("Custom"), {11,72,107,255} };
+        case CLAY__ELEMENT_CONFIG_TYPE_LAYER: return CLAY__INIT(Clay__DebugElementConfigTypeLabelConfig) { CLAY_STRING("Layer"), {164,116,217,255} };
         default: break;
     }
     return CLAY__INIT(Clay__DebugElementConfigTypeLabelConfig) { CLAY_STRING("Error"), {0,0,0,255} };
@@ -3179,7 +5416,7 @@ typedef struct {
 Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialRootsLength, int32_t highlightedRowIndex) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__int32_tArray dfsBuffer = context->reusableElementIndexBuffer;
-    Clay__DebugView_ScrollViewItemLayoutConfig = CLAY__INIT(Clay_LayoutConfig) { .sizing = { .height = CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT) }, .childGap = 6, .childAlignment = { .y = CLAY_ALIGN_Y_CENTER }};
+    Clay_LayoutConfig scrollViewItemLayoutConfig = CLAY__INIT(Clay_LayoutConfig) { .sizing = { .height = CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT) }, .childGap = 6, .childAlignment = { .y = CLAY_ALIGN_Y_CENTER }};
     Clay__RenderDebugLayoutData layoutData = CLAY__DEFAULT_STRUCT;
 
     uint32_t highlightedElementId = 0;
@@ -3221,7 +5458,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
             if (context->debugSelectedElementId == currentElement->id) {
                 layoutData.selectedElementRowIndex = layoutData.rowCount;
             }
-            CLAY({ .id = CLAY_IDI("Clay__DebugView_ElementOuter", currentElement->id), .layout = Clay__DebugView_ScrollViewItemLayoutConfig }) {
+            CLAY({ .id = CLAY_IDI("Clay__DebugView_ElementOuter", currentElement->id), .layout = scrollViewItemLayoutConfig }) {
                 // Collapse icon / button
                 if (!(Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || currentElement->childrenOrTextContent.children.length == 0)) {
                     CLAY({
@@ -3329,7 +5566,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
 
     if (highlightedElementId) {
         CLAY({ .id = CLAY_ID("Clay__DebugView_ElementHighlight"), .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)} }, .floating = { .parentId = highlightedElementId, .zIndex = 32767, .pointerCaptureMode = CLAY_POINTER_CAPTURE_MODE_PASSTHROUGH, .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID } }) {
-            CLAY({ .id = CLAY_ID("Clay__DebugView_ElementHighlightRectangle"), .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)} }, .backgroundColor = Clay__debugViewHighlightColor }) {}
+            CLAY({ .id = CLAY_ID("Clay__DebugView_ElementHighlightRectangle"), .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)} }, .backgroundColor = context->debugViewHighlightColor }) {}
         }
     }
     return layoutData;
@@ -3451,12 +5688,12 @@ void Clay__RenderDebugView(void) {
     int32_t highlightedRow = pointerInDebugView
             ? (int32_t)((context->pointerInfo.position.y - scrollYOffset) / (float)CLAY__DEBUGVIEW_ROW_HEIGHT) - 1
             : -1;
-    if (context->pointerInfo.position.x < context->layoutDimensions.width - (float)Clay__debugViewWidth) {
+    if (context->pointerInfo.position.x < context->layoutDimensions.width - (float)context->debugViewWidth) {
         highlightedRow = -1;
     }
     Clay__RenderDebugLayoutData layoutData = CLAY__DEFAULT_STRUCT;
     CLAY({ .id = CLAY_ID("Clay__DebugView"),
-         .layout = { .sizing = { CLAY_SIZING_FIXED((float)Clay__debugViewWidth) , CLAY_SIZING_FIXED(context->layoutDimensions.height) }, .layoutDirection = CLAY_TOP_TO_BOTTOM },
+         .layout = { .sizing = { CLAY_SIZING_FIXED((float)context->debugViewWidth) , CLAY_SIZING_FIXED(context->layoutDimensions.height) }, .layoutDirection = CLAY_TOP_TO_BOTTOM },
         .floating = { .zIndex = 32765, .attachPoints = { .element = CLAY_ATTACH_POINT_LEFT_CENTER, .parent = CLAY_ATTACH_POINT_RIGHT_CENTER }, .attachTo = CLAY_ATTACH_TO_ROOT, .clipTo = CLAY_CLIP_TO_ATTACHED_PARENT },
         .border = { .color = CLAY__DEBUGVIEW_COLOR_3, .width = { .bottom = 1 } }
     }) {
@@ -3849,10 +6086,10 @@ Clay__WarningArray Clay__WarningArray_Allocate_Arena(int32_t capacity, Clay_Aren
         arena->nextAllocation = nextAllocOffset + totalSizeBytes;
     }
     else {
-        Clay__currentContext->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+        Clay_GetCurrentContext()->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
             .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
             .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
-            .userData = Clay__currentContext->errorHandler.userData });
+            .userData = Clay_GetCurrentContext()->errorHandler.userData });
     }
     return array;
 }
@@ -3875,10 +6112,10 @@ void* Clay__Array_Allocate_Arena(int32_t capacity, uint32_t itemSize, Clay_Arena
         return (void*)((uintptr_t)arena->memory + (uintptr_t)nextAllocOffset);
     }
     else {
-        Clay__currentContext->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+        Clay_GetCurrentContext()->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                 .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
                 .errorText = CLAY_STRING("Clay attempted to allocate memory in its arena, but ran out of capacity. Try increasing the capacity of the arena passed to Clay_Initialize()"),
-                .userData = Clay__currentContext->errorHandler.userData });
+                .userData = Clay_GetCurrentContext()->errorHandler.userData });
     }
     return CLAY__NULL;
 }
@@ -3916,6 +6153,9 @@ uint32_t Clay_MinMemorySize(void) {
     Clay_Context fakeContext = {
         .maxElementCount = Clay__defaultMaxElementCount,
         .maxMeasureTextCacheWordCount = Clay__defaultMaxMeasureTextWordCacheCount,
+        .frameBufferCount = Clay__defaultFrameBufferCount,
+        .frameStringCapacity = Clay__defaultFrameStringCapacity,
+        .maxWrappedTextLineCount = Clay__defaultMaxWrappedTextLineCount,
         .internalArena = {
             .capacity = SIZE_MAX,
             .memory = NULL,
@@ -3925,6 +6165,9 @@ uint32_t Clay_MinMemorySize(void) {
     if (currentContext) {
         fakeContext.maxElementCount = currentContext->maxElementCount;
         fakeContext.maxMeasureTextCacheWordCount = currentContext->maxMeasureTextCacheWordCount;
+        fakeContext.frameBufferCount = currentContext->frameBufferCount;
+        fakeContext.frameStringCapacity = currentContext->frameStringCapacity;
+        fakeContext.maxWrappedTextLineCount = currentContext->maxWrappedTextLineCount;
     }
     // Reserve space in the arena for the context, important for calculating min memory size correctly
     Clay__Context_Allocate_Arena(&fakeContext.internalArena);
@@ -3945,12 +6188,13 @@ Clay_Arena Clay_CreateArenaWithCapacityAndMemory(size_t capacity, void *memory)
 #ifndef CLAY_WASM
 void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData), void *userData) {
     Clay_Context* context = Clay_GetCurrentContext();
-    Clay__MeasureText = measureTextFunction;
+    context->measureTextFunction = measureTextFunction;
     context->measureTextUserData = userData;
+    context->previousFrameHash = 0;
 }
 void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData) {
     Clay_Context* context = Clay_GetCurrentContext();
-    Clay__QueryScrollOffset = queryScrollOffsetFunction;
+    context->queryScrollOffsetFunction = queryScrollOffsetFunction;
     context->queryScrollOffsetUserData = userData;
 }
 #endif
@@ -4048,13 +6292,27 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
     *context = CLAY__INIT(Clay_Context) {
         .maxElementCount = oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount,
         .maxMeasureTextCacheWordCount = oldContext ? oldContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextWordCacheCount,
+        .frameBufferCount = oldContext ? oldContext->frameBufferCount : Clay__defaultFrameBufferCount,
+        .frameStringCapacity = oldContext ? oldContext->frameStringCapacity : Clay__defaultFrameStringCapacity,
+        .maxWrappedTextLineCount = oldContext ? oldContext->maxWrappedTextLineCount : Clay__defaultMaxWrappedTextLineCount,
         .errorHandler = errorHandler.errorHandlerFunction ? errorHandler : CLAY__INIT(Clay_ErrorHandler) { Clay__ErrorHandlerFunctionDefault, 0 },
         .layoutDimensions = layoutDimensions,
+#ifdef CLAY_WASM
+        .measureTextFunction = Clay__MeasureText,
+        .queryScrollOffsetFunction = Clay__QueryScrollOffset,
+#else
+        // A new context uses the same functions as the previous one until it is given its own
+        .measureTextFunction = oldContext ? oldContext->measureTextFunction : NULL,
+        .queryScrollOffsetFunction = oldContext ? oldContext->queryScrollOffsetFunction : NULL,
+#endif
+        .debugViewWidth = Clay__debugViewWidth,
+        .debugViewHighlightColor = Clay__debugViewHighlightColor,
         .internalArena = arena,
     };
     Clay_SetCurrentContext(context);
     Clay__InitializePersistentMemory(context);
     Clay__InitializeEphemeralMemory(context);
+    Clay__InitializePersistentTables(context);
     for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
         context->layoutElementsHashMap.internalArray[i] = -1;
     }
@@ -4068,7 +6326,7 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
 
 CLAY_WASM_EXPORT("Clay_GetCurrentContext")
 Clay_Context* Clay_GetCurrentContext(void) {
-    return Clay__currentContext;
+    return Clay__explicitContext ? Clay__explicitContext : Clay__currentContext;
 }
 
 CLAY_WASM_EXPORT("Clay_SetCurrentContext")
@@ -4076,6 +6334,83 @@ void Clay_SetCurrentContext(Clay_Context* context) {
     Clay__currentContext = context;
 }
 
+CLAY_WASM_EXPORT("Clay_SetLayoutDimensionsCtx")
+void Clay_SetLayoutDimensionsCtx(Clay_Context* context, Clay_Dimensions dimensions) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_SetLayoutDimensions(dimensions);
+    Clay__explicitContext = previousContext;
+}
+
+CLAY_WASM_EXPORT("Clay_SetPointerStateCtx")
+void Clay_SetPointerStateCtx(Clay_Context* context, Clay_Vector2 position, bool pointerDown) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_SetPointerState(position, pointerDown);
+    Clay__explicitContext = previousContext;
+}
+
+CLAY_WASM_EXPORT("Clay_UpdateScrollContainersCtx")
+void Clay_UpdateScrollContainersCtx(Clay_Context* context, bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_UpdateScrollContainers(enableDragScrolling, scrollDelta, deltaTime);
+    Clay__explicitContext = previousContext;
+}
+
+// The context stays in use on this thread for the declarations that follow, until Clay_EndLayoutCtx()
+CLAY_WASM_EXPORT("Clay_BeginLayoutCtx")
+void Clay_BeginLayoutCtx(Clay_Context* context) {
+    context->contextBeforeLayout = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_BeginLayout();
+}
+
+CLAY_WASM_EXPORT("Clay_EndLayoutCtx")
+Clay_RenderCommandArray Clay_EndLayoutCtx(Clay_Context* context) {
+    Clay__explicitContext = context;
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+    Clay__explicitContext = context->contextBeforeLayout;
+    context->contextBeforeLayout = NULL;
+    return renderCommands;
+}
+
+CLAY_WASM_EXPORT("Clay_GetElementDataCtx")
+Clay_ElementData Clay_GetElementDataCtx(Clay_Context* context, Clay_ElementId id) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_ElementData elementData = Clay_GetElementData(id);
+    Clay__explicitContext = previousContext;
+    return elementData;
+}
+
+CLAY_WASM_EXPORT("Clay_PointerOverCtx")
+bool Clay_PointerOverCtx(Clay_Context* context, Clay_ElementId elementId) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    bool pointerOver = Clay_PointerOver(elementId);
+    Clay__explicitContext = previousContext;
+    return pointerOver;
+}
+
+CLAY_WASM_EXPORT("Clay_GetScrollContainerDataCtx")
+Clay_ScrollContainerData Clay_GetScrollContainerDataCtx(Clay_Context* context, Clay_ElementId id) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_ScrollContainerData scrollContainerData = Clay_GetScrollContainerData(id);
+    Clay__explicitContext = previousContext;
+    return scrollContainerData;
+}
+
+CLAY_WASM_EXPORT("Clay_AcquireFrameCtx")
+Clay_Frame Clay_AcquireFrameCtx(Clay_Context* context) {
+    Clay_Context* previousContext = Clay__explicitContext;
+    Clay__explicitContext = context;
+    Clay_Frame frame = Clay_AcquireFrame();
+    Clay__explicitContext = previousContext;
+    return frame;
+}
+
 CLAY_WASM_EXPORT("Clay_GetScrollOffset")
 Clay_Vector2 Clay_GetScrollOffset(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4096,6 +6431,248 @@ Clay_Vector2 Clay_GetScrollOffset(void) {
     return CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
 }
 
+float Clay__GetVirtualListItemOffset(Clay_VirtualListConfig *config, float childGap, int32_t itemIndex) {
+    if (config->getItemOffset) {
+        return config->getItemOffset(itemIndex, config->userData);
+    }
+    return (float)itemIndex * (config->itemExtent + childGap);
+}
+
+// Returns the first item index in [low, high] whose edge is greater than target, where an item's edge is its start if useItemEnd is false, or its end if true
+int32_t Clay__FindVirtualListItem(Clay_VirtualListConfig *config, float childGap, int32_t low, int32_t high, float target, bool useItemEnd) {
+    while (low < high) {
+        int32_t middle = low + (high - low) / 2;
+        float edge = useItemEnd ? Clay__GetVirtualListItemOffset(config, childGap, middle + 1) - childGap : Clay__GetVirtualListItemOffset(config, childGap, middle);
+        if (edge > target) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+CLAY_WASM_EXPORT("Clay_GetVirtualListRange")
+Clay_VirtualListRange Clay_GetVirtualListRange(Clay_VirtualListConfig config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded || config.itemCount <= 0) {
+        return CLAY__INIT(Clay_VirtualListRange) CLAY__DEFAULT_STRUCT;
+    }
+    Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
+    // If the element has no id attached at this point, we need to generate one
+    if (openLayoutElement->id == 0) {
+        Clay__GenerateIdForAnonymousElement(openLayoutElement);
+    }
+    Clay_LayoutConfig *layoutConfig = openLayoutElement->layoutConfig;
+    bool vertical = layoutConfig->layoutDirection == CLAY_TOP_TO_BOTTOM;
+    float childGap = (float)layoutConfig->childGap;
+    Clay_BoundingBox boundingBox = Clay__GetHashMapItem(openLayoutElement->id)->boundingBox;
+    float viewportExtent = vertical ? boundingBox.height : boundingBox.width;
+    // The container hasn't been laid out yet, assume it could be as large as the layout
+    if (viewportExtent <= 0) {
+        viewportExtent = vertical ? context->layoutDimensions.height : context->layoutDimensions.width;
+    }
+    float visibleStart = -(float)(vertical ? layoutConfig->padding.top : layoutConfig->padding.left);
+    Clay_ClipElementConfig *clipConfig = Clay__FindElementConfigWithType(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+    if (clipConfig) {
+        visibleStart -= vertical ? clipConfig->childOffset.y : clipConfig->childOffset.x;
+    }
+
+    Clay_VirtualListRange range = CLAY__DEFAULT_STRUCT;
+    range.startIndex = Clay__FindVirtualListItem(&config, childGap, 0, config.itemCount, visibleStart, true);
+    range.endIndex = Clay__FindVirtualListItem(&config, childGap, range.startIndex, config.itemCount, visibleStart + viewportExtent, false);
+    range.startIndex = CLAY__MAX(range.startIndex - CLAY__MAX(config.overscan, 0), 0);
+    range.endIndex = CLAY__MIN(range.endIndex + CLAY__MAX(config.overscan, 0), config.itemCount);
+    if (range.startIndex > 0) {
+        range.leadingSpace = CLAY__MAX(Clay__GetVirtualListItemOffset(&config, childGap, range.startIndex) - childGap, 0);
+    }
+    if (range.endIndex < config.itemCount) {
+        range.trailingSpace = CLAY__MAX(Clay__GetVirtualListItemOffset(&config, childGap, config.itemCount) - Clay__GetVirtualListItemOffset(&config, childGap, range.endIndex) - childGap, 0);
+    }
+    return range;
+}
+
+#define CLAY__LARGE_TEXT_DEFAULT_BLOCK_SIZE 4096
+#define CLAY__LARGE_TEXT_MIN_BLOCK_SIZE 64
+// Until a block has been laid out at the current width, blocks are estimated to contain lines of this many bytes
+#define CLAY__LARGE_TEXT_ESTIMATED_LINE_BYTES 80
+
+// Blocks start after the first newline at or after their nominal start, so that wrapping a block produces the same lines as wrapping the
+// whole text would. A line longer than a block is split after a space, or failing that at the nominal start of the block.
+int32_t Clay__LargeTextBlockStart(Clay_String *text, int32_t blockSize, int32_t blockIndex) {
+    int64_t nominalStart = (int64_t)blockIndex * blockSize;
+    if (blockIndex == 0 || nominalStart >= text->length) {
+        return blockIndex == 0 ? 0 : text->length;
+    }
+    int32_t scanEnd = (int32_t)CLAY__MIN(nominalStart + blockSize, (int64_t)text->length);
+    for (int32_t i = (int32_t)nominalStart; i < scanEnd; ++i) {
+        if (text->chars[i - 1] == '\n') {
+            return i;
+        }
+    }
+    for (int32_t i = (int32_t)nominalStart; i < scanEnd; ++i) {
+        if (text->chars[i - 1] == ' ') {
+            return i;
+        }
+    }
+    // Don't split a UTF-8 sequence
+    int32_t start = (int32_t)nominalStart;
+    while (start < text->length && (text->chars[start] & 0xC0) == 0x80) {
+        start++;
+    }
+    return start;
+}
+
+float Clay__LargeTextBlockHeight(Clay_LargeTextState *state, int32_t blockIndex, float width, float heightPerByte, int32_t blockSize, int32_t textLength) {
+    Clay_LargeTextBlock *block = &state->blocks[blockIndex];
+    if (block->width == width && width > 0) {
+        return block->height;
+    }
+    return (float)(CLAY__MIN((int64_t)(blockIndex + 1) * blockSize, (int64_t)textLength) - (int64_t)blockIndex * blockSize) * heightPerByte;
+}
+
+void Clay__OpenLargeTextElement(Clay_ElementId id, Clay_String text, Clay_TextElementConfig *textConfig, Clay_LargeTextState *state) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded || !state->blocks || state->blockCapacity <= 0) {
+        return;
+    }
+    int32_t blockSize = CLAY__MAX(state->blockSize > 0 ? state->blockSize : CLAY__LARGE_TEXT_DEFAULT_BLOCK_SIZE, CLAY__LARGE_TEXT_MIN_BLOCK_SIZE);
+    blockSize = CLAY__MAX(blockSize, (int32_t)(((int64_t)text.length + state->blockCapacity - 1) / state->blockCapacity));
+    int32_t blockCount = (int32_t)(((int64_t)text.length + blockSize - 1) / blockSize);
+    // When the block size changes, the recorded heights and last frame's blocks no longer cover the same text as the blocks at their index
+    if (state->layoutBlockSize != blockSize) {
+        for (int32_t i = 0; i < state->blockCapacity; ++i) {
+            state->blocks[i] = CLAY__INIT(Clay_LargeTextBlock) { .height = 0, .width = 0 };
+        }
+        state->layoutBlockSize = blockSize;
+        state->declaredStartIndex = 0;
+        state->declaredEndIndex = 0;
+    }
+
+    // Everything is measured against the last frame's layout: the column holding the blocks, and the innermost clip container around it
+    Clay_LayoutElementHashMapItem *columnItem = Clay__GetHashMapItem(id.id);
+    bool columnWasDeclared = columnItem->generation == context->generation;
+    Clay_BoundingBox columnBox = columnWasDeclared ? columnItem->boundingBox : CLAY__INIT(Clay_BoundingBox) CLAY__DEFAULT_STRUCT;
+    Clay_BoundingBox clipBox = { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height };
+    Clay_ClipElementConfig *clipConfig = CLAY__NULL;
+    Clay__ScrollContainerDataInternal *scrollData = CLAY__NULL;
+    if (context->openClipElementStack.length > 0) {
+        uint32_t clipId = (uint32_t)Clay__int32_tArray_GetValue(&context->openClipElementStack, context->openClipElementStack.length - 1);
+        Clay_LayoutElementHashMapItem *clipItem = Clay__GetHashMapItem(clipId);
+        if (clipItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
+            clipConfig = Clay__FindElementConfigWithType(clipItem->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
+            if (clipItem->boundingBox.height > 0) {
+                clipBox = clipItem->boundingBox;
+            }
+        }
+        for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
+            if (context->scrollContainerDatas.internalArray[i].elementId == clipId) {
+                scrollData = &context->scrollContainerDatas.internalArray[i];
+            }
+        }
+    }
+
+    // Blocks are identified by their index, with a seed that differs from the IDs generated for the column's anonymous children
+    uint32_t blockIdSeed = Clay__HashString(CLAY_STRING("Clay__LargeTextBlock"), id.id).id;
+    // Blocks declared last frame have now been wrapped, so their heights are recorded at the width they were wrapped to
+    float width = columnBox.width;
+    float anchorLaidOutOffset = -1;
+    for (int32_t i = state->declaredStartIndex; columnWasDeclared && i < CLAY__MIN(state->declaredEndIndex, blockCount); ++i) {
+        Clay_LayoutElementHashMapItem *blockItem = Clay__GetHashMapItem(Clay__HashNumber((uint32_t)i, blockIdSeed).id);
+        if (blockItem->generation == context->generation) {
+            state->blocks[i] = CLAY__INIT(Clay_LargeTextBlock) { .height = blockItem->boundingBox.height, .width = width };
+            if (i == state->anchorIndex) {
+                anchorLaidOutOffset = blockItem->boundingBox.y - columnBox.y;
+            }
+        }
+    }
+    float measuredHeight = 0;
+    int64_t measuredBytes = 0;
+    for (int32_t i = 0; i < blockCount; ++i) {
+        if (state->blocks[i].width == width && width > 0) {
+            measuredHeight += state->blocks[i].height;
+            measuredBytes += CLAY__MIN((int64_t)(i + 1) * blockSize, (int64_t)text.length) - (int64_t)i * blockSize;
+        }
+    }
+    float heightPerByte = measuredBytes > 0
+        ? measuredHeight / (float)measuredBytes
+        : (textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : (float)textConfig->fontSize) / CLAY__LARGE_TEXT_ESTIMATED_LINE_BYTES;
+
+    // When the heights above the first visible block change, the scroll position is moved by the same amount so that it stays in place
+    float childOffset = clipConfig ? clipConfig->childOffset.y : 0;
+    float blockOffset = 0;
+    if (anchorLaidOutOffset >= 0 && state->anchorIndex < blockCount) {
+        for (int32_t i = 0; i < state->anchorIndex; ++i) {
+            blockOffset += Clay__LargeTextBlockHeight(state, i, width, heightPerByte, blockSize, text.length);
+        }
+        float correction = blockOffset - anchorLaidOutOffset;
+        if (correction != 0 && clipConfig) {
+            childOffset -= correction;
+            clipConfig->childOffset.y = childOffset;
+            if (scrollData) {
+                scrollData->scrollPosition.y -= correction;
+                scrollData->scrollOrigin.y -= correction;
+            }
+            if (context->frameSkippingEnabled) {
+                context->frameHash = Clay__HashFrameFloat(context->frameHash, childOffset);
+            }
+        }
+    }
+
+    // The position of the column within the clip container's content doesn't change when scrolling
+    float contentOffset = columnWasDeclared ? columnBox.y - clipBox.y - state->childOffset : 0;
+    float visibleStart = -childOffset - contentOffset;
+    float visibleEnd = visibleStart + clipBox.height;
+    float prefetch = state->prefetch > 0 ? state->prefetch : clipBox.height;
+    int32_t startIndex = blockCount;
+    int32_t endIndex = blockCount;
+    int32_t anchorIndex = 0;
+    float leadingSpace = 0;
+    float trailingSpace = 0;
+    blockOffset = 0;
+    for (int32_t i = 0; i < blockCount; ++i) {
+        float blockHeight = Clay__LargeTextBlockHeight(state, i, width, heightPerByte, blockSize, text.length);
+        if (blockOffset + blockHeight <= visibleStart) {
+            anchorIndex = i + 1;
+        }
+        if (startIndex == blockCount && blockOffset + blockHeight > visibleStart - prefetch) {
+            startIndex = i;
+            leadingSpace = blockOffset;
+        }
+        if (endIndex == blockCount && blockOffset >= visibleEnd + prefetch) {
+            endIndex = i;
+        }
+        if (endIndex < blockCount) {
+            trailingSpace += blockHeight;
+        }
+        blockOffset += blockHeight;
+    }
+    state->declaredStartIndex = startIndex;
+    state->declaredEndIndex = endIndex;
+    state->anchorIndex = CLAY__MIN(CLAY__MAX(anchorIndex, startIndex), CLAY__MAX(endIndex - 1, 0));
+    state->childOffset = childOffset;
+
+    CLAY({ .id = id, .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+        if (leadingSpace > 0) {
+            CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(leadingSpace) } } }) {}
+        }
+        int32_t blockStart = Clay__LargeTextBlockStart(&text, blockSize, startIndex);
+        for (int32_t i = startIndex; i < endIndex; ++i) {
+            int32_t blockEnd = Clay__LargeTextBlockStart(&text, blockSize, i + 1);
+            Clay_String blockText = { .length = blockEnd - blockStart, .chars = text.chars + blockStart };
+            CLAY({ .id = Clay__HashNumber((uint32_t)i, blockIdSeed), .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) } } }) {
+                if (blockText.length > 0) {
+                    CLAY_TEXT(blockText, textConfig);
+                }
+            }
+            blockStart = blockEnd;
+        }
+        if (trailingSpace > 0) {
+            CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(trailingSpace) } } }) {}
+        }
+    }
+}
+
 CLAY_WASM_EXPORT("Clay_UpdateScrollContainers")
 void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4213,15 +6790,28 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
 CLAY_WASM_EXPORT("Clay_BeginLayout")
 void Clay_BeginLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
+    Clay__GrowInternalMemoryIfRequired(context);
+    context->droppedElementCount = 0;
     Clay__InitializeEphemeralMemory(context);
+    Clay__BeginFrameBuffer(context);
     context->generation++;
     context->dynamicElementIndex = 0;
     // Set up the root container that covers the entire window
     Clay_Dimensions rootDimensions = {context->layoutDimensions.width, context->layoutDimensions.height};
     if (context->debugModeEnabled) {
-        rootDimensions.width -= (float)Clay__debugViewWidth;
+        rootDimensions.width -= (float)context->debugViewWidth;
     }
     context->booleanWarnings = CLAY__INIT(Clay_BooleanWarnings) CLAY__DEFAULT_STRUCT;
+    if (context->frameSkippingEnabled) {
+        // Inputs other than the declarations that change the result of Clay_EndLayout()
+        uint64_t frameHash = Clay__HashFrameFloat(0x9e3779b97f4a7c15ULL, context->layoutDimensions.width);
+        frameHash = Clay__HashFrameFloat(frameHash, context->layoutDimensions.height);
+        frameHash = Clay__HashFrameValue(frameHash, (uint64_t)context->debugModeEnabled | ((uint64_t)context->disableCulling << 1) | ((uint64_t)context->occlusionCullingEnabled << 2)
+            | ((uint64_t)context->drawBatchingEnabled << 3) | ((uint64_t)context->externalScrollHandlingEnabled << 4));
+        frameHash = Clay__HashFrameFloat(frameHash, context->pixelSnapGridSize.width);
+        frameHash = Clay__HashFrameFloat(frameHash, context->pixelSnapGridSize.height);
+        context->frameHash = frameHash;
+    }
     Clay__OpenElement();
     Clay__ConfigureOpenElement(CLAY__INIT(Clay_ElementDeclaration) {
             .id = CLAY_ID("Clay__RootContainer"),
@@ -4241,6 +6831,23 @@ Clay_RenderCommandArray Clay_EndLayout(void) {
         Clay__RenderDebugView();
         context->warningsEnabled = true;
     }
+    bool frameUnchanged = context->frameSkippingEnabled && !context->booleanWarnings.maxElementsExceeded
+        && context->previousFrameHash != 0 && context->frameHash == context->previousFrameHash && context->outputFrameBufferIndex != -1;
+    context->previousFrameHash = context->frameSkippingEnabled && !context->booleanWarnings.maxElementsExceeded ? context->frameHash : 0;
+    context->frameUnchanged = frameUnchanged;
+    if (frameUnchanged) {
+        // The render commands and draw batches from the previous frame are still current. Only the state that
+        // Clay__CalculateFinalLayout leaves behind for the next frame's pointer and scroll handling is restored.
+        Clay__SortTreeRootsByZIndex();
+        for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
+            Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+            if (scrollData->openThisFrame) {
+                scrollData->layoutElement->dimensions = scrollData->elementDimensions;
+            }
+        }
+        Clay__UseFrameBuffer(context, context->outputFrameBufferIndex);
+        return context->renderCommands;
+    }
     if (context->booleanWarnings.maxElementsExceeded) {
         Clay_String message;
         if (!elementsExceededBeforeDebugView) {
@@ -4255,10 +6862,370 @@ Clay_RenderCommandArray Clay_EndLayout(void) {
         });
     } else {
         Clay__CalculateFinalLayout();
+        if (context->occlusionCullingEnabled) {
+            Clay__CullOccludedRenderCommands();
+        }
+        if (context->drawBatchingEnabled) {
+            Clay__PlanDrawBatches();
+        }
+    }
+    Clay__EndFrameBuffer(context);
+    return context->renderCommands;
+}
+
+CLAY_WASM_EXPORT("Clay_BeginMeasure")
+void Clay_BeginMeasure(Clay_Dimensions availableSize) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->measuring) {
+        return;
+    }
+    int32_t openElementIndex = context->openLayoutElementStack.length > 0 ? Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1) : -1;
+    context->measureState = CLAY__INIT(Clay__MeasureState) {
+        .layoutElements = context->layoutElements.length,
+        .openLayoutElementStack = context->openLayoutElementStack.length,
+        .openClipElementStack = context->openClipElementStack.length,
+        .layoutElementChildren = context->layoutElementChildren.length,
+        .layoutElementChildrenBuffer = context->layoutElementChildrenBuffer.length,
+        .textElementData = context->textElementData.length,
+        .aspectRatioElementIndexes = context->aspectRatioElementIndexes.length,
+        .layoutConfigs = context->layoutConfigs.length,
+        .elementConfigs = context->elementConfigs.length,
+        .textElementConfigs = context->textElementConfigs.length,
+        .aspectRatioElementConfigs = context->aspectRatioElementConfigs.length,
+        .imageElementConfigs = context->imageElementConfigs.length,
+        .floatingElementConfigs = context->floatingElementConfigs.length,
+        .clipElementConfigs = context->clipElementConfigs.length,
+        .customElementConfigs = context->customElementConfigs.length,
+        .borderElementConfigs = context->borderElementConfigs.length,
+        .layerElementConfigs = context->layerElementConfigs.length,
+        .sharedElementConfigs = context->sharedElementConfigs.length,
+        .layoutElementIdStrings = context->layoutElementIdStrings.length,
+        .wrappedTextLines = context->wrappedTextLines.length,
+        .layoutElementTreeRoots = context->layoutElementTreeRoots.length,
+        .openElementIndex = openElementIndex,
+        .openElementChildCount = openElementIndex >= 0 ? Clay_LayoutElementArray_Get(&context->layoutElements, openElementIndex)->childrenOrTextContent.children.length : 0,
+        .frameHash = context->frameHash,
+        .configInterningEnabled = context->configInterningEnabled,
+    };
+    context->measuring = true;
+    // Interned configs could be shared with elements declared after the measured ones are discarded
+    context->configInterningEnabled = false;
+    Clay__OpenElement();
+    Clay__ConfigureOpenElement(CLAY__INIT(Clay_ElementDeclaration) {
+        .id = CLAY_ID("Clay__MeasureContainer"),
+        .layout = { .sizing = { CLAY_SIZING_FIT(0, availableSize.width), CLAY_SIZING_FIT(0, availableSize.height) } }
+    });
+    Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) { .layoutElementIndex = context->measureState.layoutElements });
+}
+
+CLAY_WASM_EXPORT("Clay_EndMeasure")
+Clay_Dimensions Clay_EndMeasure(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
+    if (!context->measuring) {
+        return dimensions;
+    }
+    Clay__MeasureState *state = &context->measureState;
+    Clay__CloseElement();
+    if (!context->booleanWarnings.maxElementsExceeded) {
+        Clay__SizeLayout(context, state->layoutElementTreeRoots, state->textElementData, state->aspectRatioElementIndexes);
+        dimensions = Clay_LayoutElementArray_Get(&context->layoutElements, state->layoutElements)->dimensions;
+    }
+    // Discard the measured elements
+    if (state->openElementIndex >= 0) {
+        Clay_LayoutElementArray_Get(&context->layoutElements, state->openElementIndex)->childrenOrTextContent.children.length = state->openElementChildCount;
+    }
+    context->layoutElements.length = state->layoutElements;
+    context->openLayoutElementStack.length = state->openLayoutElementStack;
+    context->openClipElementStack.length = state->openClipElementStack;
+    context->layoutElementChildren.length = state->layoutElementChildren;
+    context->layoutElementChildrenBuffer.length = state->layoutElementChildrenBuffer;
+    context->textElementData.length = state->textElementData;
+    context->aspectRatioElementIndexes.length = state->aspectRatioElementIndexes;
+    context->layoutConfigs.length = state->layoutConfigs;
+    context->elementConfigs.length = state->elementConfigs;
+    context->textElementConfigs.length = state->textElementConfigs;
+    context->aspectRatioElementConfigs.length = state->aspectRatioElementConfigs;
+    context->imageElementConfigs.length = state->imageElementConfigs;
+    context->floatingElementConfigs.length = state->floatingElementConfigs;
+    context->clipElementConfigs.length = state->clipElementConfigs;
+    context->customElementConfigs.length = state->customElementConfigs;
+    context->borderElementConfigs.length = state->borderElementConfigs;
+    context->layerElementConfigs.length = state->layerElementConfigs;
+    context->sharedElementConfigs.length = state->sharedElementConfigs;
+    context->layoutElementIdStrings.length = state->layoutElementIdStrings;
+    context->wrappedTextLines.length = state->wrappedTextLines;
+    context->layoutElementTreeRoots.length = state->layoutElementTreeRoots;
+    context->frameHash = state->frameHash;
+    context->configInterningEnabled = state->configInterningEnabled;
+    context->measuring = false;
+    return dimensions;
+}
+
+CLAY_WASM_EXPORT("Clay_SetFloatingElementOffset")
+void Clay_SetFloatingElementOffset(Clay_ElementId id, Clay_Vector2 offset) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElementHashMapItem *item = Clay__GetHashMapItem(id.id);
+    // The element must have been declared in the last layout, and no layout can be in progress (the root stays on the open element stack after it is closed)
+    if (item == &Clay_LayoutElementHashMapItem_DEFAULT || item->generation != context->generation + 1 || context->openLayoutElementStack.length > 1) {
+        return;
+    }
+    int32_t elementIndex = (int32_t)(item->layoutElement - context->layoutElements.internalArray);
+    for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
+        if (root->layoutElementIndex == elementIndex && Clay__ElementHasConfig(item->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+            Clay__FindElementConfigWithType(item->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig->offset = offset;
+            root->moved = true;
+            return;
+        }
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_UpdateFloatingElements")
+Clay_RenderCommandArray Clay_UpdateFloatingElements(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->openLayoutElementStack.length > 1 || context->outputFrameBufferIndex == -1 || context->booleanWarnings.maxElementsExceeded) {
+        return context->renderCommands;
+    }
+    // Floating elements attached to an element inside a moved tree move with it
+    bool anyMoved = false;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
+            Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
+            anyMoved = anyMoved || root->moved;
+            Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(root->parentId);
+            if (root->moved || parentItem == &Clay_LayoutElementHashMapItem_DEFAULT) {
+                continue;
+            }
+            int32_t parentIndex = (int32_t)(parentItem->layoutElement - context->layoutElements.internalArray);
+            for (int32_t j = 0; j < context->layoutElementTreeRoots.length; ++j) {
+                Clay__LayoutElementTreeRoot *movedRoot = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, j);
+                if (movedRoot->moved && parentIndex >= movedRoot->layoutElementIndex && parentIndex < movedRoot->layoutElementIndex + context->layoutElementSubtreeSizes.internalArray[movedRoot->layoutElementIndex]) {
+                    root->moved = true;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    if (!anyMoved) {
+        return context->renderCommands;
+    }
+    // An unchanged frame skipped the sizing passes, and commands from the other post processing passes can't be reused,
+    // so in those cases every tree is positioned again
+    bool positionAllTrees = context->frameUnchanged || context->occlusionCullingEnabled || context->drawBatchingEnabled;
+    if (context->frameUnchanged) {
+        Clay__SizeLayout(context, 0, 0, 0);
+        context->frameUnchanged = false;
+    }
+    Clay_RenderCommandArray previousRenderCommands = context->renderCommands;
+    Clay__charArray previousStringData = context->dynamicStringData;
+    int32_t previousFrameBufferIndex = context->frameBufferIndex;
+    // The output goes to a new frame buffer, so that the previous output stays intact if it has been acquired
+    Clay__BeginFrameBuffer(context);
+    // Unless both are the scratch buffer, in which case the previous commands are overwritten as they are read
+    positionAllTrees = positionAllTrees || context->frameBufferIndex == previousFrameBufferIndex;
+    for (int32_t i = 0; i < previousStringData.length; ++i) {
+        context->dynamicStringData.internalArray[i] = previousStringData.internalArray[i];
+    }
+    context->dynamicStringData.length = previousStringData.length;
+    for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
+        int32_t renderCommandStart = context->renderCommands.length;
+        if (root->moved || positionAllTrees) {
+            Clay__PositionTree(context, root);
+        } else {
+            for (int32_t j = 0; j < root->renderCommandCount; ++j) {
+                Clay__AddRenderCommand(previousRenderCommands.internalArray[root->renderCommandStart + j]);
+            }
+        }
+        root->renderCommandStart = renderCommandStart;
+        root->renderCommandCount = context->renderCommands.length - renderCommandStart;
+        root->moved = false;
+    }
+    // Text generated during the layout was copied along with the commands, so point the commands at the copy
+    for (int32_t i = 0; i < context->renderCommands.length; ++i) {
+        Clay_TextRenderData *text = &context->renderCommands.internalArray[i].renderData.text;
+        if (context->renderCommands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_TEXT && text->stringContents.baseChars >= previousStringData.internalArray && text->stringContents.baseChars < previousStringData.internalArray + previousStringData.length) {
+            text->stringContents.chars = context->dynamicStringData.internalArray + (text->stringContents.chars - previousStringData.internalArray);
+            text->stringContents.baseChars = context->dynamicStringData.internalArray + (text->stringContents.baseChars - previousStringData.internalArray);
+        }
     }
+    if (context->occlusionCullingEnabled) {
+        Clay__CullOccludedRenderCommands();
+    }
+    if (context->drawBatchingEnabled) {
+        Clay__PlanDrawBatches();
+    }
+    Clay__EndFrameBuffer(context);
+    // The output no longer matches the declarations of the last layout, so the next layout can't be skipped
+    context->previousFrameHash = 0;
     return context->renderCommands;
 }
 
+CLAY_WASM_EXPORT("Clay_FrameAllocString")
+Clay_String Clay_FrameAllocString(Clay_String string) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t start = context->dynamicStringData.length;
+    Clay__FrameStringAppend(&context->dynamicStringData, string.chars, string.length);
+    return Clay__EndFrameString(context, start);
+}
+
+Clay_String Clay_FrameFormat(const char *format, ...) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__charArray *buffer = &context->dynamicStringData;
+    int32_t start = buffer->length;
+    va_list args;
+    va_start(args, format);
+    for (const char *c = format; *c; ++c) {
+        const char *literal = c;
+        while (*c && *c != '%') {
+            ++c;
+        }
+        Clay__FrameStringAppend(buffer, literal, (int32_t)(c - literal));
+        if (!*c) {
+            break;
+        }
+        const char *specifier = c++;
+        bool leftAlign = false, zeroPad = false, plusSign = false, spaceSign = false, alternateForm = false;
+        for (;; ++c) {
+            if (*c == '-') { leftAlign = true; }
+            else if (*c == '0') { zeroPad = true; }
+            else if (*c == '+') { plusSign = true; }
+            else if (*c == ' ') { spaceSign = true; }
+            else if (*c == '#') { alternateForm = true; }
+            else { break; }
+        }
+        int32_t width = 0;
+        if (*c == '*') {
+            width = va_arg(args, int);
+            if (width < 0) {
+                leftAlign = true;
+                width = -width;
+            }
+            ++c;
+        } else {
+            while (*c >= '0' && *c <= '9') {
+                width = width * 10 + (*c++ - '0');
+            }
+        }
+        int32_t precision = -1;
+        if (*c == '.') {
+            ++c;
+            if (*c == '*') {
+                // A negative precision is taken as if it had been omitted
+                int32_t argument = va_arg(args, int);
+                precision = argument < 0 ? -1 : argument;
+                ++c;
+            } else {
+                precision = 0;
+                while (*c >= '0' && *c <= '9') {
+                    precision = precision * 10 + (*c++ - '0');
+                }
+            }
+        }
+        // Length modifiers only change the type the argument is read as. hh is stored as 'H' and ll as 'q'
+        char length = 0;
+        if (*c == 'h' || *c == 'l') {
+            length = *c++;
+            if (*c == length) {
+                length = length == 'h' ? 'H' : 'q';
+                ++c;
+            }
+        } else if (*c == 'z' || *c == 'j' || *c == 't' || *c == 'L') {
+            length = *c++;
+        }
+        char body[CLAY__FORMAT_FLOAT_CAPACITY];
+        const char *signPrefix = plusSign ? "+" : spaceSign ? " " : "";
+        switch (*c) {
+            case 'd': case 'i': {
+                int64_t value = Clay__FrameFormatSignedArgument(&args, length);
+                // A precision gives the minimum number of digits, and a value of 0 with a precision of 0 is written without any
+                int32_t bodyLength = value == 0 && precision == 0 ? 0 : Clay__FormatDigits(body, value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value, 10, false, 1);
+                Clay__FrameStringAppendPadded(buffer, value < 0 ? "-" : signPrefix, CLAY__MAX(precision - bodyLength, 0), body, bodyLength, 0, width, leftAlign, zeroPad && precision < 0);
+                break;
+            }
+            case 'u': case 'x': case 'X': case 'o': {
+                uint64_t value = Clay__FrameFormatUnsignedArgument(&args, length);
+                uint32_t base = *c == 'u' ? 10 : *c == 'o' ? 8 : 16;
+                int32_t bodyLength = value == 0 && precision == 0 ? 0 : Clay__FormatDigits(body, value, base, *c == 'X', 1);
+                int32_t leadingZeros = CLAY__MAX(precision - bodyLength, 0);
+                // The alternate form of %o makes sure the first digit is a 0
+                if (alternateForm && *c == 'o' && leadingZeros == 0 && (bodyLength == 0 || body[0] != '0')) {
+                    leadingZeros = 1;
+                }
+                const char *prefix = !alternateForm || value == 0 ? "" : *c == 'x' ? "0x" : *c == 'X' ? "0X" : "";
+                Clay__FrameStringAppendPadded(buffer, prefix, leadingZeros, body, bodyLength, 0, width, leftAlign, zeroPad && precision < 0);
+                break;
+            }
+            case 'p': {
+                int32_t bodyLength = Clay__FormatDigits(body, (uint64_t)(uintptr_t)va_arg(args, void *), 16, false, 1);
+                Clay__FrameStringAppendPadded(buffer, "0x", 0, body, bodyLength, 0, width, leftAlign, zeroPad);
+                break;
+            }
+            case 'f': case 'F': {
+                double value = length == 'L' ? (double)va_arg(args, long double) : va_arg(args, double);
+                uint64_t bits = Clay__DoubleBits(value);
+                // The sign is taken from the sign bit, so that -0.0 and negative values that round to zero keep their minus sign
+                const char *prefix = bits >> 63 ? "-" : signPrefix;
+                int32_t bodyLength;
+                if (((bits >> 52) & 0x7ff) == 0x7ff) {
+                    // Infinities and NaN are written as words, and never padded with zeros
+                    bool isNan = (bits & 0xfffffffffffffULL) != 0;
+                    const char *word = isNan ? (*c == 'F' ? "NAN" : "nan") : (*c == 'F' ? "INF" : "inf");
+                    for (bodyLength = 0; bodyLength < 3; ++bodyLength) {
+                        body[bodyLength] = word[bodyLength];
+                    }
+                    Clay__FrameStringAppendPadded(buffer, prefix, 0, body, bodyLength, 0, width, leftAlign, false);
+                    break;
+                }
+                int32_t decimals = precision < 0 ? 6 : precision;
+                int32_t trailingZeros;
+                bodyLength = Clay__FormatFloat(body, bits, decimals, decimals > 0 || alternateForm, &trailingZeros);
+                Clay__FrameStringAppendPadded(buffer, prefix, 0, body, bodyLength, trailingZeros, width, leftAlign, zeroPad);
+                break;
+            }
+            // Other floating point conversions aren't supported, but their argument is still consumed so that the following ones line up
+            case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                if (length == 'L') {
+                    (void)va_arg(args, long double);
+                } else {
+                    (void)va_arg(args, double);
+                }
+                Clay__FrameStringAppend(buffer, specifier, (int32_t)(c - specifier) + 1);
+                break;
+            }
+            case 'c': {
+                body[0] = (char)va_arg(args, int);
+                Clay__FrameStringAppendPadded(buffer, "", 0, body, 1, 0, width, leftAlign, false);
+                break;
+            }
+            case 's': {
+                const char *chars = va_arg(args, const char *);
+                chars = chars ? chars : "(null)";
+                int32_t stringLength = 0;
+                while ((precision < 0 || stringLength < precision) && chars[stringLength]) {
+                    stringLength++;
+                }
+                Clay__FrameStringAppendPadded(buffer, "", 0, chars, stringLength, 0, width, leftAlign, false);
+                break;
+            }
+            case '%': Clay__FrameStringAppend(buffer, "%", 1); break;
+            // Unsupported specifiers are written as they are
+            default: {
+                Clay__FrameStringAppend(buffer, specifier, (int32_t)(c - specifier) + (*c ? 1 : 0));
+                break;
+            }
+        }
+        if (!*c) {
+            break;
+        }
+    }
+    va_end(args);
+    return Clay__EndFrameString(context, start);
+}
+
 CLAY_WASM_EXPORT("Clay_GetElementId")
 Clay_ElementId Clay_GetElementId(Clay_String idString) {
     return Clay__HashString(idString, 0);
@@ -4271,7 +7238,8 @@ Clay_ElementId Clay_GetElementIdWithIndex(Clay_String idString, uint32_t index)
 
 bool Clay_Hovered(void) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->booleanWarnings.maxElementsExceeded) {
+    // Elements declared while measuring aren't registered, and are never hovered
+    if (context->booleanWarnings.maxElementsExceeded || context->measuring) {
         return false;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
@@ -4289,7 +7257,8 @@ bool Clay_Hovered(void) {
 
 void Clay_OnHover(void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData), intptr_t userData) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->booleanWarnings.maxElementsExceeded) {
+    // Elements declared while measuring have no hash map item to attach the function to
+    if (context->booleanWarnings.maxElementsExceeded || context->measuring) {
         return;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
@@ -4365,12 +7334,95 @@ void Clay_SetCullingEnabled(bool enabled) {
     context->disableCulling = !enabled;
 }
 
+CLAY_WASM_EXPORT("Clay_SetPixelSnapping")
+void Clay_SetPixelSnapping(Clay_Dimensions gridSize) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->pixelSnapGridSize = gridSize;
+}
+
+CLAY_WASM_EXPORT("Clay_SetConfigInterningEnabled")
+void Clay_SetConfigInterningEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->configInterningEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_SetDrawBatchingEnabled")
+void Clay_SetDrawBatchingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->drawBatchingEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_GetDrawBatches")
+Clay_DrawBatchArray Clay_GetDrawBatches(void) {
+    return Clay_GetCurrentContext()->drawBatches;
+}
+
+CLAY_WASM_EXPORT("Clay_SetOcclusionCullingEnabled")
+void Clay_SetOcclusionCullingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->occlusionCullingEnabled = enabled;
+}
+
 CLAY_WASM_EXPORT("Clay_SetExternalScrollHandlingEnabled")
 void Clay_SetExternalScrollHandlingEnabled(bool enabled) {
     Clay_Context* context = Clay_GetCurrentContext();
     context->externalScrollHandlingEnabled = enabled;
 }
 
+CLAY_WASM_EXPORT("Clay_SetFrameSkippingEnabled")
+void Clay_SetFrameSkippingEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->frameSkippingEnabled = enabled;
+}
+
+CLAY_WASM_EXPORT("Clay_IsFrameUnchanged")
+bool Clay_IsFrameUnchanged(void) {
+    return Clay_GetCurrentContext()->frameUnchanged;
+}
+
+CLAY_WASM_EXPORT("Clay_AcquireFrame")
+Clay_Frame Clay_AcquireFrame(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // The output is in the scratch buffer when every frame buffer was in use
+    if (context->outputFrameBufferIndex == -1 || context->frameBufferIndex != context->outputFrameBufferIndex) {
+        return CLAY__INIT(Clay_Frame) { .frameBufferIndex = -1 };
+    }
+    CLAY__ATOMIC_ADD(&context->frameBuffers.internalArray[context->outputFrameBufferIndex].acquireCount, 1);
+    return CLAY__INIT(Clay_Frame) {
+        .renderCommands = context->renderCommands,
+        .drawBatches = context->drawBatches,
+        .context = context,
+        .frameBufferIndex = context->outputFrameBufferIndex,
+    };
+}
+
+CLAY_WASM_EXPORT("Clay_ReleaseFrame")
+void Clay_ReleaseFrame(Clay_Frame frame) {
+    if (!frame.context || frame.frameBufferIndex < 0) {
+        return;
+    }
+    CLAY__ATOMIC_ADD(&frame.context->frameBuffers.internalArray[frame.frameBufferIndex].acquireCount, -1);
+}
+
+CLAY_WASM_EXPORT("Clay_GetFrameBufferCount")
+int32_t Clay_GetFrameBufferCount(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->frameBufferCount;
+}
+
+CLAY_WASM_EXPORT("Clay_SetFrameBufferCount")
+void Clay_SetFrameBufferCount(int32_t frameBufferCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    frameBufferCount = CLAY__MAX(frameBufferCount, 2);
+    if (context && context->allocator.allocateFunction) {
+        context->requestedFrameBufferCount = frameBufferCount;
+    } else if (context) {
+        context->frameBufferCount = frameBufferCount;
+    } else {
+        Clay__defaultFrameBufferCount = frameBufferCount;
+    }
+}
+
 CLAY_WASM_EXPORT("Clay_GetMaxElementCount")
 int32_t Clay_GetMaxElementCount(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4380,11 +7432,14 @@ int32_t Clay_GetMaxElementCount(void) {
 CLAY_WASM_EXPORT("Clay_SetMaxElementCount")
 void Clay_SetMaxElementCount(int32_t maxElementCount) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context) {
+    if (context && context->allocator.allocateFunction) {
+        context->requestedMaxElementCount = maxElementCount;
+    } else if (context) {
         context->maxElementCount = maxElementCount;
     } else {
         Clay__defaultMaxElementCount = maxElementCount; // TODO: Fix this
         Clay__defaultMaxMeasureTextWordCacheCount = maxElementCount * 2;
+        Clay__defaultMaxWrappedTextLineCount = CLAY__MAX(Clay__defaultMaxWrappedTextLineCount, maxElementCount);
     }
 }
 
@@ -4397,13 +7452,78 @@ int32_t Clay_GetMaxMeasureTextCacheWordCount(void) {
 CLAY_WASM_EXPORT("Clay_SetMaxMeasureTextCacheWordCount")
 void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context) {
-        Clay__currentContext->maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    if (context && context->allocator.allocateFunction) {
+        context->requestedMaxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    } else if (context) {
+        context->maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
     } else {
         Clay__defaultMaxMeasureTextWordCacheCount = maxMeasureTextCacheWordCount; // TODO: Fix this
     }
 }
 
+CLAY_WASM_EXPORT("Clay_GetMaxWrappedTextLineCount")
+int32_t Clay_GetMaxWrappedTextLineCount(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->maxWrappedTextLineCount;
+}
+
+CLAY_WASM_EXPORT("Clay_SetMaxWrappedTextLineCount")
+void Clay_SetMaxWrappedTextLineCount(int32_t maxWrappedTextLineCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context && context->allocator.allocateFunction) {
+        context->requestedMaxWrappedTextLineCount = maxWrappedTextLineCount;
+    } else if (context) {
+        context->maxWrappedTextLineCount = maxWrappedTextLineCount;
+    } else {
+        Clay__defaultMaxWrappedTextLineCount = maxWrappedTextLineCount;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_GetFrameStringCapacity")
+int32_t Clay_GetFrameStringCapacity(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context->frameStringCapacity;
+}
+
+CLAY_WASM_EXPORT("Clay_SetFrameStringCapacity")
+void Clay_SetFrameStringCapacity(int32_t frameStringCapacity) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context && context->allocator.allocateFunction) {
+        context->requestedFrameStringCapacity = frameStringCapacity;
+    } else if (context) {
+        context->frameStringCapacity = frameStringCapacity;
+    } else {
+        Clay__defaultFrameStringCapacity = frameStringCapacity;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_SetAllocator")
+void Clay_SetAllocator(Clay_Allocator allocator) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->allocator = allocator;
+}
+
+void Clay_SetParallelExecutor(Clay_ParallelExecutor executor) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->parallelExecutor = executor;
+}
+
+CLAY_WASM_EXPORT("Clay_ReportTextEdit")
+void Clay_ReportTextEdit(Clay_EditableTextState *state, int32_t offset, int32_t removedLength, int32_t insertedLength) {
+    if (state->editStart == state->editRemovedEnd && state->editStart == state->editInsertedEnd) {
+        state->editStart = offset;
+        state->editRemovedEnd = offset + removedLength;
+        state->editInsertedEnd = offset + insertedLength;
+        return;
+    }
+    // Merge the edits into one changed region. Text after the region is at the same offset before the edits as after them, minus the
+    // difference between editInsertedEnd and editRemovedEnd.
+    int32_t editEnd = offset + removedLength;
+    state->editRemovedEnd += CLAY__MAX(editEnd - state->editInsertedEnd, 0);
+    state->editInsertedEnd = CLAY__MAX(editEnd, state->editInsertedEnd) + insertedLength - removedLength;
+    state->editStart = CLAY__MIN(offset, state->editStart);
+}
+
 CLAY_WASM_EXPORT("Clay_ResetMeasureTextCache")
 void Clay_ResetMeasureTextCache(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4417,6 +7537,8 @@ void Clay_ResetMeasureTextCache(void) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    // Text may measure differently from now on
+    context->previousFrameHash = 0;
 }
 
 #endif // CLAY_IMPLEMENTATION
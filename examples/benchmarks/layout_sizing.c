@@ -0,0 +1,63 @@
+// Times the declaration and layout of a flat 50k element tree of GROW and FIXED containers, which is dominated by the axis sizing passes.
+// Reports the best of FRAME_COUNT frames, as the minimum is the most stable measurement between runs.
+#define _POSIX_C_SOURCE 199309L
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define ROW_COUNT 500
+#define COLUMN_COUNT 98
+#define FRAME_COUNT 200
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+static double NowMs(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static void DeclareLayout(void) {
+    CLAY({ .id = CLAY_ID("Root"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+        for (int row = 0; row < ROW_COUNT; ++row) {
+            CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = CLAY_PADDING_ALL(2), .childGap = 1 } }) {
+                for (int column = 0; column < COLUMN_COUNT; ++column) {
+                    if (column % 3 == 0) {
+                        CLAY({ .layout = { .sizing = { CLAY_SIZING_FIXED(4), CLAY_SIZING_FIXED(4) } } }) {}
+                    } else {
+                        CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0, (float)(8 + column % 7)), CLAY_SIZING_GROW(0) } } }) {}
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(void) {
+    Clay_SetMaxElementCount(ROW_COUNT * (COLUMN_COUNT + 1) + 16);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1920, 1080 }, (Clay_ErrorHandler) { HandleClayErrors });
+
+    double bestDeclaration = 1e9, bestLayout = 1e9, bestFrame = 1e9;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        double start = NowMs();
+        Clay_BeginLayout();
+        DeclareLayout();
+        double declared = NowMs();
+        Clay_EndLayout();
+        double end = NowMs();
+        bestDeclaration = declared - start < bestDeclaration ? declared - start : bestDeclaration;
+        bestLayout = end - declared < bestLayout ? end - declared : bestLayout;
+        bestFrame = end - start < bestFrame ? end - start : bestFrame;
+    }
+    printf("%d elements, best of %d frames: declaration %.3f ms, Clay_EndLayout %.3f ms, full frame %.3f ms\n",
+        ROW_COUNT * (COLUMN_COUNT + 1) + 1, FRAME_COUNT, bestDeclaration, bestLayout, bestFrame);
+    return 0;
+}
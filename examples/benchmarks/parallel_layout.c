@@ -0,0 +1,172 @@
+// Times Clay_EndLayout on a long list of rows with wrapping text, first on a single thread and then with a parallel executor backed by
+// a pool of 2 to MAX_THREAD_COUNT threads, and reports the speedup over the single thread. Pass the largest thread count to try as the
+// first argument. Sizing and text wrapping are split into jobs, while positioning and render command generation stay on one thread,
+// so the speedup is limited by the share of the frame spent in those.
+#define _POSIX_C_SOURCE 199309L
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define ROW_COUNT 20000
+#define FRAME_COUNT 20
+#define MAX_THREAD_COUNT 64
+
+static const char *words = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor incididunt ut labore et dolore magna aliqua";
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+static Clay_Dimensions MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.55f, .height = (float)config->fontSize };
+}
+
+static double NowMs(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+// A minimal thread pool. The calling thread runs jobs too, and waits until every job of the batch has finished.
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t batchStarted;
+    pthread_cond_t batchFinished;
+    pthread_t threads[MAX_THREAD_COUNT];
+    int32_t threadCount;
+    int32_t batch;
+    int32_t nextJob;
+    int32_t jobCount;
+    int32_t jobsFinished;
+    void (*job)(int32_t jobIndex, void *jobData);
+    void *jobData;
+} ThreadPool;
+
+static void RunJobs(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->nextJob < pool->jobCount) {
+        int32_t jobIndex = pool->nextJob++;
+        pthread_mutex_unlock(&pool->mutex);
+        pool->job(jobIndex, pool->jobData);
+        pthread_mutex_lock(&pool->mutex);
+        if (++pool->jobsFinished == pool->jobCount) {
+            pthread_cond_broadcast(&pool->batchFinished);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void *RunWorker(void *data) {
+    ThreadPool *pool = (ThreadPool *)data;
+    int32_t batch = 0;
+    while (true) {
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->batch == batch) {
+            pthread_cond_wait(&pool->batchStarted, &pool->mutex);
+        }
+        batch = pool->batch;
+        pthread_mutex_unlock(&pool->mutex);
+        if (batch < 0) {
+            return NULL;
+        }
+        RunJobs(pool);
+    }
+}
+
+static void ParallelFor(int32_t jobCount, void (*job)(int32_t jobIndex, void *jobData), void *jobData, void *userData) {
+    ThreadPool *pool = (ThreadPool *)userData;
+    pthread_mutex_lock(&pool->mutex);
+    pool->job = job;
+    pool->jobData = jobData;
+    pool->jobCount = jobCount;
+    pool->nextJob = 0;
+    pool->jobsFinished = 0;
+    pool->batch++;
+    pthread_cond_broadcast(&pool->batchStarted);
+    pthread_mutex_unlock(&pool->mutex);
+    RunJobs(pool);
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->jobsFinished < pool->jobCount) {
+        pthread_cond_wait(&pool->batchFinished, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void StartThreadPool(ThreadPool *pool, int32_t threadCount) {
+    *pool = (ThreadPool) { .threadCount = threadCount - 1 };
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->batchStarted, NULL);
+    pthread_cond_init(&pool->batchFinished, NULL);
+    for (int32_t i = 0; i < pool->threadCount; ++i) {
+        pthread_create(&pool->threads[i], NULL, RunWorker, pool);
+    }
+}
+
+static void StopThreadPool(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->batch = -1;
+    pthread_cond_broadcast(&pool->batchStarted);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int32_t i = 0; i < pool->threadCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+static void DeclareLayout(void) {
+    CLAY({ .id = CLAY_ID("List"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 2 }, .clip = { .vertical = true } }) {
+        for (int32_t row = 0; row < ROW_COUNT; ++row) {
+            Clay_String text = { .length = 20 + (row * 13) % 100, .chars = words };
+            CLAY({ .id = CLAY_IDI("Row", row), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = CLAY_PADDING_ALL(3), .childGap = 4 }, .backgroundColor = { 30, 30, 30, 255 } }) {
+                CLAY({ .layout = { .sizing = { CLAY_SIZING_PERCENT(0.15f), CLAY_SIZING_FIXED(10) } }, .backgroundColor = { 90, 90, 90, 255 } }) {}
+                CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0, (float)(200 + row % 120)), CLAY_SIZING_FIT(0) } } }) {
+                    CLAY_TEXT(text, CLAY_TEXT_CONFIG({ .fontSize = 12, .textColor = { 255, 255, 255, 255 } }));
+                }
+                CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) } } }) {
+                    CLAY_TEXT(CLAY_STRING("a b c d e f g h i j k"), CLAY_TEXT_CONFIG({ .fontSize = 12, .textColor = { 200, 200, 200, 255 } }));
+                }
+            }
+        }
+    }
+}
+
+static double BestLayoutMs(void) {
+    double best = 1e9;
+    for (int32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+        Clay_BeginLayout();
+        DeclareLayout();
+        double start = NowMs();
+        Clay_EndLayout();
+        double end = NowMs();
+        best = end - start < best ? end - start : best;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    int32_t maxThreadCount = argc > 1 ? atoi(argv[1]) : 8;
+    maxThreadCount = maxThreadCount < 1 ? 1 : (maxThreadCount > MAX_THREAD_COUNT ? MAX_THREAD_COUNT : maxThreadCount);
+    Clay_SetMaxElementCount(ROW_COUNT * 16);
+    Clay_SetMaxMeasureTextCacheWordCount(ROW_COUNT * 32);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1920, 1080 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText, NULL);
+
+    double singleThread = BestLayoutMs();
+    printf("%d rows, best of %d frames: Clay_EndLayout %.3f ms on 1 thread\n", ROW_COUNT, FRAME_COUNT, singleThread);
+    for (int32_t threadCount = 2; threadCount <= maxThreadCount; ++threadCount) {
+        ThreadPool pool;
+        StartThreadPool(&pool, threadCount);
+        Clay_SetParallelExecutor((Clay_ParallelExecutor) { .parallelForFunction = ParallelFor, .userData = &pool });
+        double parallel = BestLayoutMs();
+        Clay_SetParallelExecutor((Clay_ParallelExecutor) { 0 });
+        StopThreadPool(&pool);
+        printf("%d rows, best of %d frames: Clay_EndLayout %.3f ms on %d threads, %.2fx\n", ROW_COUNT, FRAME_COUNT, parallel, threadCount, singleThread / parallel);
+    }
+    return 0;
+}
@@ -16,4 +16,5 @@ mkdir -p build/clay                                                       \
 -o build/clay/index.wasm                                                  \
 main.c                                                                    \
 && cp index.html build/clay/index.html && cp -r fonts/ build/clay/fonts   \
-&& cp index.html build/clay/index.html && cp -r images/ build/clay/images
\ No newline at end of file
+&& cp index.html build/clay/index.html && cp -r images/ build/clay/images \
+&& cp ../../renderers/stream/clay-render-stream.js build/clay/clay-render-stream.js
\ No newline at end of file
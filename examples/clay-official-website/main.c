@@ -1,5 +1,7 @@
 #define CLAY_IMPLEMENTATION
 #include "../../clay.h"
+#define CLAY_RENDER_STREAM_IMPLEMENTATION
+#include "../../renderers/stream/clay_render_stream.h"
 
 double windowWidth = 1024, windowHeight = 768;
 float modelPageOneZRotation = 0;
@@ -459,7 +461,7 @@ CLAY_WASM_EXPORT("UpdateDrawFrame") Clay_RenderCommandArray UpdateDrawFrame(floa
     Clay_SetCullingEnabled(ACTIVE_RENDERER_INDEX == 1);
     Clay_SetExternalScrollHandlingEnabled(ACTIVE_RENDERER_INDEX == 0);
 
-    Clay__debugViewHighlightColor = (Clay_Color) {105,210,231, 120};
+    Clay_GetCurrentContext()->debugViewHighlightColor = (Clay_Color) {105,210,231, 120};
 
     Clay_SetPointerState((Clay_Vector2) {mousePositionX, mousePositionY}, isMouseDown || isTouchDown);
 
@@ -0,0 +1,120 @@
+// Runs layout in a parent process and "renders" in a child process, passing frames through
+// a clay_render_ring.h ring in a memfd. Linux only.
+#define _GNU_SOURCE
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#define CLAY_RENDER_RING_IMPLEMENTATION
+#include "../../renderers/shared_memory/clay_render_ring.h"
+#include "../shared-layouts/clay-video-demo.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define FRAME_COUNT 100
+#define SLOT_COUNT 4
+#define SLOT_SIZE (1024 * 1024)
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+static inline Clay_Dimensions MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * config->fontSize * 0.5f, .height = config->fontSize };
+}
+
+// Stands in for a real rasterizer in the compositor process
+static int RunConsumer(int memoryFd, uint64_t memorySize) {
+    // Map the ring again so the consumer sees it at a different address than the producer
+    void *memory = mmap(NULL, memorySize, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+    if (memory == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    Clay_RenderRingConsumer consumer;
+    int32_t commandCapacity = Clay_RenderRing_MaxCommandCount(SLOT_SIZE);
+    Clay_RenderCommand *commands = (Clay_RenderCommand *)malloc((size_t)commandCapacity * sizeof(Clay_RenderCommand));
+    if (!Clay_RenderRing_Attach(&consumer, memory, memorySize, commands, commandCapacity)) {
+        printf("consumer: shared memory does not contain a render ring\n");
+        return 1;
+    }
+    int framesRendered = 0;
+    while (true) {
+        Clay_RenderCommandArray renderCommands;
+        if (!Clay_RenderRing_AcquireLatest(&consumer, &renderCommands)) {
+            usleep(1000);
+            continue;
+        }
+        // An empty frame tells the consumer to stop
+        if (renderCommands.length == 0) {
+            Clay_RenderRing_Release(&consumer);
+            break;
+        }
+        int32_t textCommands = 0;
+        Clay_StringSlice firstText = { 0 };
+        for (int32_t i = 0; i < renderCommands.length; ++i) {
+            Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+            if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+                if (textCommands++ == 0) {
+                    firstText = renderCommand->renderData.text.stringContents;
+                }
+            }
+        }
+        if (framesRendered++ % 25 == 0) {
+            printf("consumer: %d commands, %d text, first text \"%.*s\"\n", renderCommands.length, textCommands, firstText.length, firstText.chars);
+        }
+        Clay_RenderRing_Release(&consumer);
+    }
+    printf("consumer: rendered %d frames, rejected %d\n", framesRendered, consumer.rejectedFrameCount);
+    free(commands);
+    munmap(memory, memorySize);
+    return 0;
+}
+
+int main(void) {
+    uint64_t memorySize = Clay_RenderRing_MemorySize(SLOT_COUNT, SLOT_SIZE);
+    int memoryFd = memfd_create("clay-render-ring", 0);
+    if (memoryFd < 0 || ftruncate(memoryFd, (off_t)memorySize) != 0) {
+        perror("memfd");
+        return 1;
+    }
+    void *memory = mmap(NULL, memorySize, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+    if (memory == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    Clay_RenderRing *ring = Clay_RenderRing_Initialize(memory, SLOT_COUNT, SLOT_SIZE);
+
+    pid_t consumer = fork();
+    if (consumer == 0) {
+        munmap(memory, memorySize);
+        return RunConsumer(memoryFd, memorySize);
+    }
+
+    uint64_t clayMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(clayMemorySize, malloc(clayMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText, NULL);
+    ClayVideoDemo_Data demoData = ClayVideoDemo_Initialize();
+
+    int framesDropped = 0;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        Clay_SetLayoutDimensions((Clay_Dimensions) { 800.0f + (float)(frame % 50) * 8, 600 });
+        Clay_RenderCommandArray renderCommands = ClayVideoDemo_CreateLayout(&demoData);
+        // A real app would keep laying out frames and let the compositor catch up
+        if (Clay_RenderRing_Publish(ring, renderCommands) != CLAY_RENDER_RING_PUBLISH_SUCCESS) {
+            framesDropped++;
+        }
+        usleep(2000);
+    }
+    Clay_RenderCommandArray endOfStream = { 0 };
+    while (Clay_RenderRing_Publish(ring, endOfStream) != CLAY_RENDER_RING_PUBLISH_SUCCESS) {
+        usleep(1000);
+    }
+    waitpid(consumer, NULL, 0);
+    printf("producer: published %d frames, dropped %d\n", FRAME_COUNT - framesDropped, framesDropped);
+    return 0;
+}
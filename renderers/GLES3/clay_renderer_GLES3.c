@@ -0,0 +1,216 @@
+// OpenGL ES 3.0 renderer for Clay. Also runs on WebGL 2 through emscripten, and on desktop OpenGL contexts that support
+// GL_ARB_ES3_compatibility, as long as <GLES3/gl3.h> declares the functions.
+//
+// Rectangles, borders and images are converted with renderers/vertex/clay_vertex_buffer.h and drawn by one shader
+// that evaluates rounded corners and borders per pixel. TEXT and CUSTOM commands are passed in order to
+// Clay_GLES3RendererData.renderCommandFunction, which can draw them with any GL state it likes.
+//
+// imageData must point to a GLuint texture name, like Texture2D * in the raylib renderer.
+#include "../../clay.h"
+#define CLAY_VERTEX_BUFFER_IMPLEMENTATION
+#include "../vertex/clay_vertex_buffer.h"
+
+#include <GLES3/gl3.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    GLuint program;
+    GLuint vertexArray;
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    GLint viewSizeLocation;
+    GLint pixelScaleLocation;
+    GLint texturedLocation;
+    // Storage for the vertex buffer, grown as frames need it
+    Clay_VertexBuffer buffer;
+    // Called for TEXT and CUSTOM render commands, with the scissor of the enclosing clip elements already set
+    void (*renderCommandFunction)(Clay_RenderCommand *renderCommand, void *userData);
+    void *userData;
+} Clay_GLES3RendererData;
+
+static const char *CLAY_GLES3_VERTEX_SHADER =
+    "#version 300 es\n"
+    "layout(location = 0) in vec2 positionIn;\n"
+    "layout(location = 1) in vec2 uvIn;\n"
+    "layout(location = 2) in vec2 localIn;\n"
+    "layout(location = 3) in vec2 halfSizeIn;\n"
+    "layout(location = 4) in vec4 cornerRadiusIn;\n"
+    "layout(location = 5) in vec4 borderWidthIn;\n"
+    "layout(location = 6) in vec4 colorIn;\n"
+    "uniform vec2 viewSize;\n"
+    "out vec2 uv; out vec2 local; flat out vec2 halfSize; flat out vec4 cornerRadius; flat out vec4 borderWidth; flat out vec4 color;\n"
+    "void main() {\n"
+    "    uv = uvIn; local = localIn; halfSize = halfSizeIn; cornerRadius = cornerRadiusIn; borderWidth = borderWidthIn; color = colorIn;\n"
+    "    gl_Position = vec4(positionIn / viewSize * vec2(2.0, -2.0) + vec2(-1.0, 1.0), 0.0, 1.0);\n"
+    "}\n";
+
+// The reference shader from clay_vertex_buffer.h, with distances scaled to framebuffer pixels for antialiasing
+static const char *CLAY_GLES3_FRAGMENT_SHADER =
+    "#version 300 es\n"
+    "precision highp float;\n"
+    "in vec2 uv; in vec2 local; flat in vec2 halfSize; flat in vec4 cornerRadius; flat in vec4 borderWidth; flat in vec4 color;\n"
+    "uniform sampler2D image; uniform bool textured; uniform float pixelScale;\n"
+    "out vec4 fragColor;\n"
+    "float roundedBox(vec2 p, vec2 b, float r) { vec2 q = abs(p) - b + r; return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r; }\n"
+    "float cornerFor(vec2 p, vec4 r) { return p.x < 0.0 ? (p.y < 0.0 ? r.x : r.w) : (p.y < 0.0 ? r.y : r.z); }\n"
+    "void main() {\n"
+    "    float outer = roundedBox(local, halfSize, cornerFor(local, cornerRadius)) * pixelScale;\n"
+    "    float alpha = clamp(0.5 - outer, 0.0, 1.0);\n"
+    "    if (any(greaterThan(borderWidth, vec4(0.0)))) {\n"
+    "        vec2 innerCenter = vec2(borderWidth.x - borderWidth.z, borderWidth.y - borderWidth.w) * 0.5;\n"
+    "        vec2 innerHalf = halfSize - vec2(borderWidth.x + borderWidth.z, borderWidth.y + borderWidth.w) * 0.5;\n"
+    "        vec2 p = local - innerCenter;\n"
+    "        float inner = roundedBox(p, max(innerHalf, 0.0), max(cornerFor(p, cornerRadius) - max(max(borderWidth.x, borderWidth.y), max(borderWidth.z, borderWidth.w)), 0.0)) * pixelScale;\n"
+    "        alpha *= clamp(inner + 0.5, 0.0, 1.0);\n"
+    "    }\n"
+    "    vec4 base = textured ? texture(image, uv) * color : color;\n"
+    "    fragColor = vec4(base.rgb, base.a * alpha);\n"
+    "}\n";
+
+static GLuint Clay_GLES3_CompileShader(GLenum type, const char *source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    GLint compiled = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        fprintf(stderr, "Clay GLES3 renderer: shader failed to compile: %s\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Call with the GL context current. Returns false if the shaders didn't compile or link.
+bool Clay_GLES3_Initialize(Clay_GLES3RendererData *rendererData) {
+    GLuint vertexShader = Clay_GLES3_CompileShader(GL_VERTEX_SHADER, CLAY_GLES3_VERTEX_SHADER);
+    GLuint fragmentShader = Clay_GLES3_CompileShader(GL_FRAGMENT_SHADER, CLAY_GLES3_FRAGMENT_SHADER);
+    if (!vertexShader || !fragmentShader) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+    rendererData->program = glCreateProgram();
+    glAttachShader(rendererData->program, vertexShader);
+    glAttachShader(rendererData->program, fragmentShader);
+    glLinkProgram(rendererData->program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    GLint linked = 0;
+    glGetProgramiv(rendererData->program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[1024];
+        glGetProgramInfoLog(rendererData->program, sizeof(log), NULL, log);
+        fprintf(stderr, "Clay GLES3 renderer: shader program failed to link: %s\n", log);
+        glDeleteProgram(rendererData->program);
+        rendererData->program = 0;
+        return false;
+    }
+    rendererData->viewSizeLocation = glGetUniformLocation(rendererData->program, "viewSize");
+    rendererData->pixelScaleLocation = glGetUniformLocation(rendererData->program, "pixelScale");
+    rendererData->texturedLocation = glGetUniformLocation(rendererData->program, "textured");
+
+    glGenVertexArrays(1, &rendererData->vertexArray);
+    glGenBuffers(1, &rendererData->vertexBuffer);
+    glGenBuffers(1, &rendererData->indexBuffer);
+    glBindVertexArray(rendererData->vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, rendererData->vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rendererData->indexBuffer);
+    GLsizei stride = sizeof(Clay_Vertex);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(Clay_Vertex, x));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(Clay_Vertex, u));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(Clay_Vertex, localX));
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(Clay_Vertex, halfWidth));
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(Clay_Vertex, cornerRadius));
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(Clay_Vertex, borderWidth));
+    glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void *)offsetof(Clay_Vertex, color));
+    for (GLuint i = 0; i < 7; ++i) {
+        glEnableVertexAttribArray(i);
+    }
+    glBindVertexArray(0);
+    return true;
+}
+
+static void Clay_GLES3_BindState(Clay_GLES3RendererData *rendererData, float viewWidth, float viewHeight, float scale) {
+    glUseProgram(rendererData->program);
+    glUniform2f(rendererData->viewSizeLocation, viewWidth, viewHeight);
+    glUniform1f(rendererData->pixelScaleLocation, scale);
+    glBindVertexArray(rendererData->vertexArray);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Grows the arrays to the sizes reported by a failed Clay_VertexBuffer_Build
+static bool Clay_GLES3_GrowBuffer(Clay_VertexBuffer *buffer) {
+    Clay_Vertex *vertices = (Clay_Vertex *)realloc(buffer->vertices, sizeof(Clay_Vertex) * (size_t)buffer->vertexCount);
+    uint32_t *indices = (uint32_t *)realloc(buffer->indices, sizeof(uint32_t) * (size_t)buffer->indexCount);
+    Clay_VertexDrawRange *drawRanges = (Clay_VertexDrawRange *)realloc(buffer->drawRanges, sizeof(Clay_VertexDrawRange) * (size_t)buffer->drawRangeCount);
+    if (vertices) { buffer->vertices = vertices; buffer->vertexCapacity = buffer->vertexCount; }
+    if (indices) { buffer->indices = indices; buffer->indexCapacity = buffer->indexCount; }
+    if (drawRanges) { buffer->drawRanges = drawRanges; buffer->drawRangeCapacity = buffer->drawRangeCount; }
+    return vertices && indices && drawRanges;
+}
+
+// Draws renderCommands into the current framebuffer, which is framebufferWidth x framebufferHeight pixels.
+// scale converts layout units to pixels, e.g. the device pixel ratio. Doesn't clear or set the viewport.
+void Clay_GLES3_Render(Clay_GLES3RendererData *rendererData, Clay_RenderCommandArray renderCommands, int framebufferWidth, int framebufferHeight, float scale) {
+    Clay_VertexBuffer *buffer = &rendererData->buffer;
+    if (!Clay_VertexBuffer_Build(buffer, renderCommands)) {
+        if (!Clay_GLES3_GrowBuffer(buffer) || !Clay_VertexBuffer_Build(buffer, renderCommands)) {
+            fprintf(stderr, "Clay GLES3 renderer: out of memory for %d vertices\n", buffer->vertexCount);
+            return;
+        }
+    }
+    float viewWidth = (float)framebufferWidth / scale;
+    float viewHeight = (float)framebufferHeight / scale;
+    Clay_GLES3_BindState(rendererData, viewWidth, viewHeight, scale);
+    glBindBuffer(GL_ARRAY_BUFFER, rendererData->vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(sizeof(Clay_Vertex) * (size_t)buffer->vertexCount), buffer->vertices, GL_STREAM_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(sizeof(uint32_t) * (size_t)buffer->indexCount), buffer->indices, GL_STREAM_DRAW);
+
+    for (int32_t i = 0; i < buffer->drawRangeCount; ++i) {
+        Clay_VertexDrawRange *range = &buffer->drawRanges[i];
+        if (range->scissorEnabled) {
+            // GL scissors count rows from the bottom. Round outwards so that edges on fractional pixels aren't cut.
+            GLint left = (GLint)(range->scissor.x * scale);
+            GLint top = (GLint)(range->scissor.y * scale);
+            GLint right = (GLint)(range->scissor.x * scale + range->scissor.width * scale + 0.999f);
+            GLint bottom = (GLint)(range->scissor.y * scale + range->scissor.height * scale + 0.999f);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(left, framebufferHeight - bottom, CLAY__MAX(right - left, 0), CLAY__MAX(bottom - top, 0));
+        } else {
+            glDisable(GL_SCISSOR_TEST);
+        }
+        if (range->renderCommandIndex >= 0) {
+            if (rendererData->renderCommandFunction) {
+                rendererData->renderCommandFunction(&renderCommands.internalArray[range->renderCommandIndex], rendererData->userData);
+                Clay_GLES3_BindState(rendererData, viewWidth, viewHeight, scale);
+            }
+            continue;
+        }
+        glUniform1i(rendererData->texturedLocation, range->imageData != NULL);
+        if (range->imageData) {
+            glBindTexture(GL_TEXTURE_2D, *(GLuint *)range->imageData);
+        }
+        glDrawElements(GL_TRIANGLES, (GLsizei)range->indexCount, GL_UNSIGNED_INT, (void *)(uintptr_t)(range->indexStart * sizeof(uint32_t)));
+    }
+    glDisable(GL_SCISSOR_TEST);
+    glBindVertexArray(0);
+}
+
+void Clay_GLES3_Shutdown(Clay_GLES3RendererData *rendererData) {
+    glDeleteBuffers(1, &rendererData->vertexBuffer);
+    glDeleteBuffers(1, &rendererData->indexBuffer);
+    glDeleteVertexArrays(1, &rendererData->vertexArray);
+    glDeleteProgram(rendererData->program);
+    free(rendererData->buffer.vertices);
+    free(rendererData->buffer.indices);
+    free(rendererData->buffer.drawRanges);
+    rendererData->buffer = (Clay_VertexBuffer) { 0 };
+}
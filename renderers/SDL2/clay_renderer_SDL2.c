@@ -422,6 +422,9 @@ static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray ren
 
                 break;
             }
+            // Layers are only a caching hint, their contents are drawn as usual
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
             default: {
                 fprintf(stderr, "Error: unhandled render command: %d\n", renderCommand->commandType);
                 exit(1);
@@ -257,6 +257,9 @@ static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Cla
                 SDL_RenderTexture(rendererData->renderer, texture, NULL, &dest);
                 break;
             }
+            // Layers are only a caching hint, their contents are drawn as usual
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
             default:
                 SDL_Log("Unknown render command type: %d", rcmd->commandType);
         }
@@ -42,7 +42,15 @@ void Clay_Cairo_Initialize(cairo_t *cairo);
 
 // Render the command queue to the `cairo_t*` instance you called
 // `Clay_Cairo_Initialize` on.
+//
+// Elements declared with `.layer = { .cached = true }` are drawn to an
+// offscreen surface once, and that surface is painted on later frames for
+// as long as the layer's content hash and size don't change. Layers that
+// aren't drawn during a frame are freed at the end of it.
 void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts);
+
+// Frees every cached layer surface.
+void Clay_Cairo_ClearLayerCache(void);
 ////////////////////////////////
 
 
@@ -61,6 +69,30 @@ void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts);
 // Cairo instance
 static cairo_t *Clay__Cairo = NULL;
 
+// The maximum number of layer surfaces kept between frames
+#ifndef CLAY_CAIRO_MAX_CACHED_LAYERS
+#define CLAY_CAIRO_MAX_CACHED_LAYERS 64
+#endif
+// Layers nested deeper than this are drawn directly instead of being cached
+#define CLAY_CAIRO__MAX_LAYER_DEPTH 16
+
+typedef struct {
+	uint32_t id;
+	uint32_t contentHash;
+	int width, height;
+	cairo_surface_t *surface;
+	bool usedThisFrame;
+} Clay_Cairo__CachedLayer;
+
+static Clay_Cairo__CachedLayer Clay_Cairo__Layers[CLAY_CAIRO_MAX_CACHED_LAYERS];
+
+// A layer that is currently being drawn to its surface
+typedef struct {
+	cairo_t *parent;
+	Clay_Cairo__CachedLayer *layer;
+	Clay_BoundingBox boundingBox;
+} Clay_Cairo__OpenLayer;
+
 // Return a null-terminated copy of Clay_String `str`.
 // Callee is required to free.
 static inline char *Clay_Cairo__NullTerminate(Clay_String *str) {
@@ -154,6 +186,49 @@ void Clay_Cairo_Initialize(cairo_t *cairo) {
 	Clay__Cairo = cairo;
 }
 
+void Clay_Cairo_ClearLayerCache(void) {
+	for (int i = 0; i < CLAY_CAIRO_MAX_CACHED_LAYERS; i++) {
+		if (Clay_Cairo__Layers[i].surface) {
+			cairo_surface_destroy(Clay_Cairo__Layers[i].surface);
+		}
+		Clay_Cairo__Layers[i] = (Clay_Cairo__CachedLayer) { 0 };
+	}
+}
+
+// Returns the cache slot for the layer with this id, reusing a slot that wasn't used this frame if
+// there isn't one yet. Returns NULL if every slot is already in use this frame.
+static Clay_Cairo__CachedLayer *Clay_Cairo__FindLayer(uint32_t id) {
+	Clay_Cairo__CachedLayer *free_slot = NULL;
+	for (int i = 0; i < CLAY_CAIRO_MAX_CACHED_LAYERS; i++) {
+		Clay_Cairo__CachedLayer *layer = &Clay_Cairo__Layers[i];
+		if (layer->surface && layer->id == id) {
+			return layer;
+		}
+		if (!free_slot && (!layer->surface || !layer->usedThisFrame)) {
+			free_slot = layer;
+		}
+	}
+	if (free_slot && free_slot->surface) {
+		cairo_surface_destroy(free_slot->surface);
+		*free_slot = (Clay_Cairo__CachedLayer) { 0 };
+	}
+	return free_slot;
+}
+
+// Returns the index of the LAYER_END that matches the LAYER_BEGIN at begin_index
+static size_t Clay_Cairo__FindLayerEnd(Clay_RenderCommandArray *commands, size_t begin_index) {
+	int depth = 0;
+	for (size_t i = begin_index; i < (size_t)commands->length; i++) {
+		Clay_RenderCommandType type = commands->internalArray[i].commandType;
+		if (type == CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN) {
+			depth++;
+		} else if (type == CLAY_RENDER_COMMAND_TYPE_LAYER_END && --depth == 0) {
+			return i;
+		}
+	}
+	return (size_t)commands->length;
+}
+
 // Internally used to copy images onto our document/active workspace.
 void Clay_Cairo__Blit_Surface(cairo_surface_t *src_surface, cairo_surface_t *dest_surface,
 							  double x, double y, double scale_x, double scale_y) {
@@ -184,6 +259,13 @@ void Clay_Cairo__Blit_Surface(cairo_surface_t *src_surface, cairo_surface_t *des
 
 void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts) {
 	cairo_t *cr = Clay__Cairo;
+	Clay_Cairo__OpenLayer open_layers[CLAY_CAIRO__MAX_LAYER_DEPTH];
+	int open_layer_count = 0;
+	// Layers that are drawn directly because they couldn't be cached
+	int uncached_layer_depth = 0;
+	for (int i = 0; i < CLAY_CAIRO_MAX_CACHED_LAYERS; i++) {
+		Clay_Cairo__Layers[i].usedThisFrame = false;
+	}
 	for(size_t i = 0; i < commands.length; i++) {
 		Clay_RenderCommand *command = Clay_RenderCommandArray_Get(&commands, i);
 
@@ -227,7 +309,7 @@ void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts) {
 			Clay_BoundingBox bb = command->boundingBox;
 			Clay_Color color = config->textColor;
 
-			cairo_select_font_face(Clay__Cairo, font_family, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+			cairo_select_font_face(cr, font_family, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
 			cairo_set_font_size(cr, config->fontSize);
 
 			cairo_move_to(cr, bb.x, bb.y + bb.height);
@@ -331,8 +413,7 @@ void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts) {
 
 			char *path = config->imageData;
 
-			cairo_surface_t *surf = cairo_image_surface_create_from_png(path),
-							*origin = cairo_get_target(cr);
+			cairo_surface_t *surf = cairo_image_surface_create_from_png(path);
 
 			// Calculate the original image dimensions
 			double image_w = cairo_image_surface_get_width(surf),
@@ -355,13 +436,73 @@ void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts) {
 			double centered_x = bb.x + (bb.width - scaled_w) / 2.0;
 			double centered_y = bb.y + (bb.height - scaled_h) / 2.0;
 
-			// Blit the scaled and centered image
-			Clay_Cairo__Blit_Surface(surf, origin, centered_x, centered_y, scale_x, scale_y);
+			// Draw the scaled and centered image through cr, so that it is
+			// positioned correctly when drawing into a layer surface
+			cairo_save(cr);
+			cairo_translate(cr, centered_x, centered_y);
+			cairo_scale(cr, scale_x, scale_y);
+			cairo_set_source_surface(cr, surf, 0, 0);
+			cairo_paint(cr);
+			cairo_restore(cr);
 
 			// Clean up the source surface
 			cairo_surface_destroy(surf);
 			break;
 		}
+		case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN: {
+			Clay_BoundingBox bb = command->boundingBox;
+			int width = (int) ceil(bb.width), height = (int) ceil(bb.height);
+			Clay_Cairo__CachedLayer *layer = NULL;
+			if (open_layer_count < CLAY_CAIRO__MAX_LAYER_DEPTH && uncached_layer_depth == 0 && width > 0 && height > 0) {
+				layer = Clay_Cairo__FindLayer(command->id);
+			}
+			if (!layer) {
+				uncached_layer_depth++;
+				break;
+			}
+			layer->usedThisFrame = true;
+			if (layer->surface && layer->contentHash == command->renderData.layer.contentHash && layer->width == width && layer->height == height) {
+				// The contents haven't changed, paint the cached surface and skip everything inside the layer
+				cairo_set_source_surface(cr, layer->surface, bb.x, bb.y);
+				cairo_paint(cr);
+				i = Clay_Cairo__FindLayerEnd(&commands, i);
+				break;
+			}
+			if (layer->surface && (layer->width != width || layer->height != height)) {
+				cairo_surface_destroy(layer->surface);
+				layer->surface = NULL;
+			}
+			if (!layer->surface) {
+				layer->surface = cairo_surface_create_similar(cairo_get_target(Clay__Cairo), CAIRO_CONTENT_COLOR_ALPHA, width, height);
+			}
+			layer->id = command->id;
+			layer->contentHash = command->renderData.layer.contentHash;
+			layer->width = width;
+			layer->height = height;
+
+			open_layers[open_layer_count++] = (Clay_Cairo__OpenLayer) { .parent = cr, .layer = layer, .boundingBox = bb };
+			cr = cairo_create(layer->surface);
+			cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+			cairo_paint(cr);
+			cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+			cairo_translate(cr, -bb.x, -bb.y);
+			break;
+		}
+		case CLAY_RENDER_COMMAND_TYPE_LAYER_END: {
+			if (uncached_layer_depth > 0) {
+				uncached_layer_depth--;
+				break;
+			}
+			if (open_layer_count == 0) {
+				break;
+			}
+			Clay_Cairo__OpenLayer *open_layer = &open_layers[--open_layer_count];
+			cairo_destroy(cr);
+			cr = open_layer->parent;
+			cairo_set_source_surface(cr, open_layer->layer->surface, open_layer->boundingBox.x, open_layer->boundingBox.y);
+			cairo_paint(cr);
+			break;
+		}
 		case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
 			// Slot your custom elements in here.
 		}
@@ -370,4 +511,13 @@ void Clay_Cairo_Render(Clay_RenderCommandArray commands, char** fonts) {
 		}
 		}
 	}
+
+	// Layers that weren't drawn this frame are most likely gone for good
+	for (int i = 0; i < CLAY_CAIRO_MAX_CACHED_LAYERS; i++) {
+		Clay_Cairo__CachedLayer *layer = &Clay_Cairo__Layers[i];
+		if (layer->surface && !layer->usedThisFrame) {
+			cairo_surface_destroy(layer->surface);
+			*layer = (Clay_Cairo__CachedLayer) { 0 };
+		}
+	}
 }
@@ -264,6 +264,9 @@ static void Clay_Playdate_Render(PlaydateAPI *pd, Clay_RenderCommandArray render
                 }
                 break;
             }
+            // Layers are only a caching hint, their contents are drawn as usual
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
             default: {
                 pd->system->logToConsole("Error: unhandled render command: %d\n", renderCommand->commandType);
                 return;
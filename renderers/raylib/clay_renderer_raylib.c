@@ -256,6 +256,9 @@ void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
                 }
                 break;
             }
+            // Layers are only a caching hint, their contents are drawn as usual
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
             default: {
                 printf("Error: unhandled render command.");
                 exit(1);
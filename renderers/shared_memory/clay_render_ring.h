@@ -0,0 +1,388 @@
+#ifndef CLAY_RENDER_RING_INCLUDED
+#define CLAY_RENDER_RING_INCLUDED (1)
+/*
+    clay_render_ring.h -- single producer, single consumer ring of render command frames in shared memory
+
+    Do this:
+        #define CLAY_RENDER_RING_IMPLEMENTATION
+
+    before you include this file in *one* C file to create the implementation.
+    clay.h must be included before this file.
+
+    Layout runs in one process and rasterization in another. The producer
+    publishes each frame's Clay_RenderCommandArray into a ring of fixed size
+    slots in caller provided shared memory. Each slot is a self contained
+    frame block: a small header, the render commands, then the text of the
+    TEXT commands. Text is stored as offsets relative to the slot, so the
+    block means the same thing at any mapping address. Text is interned:
+    commands that share a string, or that slice nearby parts of one string
+    like the wrapped lines of a text element, share one copy of its bytes.
+
+    The consumer does not trust anything in the shared memory. It checks the
+    ring's geometry against the size of its mapping when it attaches, keeps
+    its own copy of the geometry and read index, and copies each acquired
+    frame's commands into memory of its own before validating them, so the
+    producer can't change them afterwards. Text stays in the slot, and every
+    TEXT command must lie inside the slot's text. Frames that fail these
+    checks are released and counted in rejectedFrameCount, never returned.
+    The slot belongs to the consumer until it releases it.
+
+    userData, imageData and customData are copied verbatim. They are only
+    meaningful to the consumer if both processes agree on what they mean,
+    e.g. texture handles or indices rather than pointers. They are not
+    validated.
+
+    Both processes must be built for the same architecture with the same
+    clay.h, since Clay_RenderCommand is shared in its native layout.
+
+    HOWTO:
+    ======
+    Producer:
+
+        uint64_t size = Clay_RenderRing_MemorySize(4, 1024 * 1024);
+        void *memory = <map size bytes of shared memory>;
+        Clay_RenderRing *ring = Clay_RenderRing_Initialize(memory, 4, 1024 * 1024);
+        // every frame
+        Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+        Clay_RenderRing_Publish(ring, renderCommands);
+
+    Consumer:
+
+        Clay_RenderRingConsumer consumer;
+        int32_t commandCapacity = Clay_RenderRing_MaxCommandCount(1024 * 1024);
+        Clay_RenderCommand *commands = malloc(commandCapacity * sizeof(Clay_RenderCommand));
+        if (!Clay_RenderRing_Attach(&consumer, <the same shared memory, mapped anywhere>, size, commands, commandCapacity)) {
+            <the memory does not hold a valid ring>
+        }
+        Clay_RenderCommandArray renderCommands;
+        if (Clay_RenderRing_AcquireLatest(&consumer, &renderCommands)) {
+            render(renderCommands);
+            Clay_RenderRing_Release(&consumer);
+        }
+
+    See examples/shared-memory-renderer for a runnable memfd based example.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CLAY_HEADER
+#error "Please include clay.h before clay_render_ring.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lives at the start of the shared memory, followed by the slots.
+// The indices count frames since initialization and are kept on separate cache lines.
+typedef struct Clay_RenderRing {
+    uint32_t magic;
+    uint32_t version;
+    int32_t slotCount;
+    int32_t slotSize;
+    uint8_t padding0[48];
+    // Number of frames published, written only by the producer
+    uint64_t writeIndex;
+    uint8_t padding1[56];
+    // Number of frames released, written only by the consumer
+    uint64_t readIndex;
+    uint8_t padding2[56];
+} Clay_RenderRing;
+
+// The consumer's side of a ring, in the consumer's own memory.
+// Filled in by Clay_RenderRing_Attach, with the geometry it validated against the size of the mapping.
+typedef struct Clay_RenderRingConsumer {
+    Clay_RenderRing *ring;
+    int32_t slotCount;
+    int32_t slotSize;
+    uint64_t readIndex;
+    // Caller provided storage that each acquired frame's commands are copied into
+    Clay_RenderCommand *commands;
+    int32_t commandCapacity;
+    // Number of frames that were released without being returned, because their contents were invalid
+    int32_t rejectedFrameCount;
+} Clay_RenderRingConsumer;
+
+typedef enum {
+    // The frame was published.
+    CLAY_RENDER_RING_PUBLISH_SUCCESS,
+    // Every slot holds a frame the consumer has not released yet. The frame was dropped.
+    CLAY_RENDER_RING_PUBLISH_RING_FULL,
+    // The frame does not fit in one slot. The frame was dropped.
+    CLAY_RENDER_RING_PUBLISH_FRAME_TOO_LARGE,
+} Clay_RenderRing_PublishResult;
+
+// Returns the number of bytes of shared memory required for a ring of slotCount slots of slotSize bytes each.
+uint64_t Clay_RenderRing_MemorySize(int32_t slotCount, int32_t slotSize);
+// Returns the number of bytes a slot needs to hold renderCommands.
+int32_t Clay_RenderRing_FrameSize(Clay_RenderCommandArray renderCommands);
+// Returns the most render commands that fit in a slot of slotSize bytes.
+int32_t Clay_RenderRing_MaxCommandCount(int32_t slotSize);
+// Called once by the producer, before the consumer attaches.
+// memory must be at least Clay_RenderRing_MemorySize() bytes and 64 byte aligned.
+// slotSize is rounded up to a multiple of 64.
+Clay_RenderRing *Clay_RenderRing_Initialize(void *memory, int32_t slotCount, int32_t slotSize);
+// Called by the consumer on its own mapping of memory that was passed to Clay_RenderRing_Initialize, memorySize bytes long.
+// commands must have room for commandCapacity render commands. Frames with more commands than that are rejected.
+// Returns false if the memory does not contain an initialized ring that fits in memorySize.
+bool Clay_RenderRing_Attach(Clay_RenderRingConsumer *consumer, void *memory, uint64_t memorySize, Clay_RenderCommand *commands, int32_t commandCapacity);
+// Copies renderCommands and their text into the next free slot and makes it visible to the consumer.
+Clay_RenderRing_PublishResult Clay_RenderRing_Publish(Clay_RenderRing *ring, Clay_RenderCommandArray renderCommands);
+// Acquires the oldest published frame. Returns false if there is none, or if it was invalid and has been released.
+// renderCommands points into consumer->commands, its text into the slot, and both stay valid until Clay_RenderRing_Release.
+bool Clay_RenderRing_Acquire(Clay_RenderRingConsumer *consumer, Clay_RenderCommandArray *renderCommands);
+// Like Clay_RenderRing_Acquire, but releases every published frame except the newest one first.
+bool Clay_RenderRing_AcquireLatest(Clay_RenderRingConsumer *consumer, Clay_RenderCommandArray *renderCommands);
+// Hands the acquired frame's slot back to the producer.
+void Clay_RenderRing_Release(Clay_RenderRingConsumer *consumer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLAY_RENDER_RING_INCLUDED */
+
+#ifdef CLAY_RENDER_RING_IMPLEMENTATION
+#ifndef CLAY_RENDER_RING_IMPLEMENTATION_INCLUDED
+#define CLAY_RENDER_RING_IMPLEMENTATION_INCLUDED (1)
+#include <string.h>
+
+#define CLAY_RENDER_RING__MAGIC 0x474e5243 // "CRNG"
+#define CLAY_RENDER_RING__VERSION 2
+#define CLAY_RENDER_RING__ALIGNMENT 64
+// Strings remembered per frame for interning. A hit reuses the text already copied into the slot.
+#define CLAY_RENDER_RING__INTERN_TABLE_SIZE 256
+// Bytes of the source string copied between two slices of it, rather than copying the second slice on its own
+#define CLAY_RENDER_RING__MAX_TEXT_GAP 16
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static uint64_t Clay_RenderRing__LoadAcquire(uint64_t *value) { return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)value, 0, 0); }
+static void Clay_RenderRing__StoreRelease(uint64_t *value, uint64_t newValue) { _InterlockedExchange64((volatile __int64 *)value, (__int64)newValue); }
+#else
+static uint64_t Clay_RenderRing__LoadAcquire(uint64_t *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+static void Clay_RenderRing__StoreRelease(uint64_t *value, uint64_t newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+#endif
+
+// Sits at the start of every slot
+typedef struct {
+    uint64_t frameIndex;
+    int32_t commandCount;
+    int32_t textOffset;
+    int32_t textLength;
+    int32_t padding;
+} Clay_RenderRing__Frame;
+
+typedef struct {
+    uintptr_t chars;
+    int32_t length;
+    int32_t offset;
+} Clay_RenderRing__InternedText;
+
+#define CLAY_RENDER_RING__COMMANDS_OFFSET ((int32_t)((sizeof(Clay_RenderRing__Frame) + sizeof(void *) - 1) & ~(sizeof(void *) - 1)))
+
+static int32_t Clay_RenderRing__AlignSlotSize(int32_t slotSize) {
+    return (slotSize + CLAY_RENDER_RING__ALIGNMENT - 1) & ~(CLAY_RENDER_RING__ALIGNMENT - 1);
+}
+
+static uint8_t *Clay_RenderRing__GetSlot(Clay_RenderRing *ring, int32_t slotCount, int32_t slotSize, uint64_t frameIndex) {
+    return (uint8_t *)ring + sizeof(Clay_RenderRing) + (uint64_t)slotSize * (frameIndex % (uint64_t)slotCount);
+}
+
+// Gives the text of every TEXT command an offset in the slot, starting at textOffset, and returns the end of the text.
+// When slot is not NULL, also copies the text and stores the offsets in commands, and returns -1 if the text would pass slotSize.
+static int64_t Clay_RenderRing__InternText(Clay_RenderCommandArray renderCommands, int64_t textOffset, int64_t slotSize, uint8_t *slot, Clay_RenderCommand *commands) {
+    Clay_RenderRing__InternedText table[CLAY_RENDER_RING__INTERN_TABLE_SIZE];
+    memset(table, 0, sizeof(table));
+    // The most recent copy, which always ends at textOffset and can be extended in place
+    uintptr_t runChars = 0, runBaseChars = 0;
+    int64_t runLength = 0, runOffset = 0;
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_TEXT) {
+            continue;
+        }
+        Clay_StringSlice text = renderCommand->renderData.text.stringContents;
+        uintptr_t chars = (uintptr_t)text.chars;
+        int64_t offset;
+        Clay_RenderRing__InternedText *entry = &table[((chars >> 3) ^ (uintptr_t)text.length) % CLAY_RENDER_RING__INTERN_TABLE_SIZE];
+        if (runChars && chars >= runChars && chars + (uintptr_t)text.length <= runChars + (uintptr_t)runLength) {
+            offset = runOffset + (int64_t)(chars - runChars);
+        } else if (runChars && (uintptr_t)text.baseChars == runBaseChars && chars >= runChars && chars <= runChars + (uintptr_t)runLength + CLAY_RENDER_RING__MAX_TEXT_GAP) {
+            // A later slice of the same string, e.g. the next wrapped line. The gap between the two is part of that string too.
+            int64_t extension = (int64_t)(chars - runChars) + text.length - runLength;
+            if (slot) {
+                if (textOffset + extension > slotSize) {
+                    return -1;
+                }
+                memcpy(slot + textOffset, (const char *)(runChars + (uintptr_t)runLength), (size_t)extension);
+            }
+            offset = runOffset + (int64_t)(chars - runChars);
+            runLength += extension;
+            textOffset += extension;
+        } else if (entry->chars == chars && entry->length == text.length && text.length > 0) {
+            offset = entry->offset;
+        } else {
+            if (slot) {
+                if (textOffset + text.length > slotSize) {
+                    return -1;
+                }
+                memcpy(slot + textOffset, text.chars, (size_t)text.length);
+            }
+            offset = textOffset;
+            runChars = chars;
+            runBaseChars = (uintptr_t)text.baseChars;
+            runLength = text.length;
+            runOffset = textOffset;
+            textOffset += text.length;
+            *entry = CLAY__INIT(Clay_RenderRing__InternedText) { chars, text.length, (int32_t)offset };
+        }
+        if (slot) {
+            // Offsets from the start of the slot, turned back into pointers by the consumer
+            commands[i].renderData.text.stringContents.chars = (const char *)(uintptr_t)offset;
+            commands[i].renderData.text.stringContents.baseChars = commands[i].renderData.text.stringContents.chars;
+        }
+    }
+    return textOffset;
+}
+
+uint64_t Clay_RenderRing_MemorySize(int32_t slotCount, int32_t slotSize) {
+    return sizeof(Clay_RenderRing) + (uint64_t)slotCount * (uint64_t)Clay_RenderRing__AlignSlotSize(slotSize);
+}
+
+int32_t Clay_RenderRing_FrameSize(Clay_RenderCommandArray renderCommands) {
+    int64_t size = CLAY_RENDER_RING__COMMANDS_OFFSET + (int64_t)renderCommands.length * (int64_t)sizeof(Clay_RenderCommand);
+    size = Clay_RenderRing__InternText(renderCommands, size, INT64_MAX, NULL, NULL);
+    return size > INT32_MAX ? INT32_MAX : (int32_t)size;
+}
+
+int32_t Clay_RenderRing_MaxCommandCount(int32_t slotSize) {
+    int32_t commandsSize = Clay_RenderRing__AlignSlotSize(slotSize) - CLAY_RENDER_RING__COMMANDS_OFFSET;
+    return commandsSize > 0 ? commandsSize / (int32_t)sizeof(Clay_RenderCommand) : 0;
+}
+
+Clay_RenderRing *Clay_RenderRing_Initialize(void *memory, int32_t slotCount, int32_t slotSize) {
+    Clay_RenderRing *ring = (Clay_RenderRing *)memory;
+    memset(ring, 0, sizeof(Clay_RenderRing));
+    ring->slotCount = slotCount;
+    ring->slotSize = Clay_RenderRing__AlignSlotSize(slotSize);
+    ring->version = CLAY_RENDER_RING__VERSION;
+    ring->magic = CLAY_RENDER_RING__MAGIC;
+    return ring;
+}
+
+bool Clay_RenderRing_Attach(Clay_RenderRingConsumer *consumer, void *memory, uint64_t memorySize, Clay_RenderCommand *commands, int32_t commandCapacity) {
+    Clay_RenderRing *ring = (Clay_RenderRing *)memory;
+    if (memorySize < sizeof(Clay_RenderRing)) {
+        return false;
+    }
+    // Read once, so the values checked are the values used
+    volatile Clay_RenderRing *sharedRing = ring;
+    uint32_t magic = sharedRing->magic;
+    uint32_t version = sharedRing->version;
+    int32_t slotCount = sharedRing->slotCount;
+    int32_t slotSize = sharedRing->slotSize;
+    if (magic != CLAY_RENDER_RING__MAGIC || version != CLAY_RENDER_RING__VERSION || slotCount <= 0
+        || slotSize < CLAY_RENDER_RING__COMMANDS_OFFSET || slotSize % CLAY_RENDER_RING__ALIGNMENT != 0
+        || (uint64_t)slotCount * (uint64_t)slotSize > memorySize - sizeof(Clay_RenderRing)) {
+        return false;
+    }
+    *consumer = CLAY__INIT(Clay_RenderRingConsumer) {
+        .ring = ring,
+        .slotCount = slotCount,
+        .slotSize = slotSize,
+        .readIndex = Clay_RenderRing__LoadAcquire(&ring->readIndex),
+        .commands = commands,
+        .commandCapacity = commandCapacity < 0 ? 0 : commandCapacity,
+    };
+    return true;
+}
+
+Clay_RenderRing_PublishResult Clay_RenderRing_Publish(Clay_RenderRing *ring, Clay_RenderCommandArray renderCommands) {
+    uint64_t writeIndex = ring->writeIndex;
+    if (writeIndex - Clay_RenderRing__LoadAcquire(&ring->readIndex) >= (uint64_t)ring->slotCount) {
+        return CLAY_RENDER_RING_PUBLISH_RING_FULL;
+    }
+
+    int64_t textOffset = CLAY_RENDER_RING__COMMANDS_OFFSET + (int64_t)renderCommands.length * (int64_t)sizeof(Clay_RenderCommand);
+    if (textOffset > ring->slotSize) {
+        return CLAY_RENDER_RING_PUBLISH_FRAME_TOO_LARGE;
+    }
+
+    uint8_t *slot = Clay_RenderRing__GetSlot(ring, ring->slotCount, ring->slotSize, writeIndex);
+    Clay_RenderRing__Frame *frame = (Clay_RenderRing__Frame *)slot;
+    Clay_RenderCommand *commands = (Clay_RenderCommand *)(slot + CLAY_RENDER_RING__COMMANDS_OFFSET);
+    if (renderCommands.length > 0) {
+        memcpy(commands, renderCommands.internalArray, (size_t)renderCommands.length * sizeof(Clay_RenderCommand));
+    }
+    int64_t textEnd = Clay_RenderRing__InternText(renderCommands, textOffset, ring->slotSize, slot, commands);
+    if (textEnd < 0) {
+        return CLAY_RENDER_RING_PUBLISH_FRAME_TOO_LARGE;
+    }
+    frame->frameIndex = writeIndex;
+    frame->commandCount = renderCommands.length;
+    frame->textOffset = (int32_t)textOffset;
+    frame->textLength = (int32_t)(textEnd - textOffset);
+    Clay_RenderRing__StoreRelease(&ring->writeIndex, writeIndex + 1);
+    return CLAY_RENDER_RING_PUBLISH_SUCCESS;
+}
+
+bool Clay_RenderRing_Acquire(Clay_RenderRingConsumer *consumer, Clay_RenderCommandArray *renderCommands) {
+    uint64_t readIndex = consumer->readIndex;
+    if (readIndex >= Clay_RenderRing__LoadAcquire(&consumer->ring->writeIndex)) {
+        return false;
+    }
+    uint8_t *slot = Clay_RenderRing__GetSlot(consumer->ring, consumer->slotCount, consumer->slotSize, readIndex);
+    // Read once, so the values checked are the values used
+    volatile Clay_RenderRing__Frame *frame = (volatile Clay_RenderRing__Frame *)slot;
+    uint64_t frameIndex = frame->frameIndex;
+    int32_t commandCount = frame->commandCount;
+    int64_t textOffset = frame->textOffset;
+    int64_t textEnd = textOffset + frame->textLength;
+    bool valid = frameIndex == readIndex && commandCount >= 0 && commandCount <= consumer->commandCapacity
+        && textOffset >= CLAY_RENDER_RING__COMMANDS_OFFSET + (int64_t)commandCount * (int64_t)sizeof(Clay_RenderCommand)
+        && textEnd >= textOffset && textEnd <= consumer->slotSize;
+    if (valid && commandCount > 0) {
+        // Validated in the consumer's own copy, which the producer can't change afterwards
+        memcpy(consumer->commands, slot + CLAY_RENDER_RING__COMMANDS_OFFSET, (size_t)commandCount * sizeof(Clay_RenderCommand));
+    }
+    for (int32_t i = 0; valid && i < commandCount; ++i) {
+        if (consumer->commands[i].commandType != CLAY_RENDER_COMMAND_TYPE_TEXT) {
+            continue;
+        }
+        Clay_StringSlice *text = &consumer->commands[i].renderData.text.stringContents;
+        uintptr_t offset = (uintptr_t)text->chars;
+        if (text->length < 0 || offset < (uintptr_t)textOffset || offset > (uintptr_t)textEnd || (uintptr_t)text->length > (uintptr_t)textEnd - offset) {
+            valid = false;
+            break;
+        }
+        text->chars = (const char *)slot + offset;
+        text->baseChars = text->chars;
+    }
+    if (!valid) {
+        consumer->rejectedFrameCount++;
+        Clay_RenderRing_Release(consumer);
+        return false;
+    }
+    renderCommands->capacity = commandCount;
+    renderCommands->length = commandCount;
+    renderCommands->internalArray = consumer->commands;
+    return true;
+}
+
+bool Clay_RenderRing_AcquireLatest(Clay_RenderRingConsumer *consumer, Clay_RenderCommandArray *renderCommands) {
+    uint64_t writeIndex = Clay_RenderRing__LoadAcquire(&consumer->ring->writeIndex);
+    if (writeIndex > consumer->readIndex + 1) {
+        consumer->readIndex = writeIndex - 1;
+        Clay_RenderRing__StoreRelease(&consumer->ring->readIndex, consumer->readIndex);
+    }
+    return Clay_RenderRing_Acquire(consumer, renderCommands);
+}
+
+void Clay_RenderRing_Release(Clay_RenderRingConsumer *consumer) {
+    consumer->readIndex++;
+    Clay_RenderRing__StoreRelease(&consumer->ring->readIndex, consumer->readIndex);
+}
+
+#endif /* CLAY_RENDER_RING_IMPLEMENTATION_INCLUDED */
+#endif /* CLAY_RENDER_RING_IMPLEMENTATION */
@@ -0,0 +1,184 @@
+// Decoder for the render stream format written by clay_render_stream.h.
+// See the format description at the top of that file.
+//
+// Usage from a wasm build that exports Clay_RenderStream_Encode:
+//
+//     let size = instance.exports.Clay_RenderStream_Encode(renderCommandsAddress, bufferAddress, bufferCapacity);
+//     let commands = decodeClayRenderStream(new DataView(instance.exports.memory.buffer, bufferAddress, size));
+//
+// Each command is a plain object:
+//     { commandType, id, zIndex, userData, boundingBox: { x, y, width, height }, renderData }
+// where renderData mirrors the Clay_RenderData variant for commandType, with colors as { r, g, b, a },
+// cornerRadius as { topLeft, topRight, bottomLeft, bottomRight } and text as a decoded string.
+
+const CLAY_RENDER_STREAM_VERSION = 1;
+const CLAY_RENDER_STREAM_PALETTE_CAPACITY = 256;
+
+const CLAY_RENDER_STREAM_COMMAND_TYPE_NONE = 0;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_RECTANGLE = 1;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_BORDER = 2;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_TEXT = 3;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_IMAGE = 4;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_SCISSOR_START = 5;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_SCISSOR_END = 6;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_CUSTOM = 7;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_LAYER_BEGIN = 8;
+const CLAY_RENDER_STREAM_COMMAND_TYPE_LAYER_END = 9;
+
+function decodeClayRenderStream(dataView) {
+    let offset = 0;
+    let palette = [];
+    let textDecoder = new TextDecoder("utf-8");
+
+    function readByte() {
+        if (offset >= dataView.byteLength) {
+            throw "Clay render stream: unexpected end of stream";
+        }
+        return dataView.getUint8(offset++);
+    }
+    // Values above 2^53 (64 bit pointers) lose precision, which is fine for opaque handles in wasm32
+    function readVarint() {
+        let value = 0;
+        let scale = 1;
+        for (let shift = 0; shift < 64; shift += 7) {
+            let byte = readByte();
+            value += (byte & 0x7f) * scale;
+            scale *= 128;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw "Clay render stream: varint too long";
+    }
+    function readU32() {
+        let value = dataView.getUint32(offset, true);
+        offset += 4;
+        return value;
+    }
+    function readF32() {
+        let value = dataView.getFloat32(offset, true);
+        offset += 4;
+        return value;
+    }
+    function unZigZag(value) {
+        return value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+    }
+    function readNumber(prediction) {
+        let value = readVarint();
+        if (value % 2 === 1) {
+            return readF32();
+        }
+        return prediction + unZigZag(value / 2);
+    }
+    function readColor() {
+        let index = readVarint();
+        if (index < palette.length) {
+            return palette[index];
+        }
+        let color;
+        if (index === palette.length) {
+            color = { r: readByte(), g: readByte(), b: readByte(), a: readByte() };
+        } else if (index === palette.length + 1) {
+            color = { r: readF32(), g: readF32(), b: readF32(), a: readF32() };
+        } else {
+            throw "Clay render stream: invalid color index";
+        }
+        if (palette.length < CLAY_RENDER_STREAM_PALETTE_CAPACITY) {
+            palette.push(color);
+        }
+        return color;
+    }
+    function readCornerRadius() {
+        switch (readByte()) {
+            case 0: return { topLeft: 0, topRight: 0, bottomLeft: 0, bottomRight: 0 };
+            case 1: {
+                let radius = readNumber(0);
+                return { topLeft: radius, topRight: radius, bottomLeft: radius, bottomRight: radius };
+            }
+            case 2: return { topLeft: readNumber(0), topRight: readNumber(0), bottomLeft: readNumber(0), bottomRight: readNumber(0) };
+            default: throw "Clay render stream: invalid corner radius mode";
+        }
+    }
+    function readClip() {
+        let flags = readByte();
+        return { horizontal: (flags & 1) !== 0, vertical: (flags & 2) !== 0 };
+    }
+
+    if (dataView.byteLength < 5
+        || dataView.getUint8(0) !== 0x43 || dataView.getUint8(1) !== 0x4c || dataView.getUint8(2) !== 0x52 || dataView.getUint8(3) !== 0x53
+        || dataView.getUint8(4) !== CLAY_RENDER_STREAM_VERSION) {
+        throw "Clay render stream: invalid header";
+    }
+    offset = 5;
+    let commandCount = readVarint();
+    let commands = new Array(commandCount);
+    let boundingBox = { x: 0, y: 0, width: 0, height: 0 };
+    let id = 0;
+    let zIndex = 0;
+    for (let i = 0; i < commandCount; i++) {
+        let tag = readByte();
+        let commandType = tag & 0x0f;
+        if (tag & 0x20) id = readU32();
+        if (tag & 0x40) zIndex = unZigZag(readVarint());
+        let userData = (tag & 0x80) ? readVarint() : 0;
+        if (!(tag & 0x10)) {
+            boundingBox = {
+                x: readNumber(boundingBox.x),
+                y: readNumber(boundingBox.y),
+                width: readNumber(boundingBox.width),
+                height: readNumber(boundingBox.height),
+            };
+        }
+        let renderData = null;
+        switch (commandType) {
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_RECTANGLE: {
+                renderData = { backgroundColor: readColor(), cornerRadius: readCornerRadius() };
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_BORDER: {
+                let color = readColor();
+                let cornerRadius = readCornerRadius();
+                let width = { left: readVarint(), right: readVarint(), top: readVarint(), bottom: readVarint(), betweenChildren: readVarint() };
+                renderData = { color, cornerRadius, width };
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_TEXT: {
+                let textColor = readColor();
+                let fontId = readVarint();
+                let fontSize = readVarint();
+                let letterSpacing = readVarint();
+                let lineHeight = readVarint();
+                let length = readVarint();
+                if (offset + length > dataView.byteLength) {
+                    throw "Clay render stream: text runs past end of stream";
+                }
+                let stringContents = textDecoder.decode(new Uint8Array(dataView.buffer, dataView.byteOffset + offset, length));
+                offset += length;
+                renderData = { stringContents, textColor, fontId, fontSize, letterSpacing, lineHeight };
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_IMAGE: {
+                renderData = { backgroundColor: readColor(), cornerRadius: readCornerRadius(), imageData: readVarint() };
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_CUSTOM: {
+                renderData = { backgroundColor: readColor(), cornerRadius: readCornerRadius(), customData: readVarint() };
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_SCISSOR_START:
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_SCISSOR_END: {
+                renderData = readClip();
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_LAYER_END: {
+                renderData = { contentHash: readU32() };
+                break;
+            }
+            case CLAY_RENDER_STREAM_COMMAND_TYPE_NONE: break;
+            default: throw "Clay render stream: invalid command type";
+        }
+        commands[i] = { commandType, id, zIndex, userData, boundingBox, renderData };
+    }
+    return commands;
+}
@@ -0,0 +1,626 @@
+#ifndef CLAY_RENDER_STREAM_INCLUDED
+#define CLAY_RENDER_STREAM_INCLUDED (1)
+/*
+    clay_render_stream.h -- compact byte stream encoding of a Clay_RenderCommandArray
+
+    Do this:
+        #define CLAY_RENDER_STREAM_IMPLEMENTATION
+
+    before you include this file in *one* C file to create the implementation.
+    clay.h must be included before this file.
+
+    Clay_RenderCommand is sized for the largest Clay_RenderData variant, so a
+    SCISSOR_END costs as many bytes as a TEXT command. When render commands
+    leave the process (remote display, wasm -> JS) most of those bytes are
+    padding. This module writes a frame as a packed, versioned byte stream
+    with one variable length record per command, and decodes it back into
+    Clay_RenderCommands.
+
+    Encoding a frame:
+
+        int32_t size = Clay_RenderStream_Encode(renderCommands, buffer, capacity);
+        if (size > capacity) { grow buffer to size and encode again }
+
+    Decoding a frame:
+
+        int32_t count = Clay_RenderStream_PeekCommandCount(buffer, size);
+        Clay_RenderCommandArray commands = { .capacity = count, .internalArray = storage };
+        if (Clay_RenderStream_Decode(buffer, size, &commands)) { render commands }
+
+    Decoded TEXT commands point into the stream buffer, so it must outlive them.
+    userData, imageData and customData are carried as opaque integers and are
+    only meaningful inside the address space that produced them.
+
+    With CLAY_WASM defined the implementation doesn't use the C library, like
+    clay.h, and the three functions are exported from the wasm module. Build
+    with -mbulk-memory so that copies compile to memory.copy.
+
+    STREAM FORMAT (version 1)
+    =========================
+    All multi-byte integers are little endian. A "varint" is LEB128 (7 bits
+    per byte, high bit set on all but the last byte). "zigzag" maps signed to
+    unsigned integers as 0, -1, 1, -2, ...
+
+    header:     'C' 'L' 'R' 'S', u8 version, varint commandCount
+    record:     u8 tag, then fields in this order, each only if present
+
+        tag bits 0-3   Clay_RenderCommandType
+        tag bit  4     bounding box is identical to the previous record's, no box follows
+        tag bit  5     id differs from the previous record's, u32 id follows
+        tag bit  6     zIndex differs from the previous record's, zigzag varint follows
+        tag bit  7     userData is non null, varint follows
+
+        boundingBox    4 x number, each relative to the previous record's value
+        payload        depends on the command type, see below
+
+    number:     varint v. If bit 0 of v is clear, the value is the zigzag integer
+                v >> 1, added to the predicted value (the previous value for the
+                bounding box, 0 elsewhere). If v == 1, a raw f32 follows and
+                replaces the prediction.
+    color:      varint i. i < paletteCount reuses a palette entry. i == paletteCount
+                is followed by 4 x u8 (r, g, b, a), i == paletteCount + 1 by 4 x f32.
+                Either way the color is appended to the palette while it holds
+                fewer than CLAY_RENDER_STREAM_PALETTE_CAPACITY colors.
+    corners:    u8 mode. 0: all zero, 1: one number for all four, 2: four numbers
+                (topLeft, topRight, bottomLeft, bottomRight).
+
+    RECTANGLE      color, corners
+    BORDER         color, corners, 5 x varint width (left, right, top, bottom, betweenChildren)
+    TEXT           color, varint fontId, fontSize, letterSpacing, lineHeight, varint length, bytes
+    IMAGE          color, corners, varint imageData
+    CUSTOM         color, corners, varint customData
+    SCISSOR_START  u8 (bit 0 horizontal, bit 1 vertical)
+    SCISSOR_END    u8 (bit 0 horizontal, bit 1 vertical)
+    LAYER_BEGIN    u32 contentHash
+    LAYER_END      u32 contentHash
+    NONE           nothing
+
+    renderers/stream/clay-render-stream.js decodes the same format in JavaScript.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CLAY_HEADER
+#error "Please include clay.h before clay_render_stream.h"
+#endif
+
+#define CLAY_RENDER_STREAM_VERSION 1
+#define CLAY_RENDER_STREAM_PALETTE_CAPACITY 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Writes renderCommands into buffer as a render stream and returns the size of the encoded stream in bytes.
+// If the return value is larger than capacity, nothing useful was written and the frame should be encoded
+// again into a buffer of at least that size.
+int32_t Clay_RenderStream_Encode(Clay_RenderCommandArray renderCommands, uint8_t *buffer, int32_t capacity);
+// Returns the number of render commands in the stream, or -1 if the stream header is not valid.
+int32_t Clay_RenderStream_PeekCommandCount(const uint8_t *stream, int32_t length);
+// Decodes the stream into output->internalArray, which must have room for output->capacity commands,
+// and sets output->length. Returns false if the stream is malformed or does not fit.
+bool Clay_RenderStream_Decode(const uint8_t *stream, int32_t length, Clay_RenderCommandArray *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLAY_RENDER_STREAM_INCLUDED */
+
+#ifdef CLAY_RENDER_STREAM_IMPLEMENTATION
+#ifndef CLAY_RENDER_STREAM_IMPLEMENTATION_INCLUDED
+#define CLAY_RENDER_STREAM_IMPLEMENTATION_INCLUDED (1)
+#ifdef CLAY_WASM
+#define CLAY_RENDER_STREAM__MEMCPY __builtin_memcpy
+#define CLAY_RENDER_STREAM__MEMSET __builtin_memset
+#else
+#include <string.h>
+#define CLAY_RENDER_STREAM__MEMCPY memcpy
+#define CLAY_RENDER_STREAM__MEMSET memset
+#endif
+
+#define CLAY_RENDER_STREAM__TAG_TYPE_MASK 0x0f
+#define CLAY_RENDER_STREAM__TAG_SAME_BOX 0x10
+#define CLAY_RENDER_STREAM__TAG_ID 0x20
+#define CLAY_RENDER_STREAM__TAG_Z_INDEX 0x40
+#define CLAY_RENDER_STREAM__TAG_USER_DATA 0x80
+#define CLAY_RENDER_STREAM__HASH_CAPACITY (CLAY_RENDER_STREAM_PALETTE_CAPACITY * 2)
+// Integral numbers are stored shifted left by one zigzag bit and one tag bit, keep them well inside 32 bits
+#define CLAY_RENDER_STREAM__MAX_INTEGRAL 0x3fffffff
+
+typedef struct {
+    uint8_t *buffer;
+    int32_t capacity;
+    int32_t length;
+    Clay_Color palette[CLAY_RENDER_STREAM_PALETTE_CAPACITY];
+    int32_t paletteCount;
+    // Maps a color hash to palette index + 1, 0 is empty
+    int16_t paletteTable[CLAY_RENDER_STREAM__HASH_CAPACITY];
+} Clay_RenderStream__Encoder;
+
+typedef struct {
+    const uint8_t *stream;
+    int32_t length;
+    int32_t offset;
+    bool error;
+    Clay_Color palette[CLAY_RENDER_STREAM_PALETTE_CAPACITY];
+    int32_t paletteCount;
+} Clay_RenderStream__Decoder;
+
+static void Clay_RenderStream__WriteByte(Clay_RenderStream__Encoder *encoder, uint8_t value) {
+    if (encoder->length < encoder->capacity) {
+        encoder->buffer[encoder->length] = value;
+    }
+    encoder->length++;
+}
+
+static void Clay_RenderStream__WriteBytes(Clay_RenderStream__Encoder *encoder, const void *bytes, int32_t count) {
+    if (encoder->length + count <= encoder->capacity) {
+        CLAY_RENDER_STREAM__MEMCPY(encoder->buffer + encoder->length, bytes, count);
+    }
+    encoder->length += count;
+}
+
+static void Clay_RenderStream__WriteVarint(Clay_RenderStream__Encoder *encoder, uint64_t value) {
+    while (value >= 0x80) {
+        Clay_RenderStream__WriteByte(encoder, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    Clay_RenderStream__WriteByte(encoder, (uint8_t)value);
+}
+
+static void Clay_RenderStream__WriteU32(Clay_RenderStream__Encoder *encoder, uint32_t value) {
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    Clay_RenderStream__WriteBytes(encoder, bytes, 4);
+}
+
+static uint32_t Clay_RenderStream__FloatBits(float value) {
+    uint32_t bits;
+    CLAY_RENDER_STREAM__MEMCPY(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void Clay_RenderStream__WriteF32(Clay_RenderStream__Encoder *encoder, float value) {
+    Clay_RenderStream__WriteU32(encoder, Clay_RenderStream__FloatBits(value));
+}
+
+// Compares the bytes of two values, so that -0 and NaN payloads are told apart like the decoder needs them to be
+static bool Clay_RenderStream__SameBytes(const void *first, const void *second, int32_t size) {
+    for (int32_t i = 0; i < size; ++i) {
+        if (((const uint8_t *)first)[i] != ((const uint8_t *)second)[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t Clay_RenderStream__ZigZag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+// Writes value as an integral delta from prediction when that reproduces it exactly, otherwise as a raw float.
+// The sum is checked in double, which holds it without rounding, so decoders that add in float or in double both get value back.
+// Adding an integer never gives -0, so -0 is always written as a raw float.
+static void Clay_RenderStream__WriteNumber(Clay_RenderStream__Encoder *encoder, float value, float prediction) {
+    float delta = value - prediction;
+    if (delta >= -CLAY_RENDER_STREAM__MAX_INTEGRAL && delta <= CLAY_RENDER_STREAM__MAX_INTEGRAL) {
+        int32_t integral = (int32_t)delta;
+        if ((float)integral == delta && (double)prediction + (double)integral == (double)value && Clay_RenderStream__FloatBits(value) != 0x80000000u) {
+            Clay_RenderStream__WriteVarint(encoder, (uint64_t)Clay_RenderStream__ZigZag(integral) << 1);
+            return;
+        }
+    }
+    Clay_RenderStream__WriteByte(encoder, 1);
+    Clay_RenderStream__WriteF32(encoder, value);
+}
+
+// Compares bits rather than values, so that -0 is written as a float instead of as the byte 0
+static bool Clay_RenderStream__ColorIsBytes(Clay_Color color) {
+    float components[4] = { color.r, color.g, color.b, color.a };
+    for (int32_t i = 0; i < 4; ++i) {
+        if (!(components[i] >= 0 && components[i] <= 255) || Clay_RenderStream__FloatBits((float)(uint8_t)components[i]) != Clay_RenderStream__FloatBits(components[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Clay_RenderStream__WriteColor(Clay_RenderStream__Encoder *encoder, Clay_Color color) {
+    uint32_t bits[4];
+    CLAY_RENDER_STREAM__MEMCPY(bits, &color, sizeof(bits));
+    uint32_t hash = bits[0] * 0x9E3779B1u ^ bits[1] * 0x85EBCA77u ^ bits[2] * 0xC2B2AE3Du ^ bits[3] * 0x27D4EB2Fu;
+    int32_t slot = (int32_t)((hash ^ (hash >> 15)) % CLAY_RENDER_STREAM__HASH_CAPACITY);
+    while (encoder->paletteTable[slot] != 0) {
+        int32_t index = encoder->paletteTable[slot] - 1;
+        if (Clay_RenderStream__SameBytes(&encoder->palette[index], &color, sizeof(Clay_Color))) {
+            Clay_RenderStream__WriteVarint(encoder, (uint64_t)index);
+            return;
+        }
+        slot = (slot + 1) % CLAY_RENDER_STREAM__HASH_CAPACITY;
+    }
+    bool isBytes = Clay_RenderStream__ColorIsBytes(color);
+    Clay_RenderStream__WriteVarint(encoder, (uint64_t)encoder->paletteCount + (isBytes ? 0 : 1));
+    if (isBytes) {
+        uint8_t bytes[4] = { (uint8_t)color.r, (uint8_t)color.g, (uint8_t)color.b, (uint8_t)color.a };
+        Clay_RenderStream__WriteBytes(encoder, bytes, 4);
+    } else {
+        Clay_RenderStream__WriteF32(encoder, color.r);
+        Clay_RenderStream__WriteF32(encoder, color.g);
+        Clay_RenderStream__WriteF32(encoder, color.b);
+        Clay_RenderStream__WriteF32(encoder, color.a);
+    }
+    // The table is twice the palette capacity, so there is always a free slot while the palette has room
+    if (encoder->paletteCount < CLAY_RENDER_STREAM_PALETTE_CAPACITY) {
+        encoder->palette[encoder->paletteCount] = color;
+        encoder->paletteTable[slot] = (int16_t)(++encoder->paletteCount);
+    }
+}
+
+// Radii are compared by their bits, so that -0 isn't written as 0
+static void Clay_RenderStream__WriteCornerRadius(Clay_RenderStream__Encoder *encoder, Clay_CornerRadius cornerRadius) {
+    uint32_t topLeft = Clay_RenderStream__FloatBits(cornerRadius.topLeft);
+    bool allSame = topLeft == Clay_RenderStream__FloatBits(cornerRadius.topRight) && topLeft == Clay_RenderStream__FloatBits(cornerRadius.bottomLeft) && topLeft == Clay_RenderStream__FloatBits(cornerRadius.bottomRight);
+    if (allSame && topLeft == 0) {
+        Clay_RenderStream__WriteByte(encoder, 0);
+    } else if (allSame) {
+        Clay_RenderStream__WriteByte(encoder, 1);
+        Clay_RenderStream__WriteNumber(encoder, cornerRadius.topLeft, 0);
+    } else {
+        Clay_RenderStream__WriteByte(encoder, 2);
+        Clay_RenderStream__WriteNumber(encoder, cornerRadius.topLeft, 0);
+        Clay_RenderStream__WriteNumber(encoder, cornerRadius.topRight, 0);
+        Clay_RenderStream__WriteNumber(encoder, cornerRadius.bottomLeft, 0);
+        Clay_RenderStream__WriteNumber(encoder, cornerRadius.bottomRight, 0);
+    }
+}
+
+static uint8_t Clay_RenderStream__ClipFlags(Clay_ClipRenderData clip) {
+    return (uint8_t)((clip.horizontal ? 1 : 0) | (clip.vertical ? 2 : 0));
+}
+
+CLAY_WASM_EXPORT("Clay_RenderStream_Encode")
+int32_t Clay_RenderStream_Encode(Clay_RenderCommandArray renderCommands, uint8_t *buffer, int32_t capacity) {
+    Clay_RenderStream__Encoder encoder;
+    encoder.buffer = buffer;
+    encoder.capacity = buffer ? capacity : 0;
+    encoder.length = 0;
+    encoder.paletteCount = 0;
+    CLAY_RENDER_STREAM__MEMSET(encoder.paletteTable, 0, sizeof(encoder.paletteTable));
+
+    const uint8_t header[5] = { 'C', 'L', 'R', 'S', CLAY_RENDER_STREAM_VERSION };
+    Clay_RenderStream__WriteBytes(&encoder, header, sizeof(header));
+    Clay_RenderStream__WriteVarint(&encoder, (uint64_t)renderCommands.length);
+
+    Clay_BoundingBox previousBox = { 0, 0, 0, 0 };
+    uint32_t previousId = 0;
+    int16_t previousZIndex = 0;
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        Clay_BoundingBox box = renderCommand->boundingBox;
+        uint8_t tag = (uint8_t)(renderCommand->commandType & CLAY_RENDER_STREAM__TAG_TYPE_MASK);
+        bool sameBox = Clay_RenderStream__SameBytes(&box, &previousBox, sizeof(Clay_BoundingBox));
+        if (sameBox) tag |= CLAY_RENDER_STREAM__TAG_SAME_BOX;
+        if (renderCommand->id != previousId) tag |= CLAY_RENDER_STREAM__TAG_ID;
+        if (renderCommand->zIndex != previousZIndex) tag |= CLAY_RENDER_STREAM__TAG_Z_INDEX;
+        if (renderCommand->userData) tag |= CLAY_RENDER_STREAM__TAG_USER_DATA;
+        Clay_RenderStream__WriteByte(&encoder, tag);
+        if (tag & CLAY_RENDER_STREAM__TAG_ID) {
+            Clay_RenderStream__WriteU32(&encoder, renderCommand->id);
+        }
+        if (tag & CLAY_RENDER_STREAM__TAG_Z_INDEX) {
+            Clay_RenderStream__WriteVarint(&encoder, Clay_RenderStream__ZigZag(renderCommand->zIndex));
+        }
+        if (tag & CLAY_RENDER_STREAM__TAG_USER_DATA) {
+            Clay_RenderStream__WriteVarint(&encoder, (uint64_t)(uintptr_t)renderCommand->userData);
+        }
+        if (!sameBox) {
+            Clay_RenderStream__WriteNumber(&encoder, box.x, previousBox.x);
+            Clay_RenderStream__WriteNumber(&encoder, box.y, previousBox.y);
+            Clay_RenderStream__WriteNumber(&encoder, box.width, previousBox.width);
+            Clay_RenderStream__WriteNumber(&encoder, box.height, previousBox.height);
+        }
+        previousBox = box;
+        previousId = renderCommand->id;
+        previousZIndex = renderCommand->zIndex;
+
+        Clay_RenderData *renderData = &renderCommand->renderData;
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+                Clay_RenderStream__WriteColor(&encoder, renderData->rectangle.backgroundColor);
+                Clay_RenderStream__WriteCornerRadius(&encoder, renderData->rectangle.cornerRadius);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                Clay_BorderRenderData *border = &renderData->border;
+                Clay_RenderStream__WriteColor(&encoder, border->color);
+                Clay_RenderStream__WriteCornerRadius(&encoder, border->cornerRadius);
+                Clay_RenderStream__WriteVarint(&encoder, border->width.left);
+                Clay_RenderStream__WriteVarint(&encoder, border->width.right);
+                Clay_RenderStream__WriteVarint(&encoder, border->width.top);
+                Clay_RenderStream__WriteVarint(&encoder, border->width.bottom);
+                Clay_RenderStream__WriteVarint(&encoder, border->width.betweenChildren);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_TextRenderData *text = &renderData->text;
+                Clay_RenderStream__WriteColor(&encoder, text->textColor);
+                Clay_RenderStream__WriteVarint(&encoder, text->fontId);
+                Clay_RenderStream__WriteVarint(&encoder, text->fontSize);
+                Clay_RenderStream__WriteVarint(&encoder, text->letterSpacing);
+                Clay_RenderStream__WriteVarint(&encoder, text->lineHeight);
+                Clay_RenderStream__WriteVarint(&encoder, (uint64_t)text->stringContents.length);
+                Clay_RenderStream__WriteBytes(&encoder, text->stringContents.chars, text->stringContents.length);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                Clay_RenderStream__WriteColor(&encoder, renderData->image.backgroundColor);
+                Clay_RenderStream__WriteCornerRadius(&encoder, renderData->image.cornerRadius);
+                Clay_RenderStream__WriteVarint(&encoder, (uint64_t)(uintptr_t)renderData->image.imageData);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                Clay_RenderStream__WriteColor(&encoder, renderData->custom.backgroundColor);
+                Clay_RenderStream__WriteCornerRadius(&encoder, renderData->custom.cornerRadius);
+                Clay_RenderStream__WriteVarint(&encoder, (uint64_t)(uintptr_t)renderData->custom.customData);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                Clay_RenderStream__WriteByte(&encoder, Clay_RenderStream__ClipFlags(renderData->clip));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: {
+                Clay_RenderStream__WriteU32(&encoder, renderData->layer.contentHash);
+                break;
+            }
+            default: break;
+        }
+    }
+    return encoder.length;
+}
+
+static uint8_t Clay_RenderStream__ReadByte(Clay_RenderStream__Decoder *decoder) {
+    if (decoder->offset >= decoder->length) {
+        decoder->error = true;
+        return 0;
+    }
+    return decoder->stream[decoder->offset++];
+}
+
+static uint64_t Clay_RenderStream__ReadVarint(Clay_RenderStream__Decoder *decoder) {
+    uint64_t value = 0;
+    for (int32_t shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = Clay_RenderStream__ReadByte(decoder);
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    decoder->error = true;
+    return 0;
+}
+
+static uint32_t Clay_RenderStream__ReadU32(Clay_RenderStream__Decoder *decoder) {
+    uint32_t value = 0;
+    for (int32_t i = 0; i < 4; ++i) {
+        value |= (uint32_t)Clay_RenderStream__ReadByte(decoder) << (i * 8);
+    }
+    return value;
+}
+
+static float Clay_RenderStream__ReadF32(Clay_RenderStream__Decoder *decoder) {
+    uint32_t bits = Clay_RenderStream__ReadU32(decoder);
+    float value;
+    CLAY_RENDER_STREAM__MEMCPY(&value, &bits, sizeof(value));
+    return value;
+}
+
+static int32_t Clay_RenderStream__UnZigZag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static float Clay_RenderStream__ReadNumber(Clay_RenderStream__Decoder *decoder, float prediction) {
+    uint64_t value = Clay_RenderStream__ReadVarint(decoder);
+    if (value & 1) {
+        return Clay_RenderStream__ReadF32(decoder);
+    }
+    return prediction + (float)Clay_RenderStream__UnZigZag((uint32_t)(value >> 1));
+}
+
+static Clay_Color Clay_RenderStream__ReadColor(Clay_RenderStream__Decoder *decoder) {
+    uint64_t index = Clay_RenderStream__ReadVarint(decoder);
+    if (index < (uint64_t)decoder->paletteCount) {
+        return decoder->palette[index];
+    }
+    Clay_Color color = { 0, 0, 0, 0 };
+    if (index == (uint64_t)decoder->paletteCount) {
+        color.r = Clay_RenderStream__ReadByte(decoder);
+        color.g = Clay_RenderStream__ReadByte(decoder);
+        color.b = Clay_RenderStream__ReadByte(decoder);
+        color.a = Clay_RenderStream__ReadByte(decoder);
+    } else if (index == (uint64_t)decoder->paletteCount + 1) {
+        color.r = Clay_RenderStream__ReadF32(decoder);
+        color.g = Clay_RenderStream__ReadF32(decoder);
+        color.b = Clay_RenderStream__ReadF32(decoder);
+        color.a = Clay_RenderStream__ReadF32(decoder);
+    } else {
+        decoder->error = true;
+        return color;
+    }
+    if (decoder->paletteCount < CLAY_RENDER_STREAM_PALETTE_CAPACITY) {
+        decoder->palette[decoder->paletteCount++] = color;
+    }
+    return color;
+}
+
+static Clay_CornerRadius Clay_RenderStream__ReadCornerRadius(Clay_RenderStream__Decoder *decoder) {
+    Clay_CornerRadius cornerRadius = { 0, 0, 0, 0 };
+    switch (Clay_RenderStream__ReadByte(decoder)) {
+        case 0: break;
+        case 1: {
+            float radius = Clay_RenderStream__ReadNumber(decoder, 0);
+            cornerRadius.topLeft = radius;
+            cornerRadius.topRight = radius;
+            cornerRadius.bottomLeft = radius;
+            cornerRadius.bottomRight = radius;
+            break;
+        }
+        case 2: {
+            cornerRadius.topLeft = Clay_RenderStream__ReadNumber(decoder, 0);
+            cornerRadius.topRight = Clay_RenderStream__ReadNumber(decoder, 0);
+            cornerRadius.bottomLeft = Clay_RenderStream__ReadNumber(decoder, 0);
+            cornerRadius.bottomRight = Clay_RenderStream__ReadNumber(decoder, 0);
+            break;
+        }
+        default: decoder->error = true;
+    }
+    return cornerRadius;
+}
+
+static Clay_ClipRenderData Clay_RenderStream__ReadClip(Clay_RenderStream__Decoder *decoder) {
+    uint8_t flags = Clay_RenderStream__ReadByte(decoder);
+    Clay_ClipRenderData clip;
+    clip.horizontal = (flags & 1) != 0;
+    clip.vertical = (flags & 2) != 0;
+    return clip;
+}
+
+static uint16_t Clay_RenderStream__ReadU16Varint(Clay_RenderStream__Decoder *decoder) {
+    uint64_t value = Clay_RenderStream__ReadVarint(decoder);
+    if (value > UINT16_MAX) {
+        decoder->error = true;
+    }
+    return (uint16_t)value;
+}
+
+static int32_t Clay_RenderStream__ReadHeader(Clay_RenderStream__Decoder *decoder) {
+    if (decoder->length < 5 || !Clay_RenderStream__SameBytes(decoder->stream, "CLRS", 4) || decoder->stream[4] != CLAY_RENDER_STREAM_VERSION) {
+        return -1;
+    }
+    decoder->offset = 5;
+    uint64_t commandCount = Clay_RenderStream__ReadVarint(decoder);
+    if (decoder->error || commandCount > INT32_MAX) {
+        return -1;
+    }
+    return (int32_t)commandCount;
+}
+
+CLAY_WASM_EXPORT("Clay_RenderStream_PeekCommandCount")
+int32_t Clay_RenderStream_PeekCommandCount(const uint8_t *stream, int32_t length) {
+    Clay_RenderStream__Decoder decoder;
+    decoder.stream = stream;
+    decoder.length = length;
+    decoder.offset = 0;
+    decoder.error = false;
+    return Clay_RenderStream__ReadHeader(&decoder);
+}
+
+CLAY_WASM_EXPORT("Clay_RenderStream_Decode")
+bool Clay_RenderStream_Decode(const uint8_t *stream, int32_t length, Clay_RenderCommandArray *output) {
+    Clay_RenderStream__Decoder decoder;
+    decoder.stream = stream;
+    decoder.length = length;
+    decoder.offset = 0;
+    decoder.error = false;
+    decoder.paletteCount = 0;
+    output->length = 0;
+    int32_t commandCount = Clay_RenderStream__ReadHeader(&decoder);
+    if (commandCount < 0 || commandCount > output->capacity) {
+        return false;
+    }
+
+    Clay_BoundingBox previousBox = { 0, 0, 0, 0 };
+    uint32_t previousId = 0;
+    int16_t previousZIndex = 0;
+    for (int32_t i = 0; i < commandCount && !decoder.error; ++i) {
+        Clay_RenderCommand *renderCommand = &output->internalArray[i];
+        CLAY_RENDER_STREAM__MEMSET(renderCommand, 0, sizeof(Clay_RenderCommand));
+        uint8_t tag = Clay_RenderStream__ReadByte(&decoder);
+        renderCommand->commandType = (Clay_RenderCommandType)(tag & CLAY_RENDER_STREAM__TAG_TYPE_MASK);
+        renderCommand->id = (tag & CLAY_RENDER_STREAM__TAG_ID) ? Clay_RenderStream__ReadU32(&decoder) : previousId;
+        renderCommand->zIndex = (tag & CLAY_RENDER_STREAM__TAG_Z_INDEX) ? (int16_t)Clay_RenderStream__UnZigZag((uint32_t)Clay_RenderStream__ReadVarint(&decoder)) : previousZIndex;
+        if (tag & CLAY_RENDER_STREAM__TAG_USER_DATA) {
+            renderCommand->userData = (void *)(uintptr_t)Clay_RenderStream__ReadVarint(&decoder);
+        }
+        if (!(tag & CLAY_RENDER_STREAM__TAG_SAME_BOX)) {
+            previousBox.x = Clay_RenderStream__ReadNumber(&decoder, previousBox.x);
+            previousBox.y = Clay_RenderStream__ReadNumber(&decoder, previousBox.y);
+            previousBox.width = Clay_RenderStream__ReadNumber(&decoder, previousBox.width);
+            previousBox.height = Clay_RenderStream__ReadNumber(&decoder, previousBox.height);
+        }
+        renderCommand->boundingBox = previousBox;
+        previousId = renderCommand->id;
+        previousZIndex = renderCommand->zIndex;
+
+        Clay_RenderData *renderData = &renderCommand->renderData;
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+                renderData->rectangle.backgroundColor = Clay_RenderStream__ReadColor(&decoder);
+                renderData->rectangle.cornerRadius = Clay_RenderStream__ReadCornerRadius(&decoder);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                Clay_BorderRenderData *border = &renderData->border;
+                border->color = Clay_RenderStream__ReadColor(&decoder);
+                border->cornerRadius = Clay_RenderStream__ReadCornerRadius(&decoder);
+                border->width.left = Clay_RenderStream__ReadU16Varint(&decoder);
+                border->width.right = Clay_RenderStream__ReadU16Varint(&decoder);
+                border->width.top = Clay_RenderStream__ReadU16Varint(&decoder);
+                border->width.bottom = Clay_RenderStream__ReadU16Varint(&decoder);
+                border->width.betweenChildren = Clay_RenderStream__ReadU16Varint(&decoder);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_TextRenderData *text = &renderData->text;
+                text->textColor = Clay_RenderStream__ReadColor(&decoder);
+                text->fontId = Clay_RenderStream__ReadU16Varint(&decoder);
+                text->fontSize = Clay_RenderStream__ReadU16Varint(&decoder);
+                text->letterSpacing = Clay_RenderStream__ReadU16Varint(&decoder);
+                text->lineHeight = Clay_RenderStream__ReadU16Varint(&decoder);
+                uint64_t textLength = Clay_RenderStream__ReadVarint(&decoder);
+                if (textLength > (uint64_t)(decoder.length - decoder.offset)) {
+                    decoder.error = true;
+                    break;
+                }
+                text->stringContents.length = (int32_t)textLength;
+                text->stringContents.chars = (const char *)(decoder.stream + decoder.offset);
+                text->stringContents.baseChars = text->stringContents.chars;
+                decoder.offset += (int32_t)textLength;
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                renderData->image.backgroundColor = Clay_RenderStream__ReadColor(&decoder);
+                renderData->image.cornerRadius = Clay_RenderStream__ReadCornerRadius(&decoder);
+                renderData->image.imageData = (void *)(uintptr_t)Clay_RenderStream__ReadVarint(&decoder);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                renderData->custom.backgroundColor = Clay_RenderStream__ReadColor(&decoder);
+                renderData->custom.cornerRadius = Clay_RenderStream__ReadCornerRadius(&decoder);
+                renderData->custom.customData = (void *)(uintptr_t)Clay_RenderStream__ReadVarint(&decoder);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                renderData->clip = Clay_RenderStream__ReadClip(&decoder);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: {
+                renderData->layer.contentHash = Clay_RenderStream__ReadU32(&decoder);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_NONE: break;
+            default: decoder.error = true;
+        }
+    }
+    if (decoder.error) {
+        return false;
+    }
+    output->length = commandCount;
+    return true;
+}
+
+#endif /* CLAY_RENDER_STREAM_IMPLEMENTATION_INCLUDED */
+#endif /* CLAY_RENDER_STREAM_IMPLEMENTATION */
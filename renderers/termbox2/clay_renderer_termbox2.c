@@ -1446,6 +1446,9 @@ void Clay_Termbox_Render(Clay_RenderCommandArray commands)
         }
 
         switch (command->commandType) {
+            // Layers are only a caching hint, their contents are drawn as usual
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
             default: {
                 clay_tb_assert(false, "Unhandled command: %d\n", command->commandType);
             }
@@ -180,6 +180,9 @@ void Clay_Terminal_Render(Clay_RenderCommandArray renderCommands, int width, int
                 }
                 break;
             }
+            // Layers are only a caching hint, their contents are drawn as usual
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
             default: {
                 printf("Error: unhandled render command.");
 #ifdef CLAY_OVERFLOW_TRAP
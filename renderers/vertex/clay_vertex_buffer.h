@@ -0,0 +1,361 @@
+#ifndef CLAY_VERTEX_BUFFER_INCLUDED
+#define CLAY_VERTEX_BUFFER_INCLUDED (1)
+/*
+    clay_vertex_buffer.h -- renderer agnostic vertex and index buffer generation for Clay render commands
+
+    Do this:
+        #define CLAY_VERTEX_BUFFER_IMPLEMENTATION
+
+    before you include this file in *one* C file to create the implementation.
+    clay.h must be included before this file.
+
+    Converts the rectangles, borders and images in a Clay_RenderCommandArray into
+    a single interleaved vertex buffer and a matching index buffer. Every command
+    becomes one quad (4 vertices, 6 indices). Instead of tessellating rounded
+    corners, each vertex carries the parameters of a rounded rectangle signed
+    distance field, so a single fragment shader draws crisp fills, borders and
+    rounded image corners at any scale.
+
+    The output is a list of draw ranges in render command order. A backend uploads
+    the two buffers once per frame and then walks the ranges:
+
+        Clay_VertexBuffer buffer = { vertices, vertexCapacity, 0, indices, indexCapacity, 0, ranges, rangeCapacity, 0 };
+        if (!Clay_VertexBuffer_Build(&buffer, renderCommands)) {
+            // buffer.vertexCount, indexCount and drawRangeCount hold the required sizes, grow and build again
+        }
+        upload(buffer.vertices, buffer.vertexCount, buffer.indices, buffer.indexCount);
+        for (int32_t i = 0; i < buffer.drawRangeCount; ++i) {
+            Clay_VertexDrawRange *range = &buffer.drawRanges[i];
+            set_scissor(range->scissorEnabled, range->scissor);
+            if (range->renderCommandIndex >= 0) {
+                draw_text_or_custom(&renderCommands.internalArray[range->renderCommandIndex]);
+            } else {
+                bind_texture(range->imageData); // NULL for untextured quads
+                draw_indexed(range->indexStart, range->indexCount);
+            }
+        }
+
+    TEXT and CUSTOM commands are not converted. They appear as draw ranges with a
+    renderCommandIndex, so the backend can draw them in the right order.
+
+    Image tint follows the other renderers: a backgroundColor of {0, 0, 0, 0} draws
+    the image untinted.
+
+    Nested SCISSOR_START commands are intersected with the enclosing scissor, and
+    SCISSOR_END restores it. Clip elements nested deeper than
+    CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH keep the deepest scissor until the
+    nesting is back within that depth, so they clip too much rather than too little.
+
+    The vertex fill has an SSE2 path on x86_64 that follows clay.h and is disabled
+    by CLAY_DISABLE_SIMD.
+
+    REFERENCE FRAGMENT SHADER (GLSL)
+    ================================
+        in vec2 uv; in vec2 local; in vec2 halfSize; in vec4 cornerRadius; in vec4 borderWidth; in vec4 color;
+        uniform sampler2D image; uniform bool textured;
+        float roundedBox(vec2 p, vec2 b, float r) { vec2 q = abs(p) - b + r; return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r; }
+        float cornerFor(vec2 p, vec4 r) { return p.x < 0.0 ? (p.y < 0.0 ? r.x : r.w) : (p.y < 0.0 ? r.y : r.z); }
+        void main() {
+            float outer = roundedBox(local, halfSize, cornerFor(local, cornerRadius));
+            float alpha = clamp(0.5 - outer, 0.0, 1.0);
+            if (any(greaterThan(borderWidth, vec4(0.0)))) {
+                // borderWidth is left, top, right, bottom
+                vec2 innerCenter = vec2(borderWidth.x - borderWidth.z, borderWidth.y - borderWidth.w) * 0.5;
+                vec2 innerHalf = halfSize - vec2(borderWidth.x + borderWidth.z, borderWidth.y + borderWidth.w) * 0.5;
+                vec2 p = local - innerCenter;
+                float inner = roundedBox(p, max(innerHalf, 0.0), max(cornerFor(p, cornerRadius) - max(max(borderWidth.x, borderWidth.y), max(borderWidth.z, borderWidth.w)), 0.0));
+                alpha *= clamp(inner + 0.5, 0.0, 1.0);
+            }
+            vec4 base = textured ? texture(image, uv) * color : color;
+            fragColor = vec4(base.rgb, base.a * alpha);
+        }
+*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CLAY_HEADER
+#error "Please include clay.h before clay_vertex_buffer.h"
+#endif
+
+#ifndef CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH
+#define CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH 64
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Clay_Vertex {
+    // Position in layout coordinates
+    float x, y;
+    // Texture coordinates, 0 to 1 across the quad
+    float u, v;
+    // Offset of this vertex from the center of the quad, interpolated across the quad to evaluate the signed distance field
+    float localX, localY;
+    float halfWidth, halfHeight;
+    // topLeft, topRight, bottomRight, bottomLeft
+    float cornerRadius[4];
+    // left, top, right, bottom. All zero for filled quads.
+    float borderWidth[4];
+    // r, g, b, a
+    uint8_t color[4];
+} Clay_Vertex;
+
+typedef struct Clay_VertexDrawRange {
+    // The range of the index buffer to draw. Empty for ranges with a renderCommandIndex.
+    uint32_t indexStart;
+    uint32_t indexCount;
+    // The image of every quad in the range, or NULL for untextured quads.
+    void *imageData;
+    // The index of a TEXT or CUSTOM render command that the backend draws itself at this point, or -1.
+    int32_t renderCommandIndex;
+    // The intersection of the enclosing SCISSOR_START commands' bounding boxes, if any.
+    bool scissorEnabled;
+    Clay_BoundingBox scissor;
+} Clay_VertexDrawRange;
+
+// Caller provided storage. Clay_VertexBuffer_Build sets the counts.
+typedef struct Clay_VertexBuffer {
+    Clay_Vertex *vertices;
+    int32_t vertexCapacity;
+    int32_t vertexCount;
+    uint32_t *indices;
+    int32_t indexCapacity;
+    int32_t indexCount;
+    Clay_VertexDrawRange *drawRanges;
+    int32_t drawRangeCapacity;
+    int32_t drawRangeCount;
+} Clay_VertexBuffer;
+
+// Converts renderCommands into buffer. Returns false if any of the buffer's arrays was too small, in which case
+// the counts hold the sizes required and the frame should be built again with larger arrays.
+bool Clay_VertexBuffer_Build(Clay_VertexBuffer *buffer, Clay_RenderCommandArray renderCommands);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLAY_VERTEX_BUFFER_INCLUDED */
+
+#ifdef CLAY_VERTEX_BUFFER_IMPLEMENTATION
+#ifndef CLAY_VERTEX_BUFFER_IMPLEMENTATION_INCLUDED
+#define CLAY_VERTEX_BUFFER_IMPLEMENTATION_INCLUDED (1)
+#include <string.h>
+
+typedef struct {
+    bool scissorEnabled;
+    Clay_BoundingBox scissor;
+} Clay_VertexBuffer__Scissor;
+
+typedef struct {
+    bool scissorEnabled;
+    Clay_BoundingBox scissor;
+    // The scissor in effect before each open SCISSOR_START, up to CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH of them
+    Clay_VertexBuffer__Scissor scissorStack[CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH];
+    int32_t scissorDepth;
+    // A copy of the most recent draw range, which may not have fit in the buffer
+    Clay_VertexDrawRange lastRange;
+    bool hasLastRange;
+    bool fits;
+} Clay_VertexBuffer__State;
+
+static uint8_t Clay_VertexBuffer__ColorChannel(float value) {
+    return value <= 0 ? 0 : value >= 255 ? 255 : (uint8_t)(value + 0.5f);
+}
+
+static Clay_BoundingBox Clay_VertexBuffer__Intersect(Clay_BoundingBox a, Clay_BoundingBox b) {
+    float left = CLAY__MAX(a.x, b.x);
+    float top = CLAY__MAX(a.y, b.y);
+    float right = CLAY__MIN(a.x + a.width, b.x + b.width);
+    float bottom = CLAY__MIN(a.y + a.height, b.y + b.height);
+    return CLAY__INIT(Clay_BoundingBox) { left, top, CLAY__MAX(right - left, 0), CLAY__MAX(bottom - top, 0) };
+}
+
+static void Clay_VertexBuffer__PushScissor(Clay_VertexBuffer__State *state, Clay_BoundingBox box) {
+    if (state->scissorDepth < CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH) {
+        state->scissorStack[state->scissorDepth] = CLAY__INIT(Clay_VertexBuffer__Scissor) { state->scissorEnabled, state->scissor };
+    }
+    state->scissorDepth++;
+    state->scissor = state->scissorEnabled ? Clay_VertexBuffer__Intersect(state->scissor, box) : box;
+    state->scissorEnabled = true;
+}
+
+static void Clay_VertexBuffer__PopScissor(Clay_VertexBuffer__State *state) {
+    if (state->scissorDepth == 0) {
+        state->scissorEnabled = false;
+        return;
+    }
+    state->scissorDepth--;
+    if (state->scissorDepth < CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH) {
+        Clay_VertexBuffer__Scissor enclosing = state->scissorStack[state->scissorDepth];
+        state->scissorEnabled = enclosing.scissorEnabled;
+        state->scissor = enclosing.scissor;
+    }
+}
+
+static bool Clay_VertexBuffer__SameScissor(const Clay_VertexDrawRange *range, const Clay_VertexBuffer__State *state) {
+    if (range->scissorEnabled != state->scissorEnabled) {
+        return false;
+    }
+    return !state->scissorEnabled || memcmp(&range->scissor, &state->scissor, sizeof(Clay_BoundingBox)) == 0;
+}
+
+static void Clay_VertexBuffer__AddRange(Clay_VertexBuffer *buffer, Clay_VertexBuffer__State *state, void *imageData, int32_t renderCommandIndex) {
+    Clay_VertexDrawRange *range = &state->lastRange;
+    range->indexStart = (uint32_t)buffer->indexCount;
+    range->indexCount = 0;
+    range->imageData = imageData;
+    range->renderCommandIndex = renderCommandIndex;
+    range->scissorEnabled = state->scissorEnabled;
+    range->scissor = state->scissor;
+    state->hasLastRange = true;
+    if (buffer->drawRangeCount < buffer->drawRangeCapacity) {
+        buffer->drawRanges[buffer->drawRangeCount] = *range;
+    } else {
+        state->fits = false;
+    }
+    buffer->drawRangeCount++;
+}
+
+// Writes the 4 vertices of a quad. Everything but the first 6 floats is the same for all of them.
+static void Clay_VertexBuffer__WriteQuadVertices(Clay_Vertex *vertices, Clay_BoundingBox box, const float cornerRadius[4], const float borderWidth[4], const uint8_t color[4]) {
+    float halfWidth = box.width * 0.5f;
+    float halfHeight = box.height * 0.5f;
+    float centerX = box.x + halfWidth;
+    float centerY = box.y + halfHeight;
+    // Corner order: top left, top right, bottom right, bottom left
+    static const float signX[4] = { -1, 1, 1, -1 };
+    static const float signY[4] = { -1, -1, 1, 1 };
+    uint32_t packedColor;
+    memcpy(&packedColor, color, sizeof(packedColor));
+#if !defined(CLAY_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+    __m128 center = _mm_setr_ps(centerX, centerY, 0.5f, 0.5f);
+    __m128 extent = _mm_setr_ps(halfWidth, halfHeight, 0.5f, 0.5f);
+    __m128 halfSize = _mm_setr_ps(halfWidth, halfHeight, halfWidth, halfHeight);
+    __m128 corners = _mm_loadu_ps(cornerRadius);
+    __m128 borders = _mm_loadu_ps(borderWidth);
+    for (int32_t i = 0; i < 4; ++i) {
+        float *out = &vertices[i].x;
+        __m128 sign = _mm_setr_ps(signX[i], signY[i], signX[i], signY[i]);
+        // x, y, u, v
+        _mm_storeu_ps(out, _mm_add_ps(center, _mm_mul_ps(sign, extent)));
+        // localX, localY, halfWidth, halfHeight
+        _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_setr_ps(signX[i], signY[i], 1, 1), halfSize));
+        _mm_storeu_ps(out + 8, corners);
+        _mm_storeu_ps(out + 12, borders);
+        memcpy(vertices[i].color, &packedColor, sizeof(packedColor));
+    }
+#else
+    for (int32_t i = 0; i < 4; ++i) {
+        Clay_Vertex *vertex = &vertices[i];
+        vertex->x = centerX + signX[i] * halfWidth;
+        vertex->y = centerY + signY[i] * halfHeight;
+        vertex->u = 0.5f + signX[i] * 0.5f;
+        vertex->v = 0.5f + signY[i] * 0.5f;
+        vertex->localX = signX[i] * halfWidth;
+        vertex->localY = signY[i] * halfHeight;
+        vertex->halfWidth = halfWidth;
+        vertex->halfHeight = halfHeight;
+        memcpy(vertex->cornerRadius, cornerRadius, sizeof(vertex->cornerRadius));
+        memcpy(vertex->borderWidth, borderWidth, sizeof(vertex->borderWidth));
+        memcpy(vertex->color, &packedColor, sizeof(packedColor));
+    }
+#endif
+}
+
+static void Clay_VertexBuffer__AddQuad(Clay_VertexBuffer *buffer, Clay_VertexBuffer__State *state, Clay_BoundingBox box, Clay_Color color, Clay_CornerRadius cornerRadius, const float borderWidth[4], void *imageData) {
+    Clay_VertexDrawRange *lastRange = &state->lastRange;
+    if (!state->hasLastRange || lastRange->renderCommandIndex >= 0 || lastRange->imageData != imageData || !Clay_VertexBuffer__SameScissor(lastRange, state)) {
+        Clay_VertexBuffer__AddRange(buffer, state, imageData, -1);
+    }
+    lastRange->indexCount += 6;
+    if (buffer->drawRangeCount <= buffer->drawRangeCapacity) {
+        buffer->drawRanges[buffer->drawRangeCount - 1].indexCount = lastRange->indexCount;
+    }
+    int32_t firstVertex = buffer->vertexCount;
+    buffer->vertexCount += 4;
+    buffer->indexCount += 6;
+    if (buffer->vertexCount > buffer->vertexCapacity || buffer->indexCount > buffer->indexCapacity) {
+        state->fits = false;
+        return;
+    }
+    // Radii larger than half the quad would make the distance field meaningless
+    float maxRadius = CLAY__MIN(box.width, box.height) * 0.5f;
+    const float radii[4] = {
+        CLAY__MIN(cornerRadius.topLeft, maxRadius),
+        CLAY__MIN(cornerRadius.topRight, maxRadius),
+        CLAY__MIN(cornerRadius.bottomRight, maxRadius),
+        CLAY__MIN(cornerRadius.bottomLeft, maxRadius),
+    };
+    const uint8_t packedColor[4] = {
+        Clay_VertexBuffer__ColorChannel(color.r),
+        Clay_VertexBuffer__ColorChannel(color.g),
+        Clay_VertexBuffer__ColorChannel(color.b),
+        Clay_VertexBuffer__ColorChannel(color.a),
+    };
+    Clay_VertexBuffer__WriteQuadVertices(&buffer->vertices[firstVertex], box, radii, borderWidth, packedColor);
+    uint32_t *indices = &buffer->indices[buffer->indexCount - 6];
+    indices[0] = (uint32_t)firstVertex;
+    indices[1] = (uint32_t)firstVertex + 1;
+    indices[2] = (uint32_t)firstVertex + 2;
+    indices[3] = (uint32_t)firstVertex;
+    indices[4] = (uint32_t)firstVertex + 2;
+    indices[5] = (uint32_t)firstVertex + 3;
+}
+
+bool Clay_VertexBuffer_Build(Clay_VertexBuffer *buffer, Clay_RenderCommandArray renderCommands) {
+    static const float filled[4] = { 0, 0, 0, 0 };
+    Clay_VertexBuffer__State state;
+    memset(&state, 0, sizeof(state));
+    state.fits = true;
+    buffer->vertexCount = 0;
+    buffer->indexCount = 0;
+    buffer->drawRangeCount = 0;
+
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        Clay_BoundingBox box = renderCommand->boundingBox;
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+                Clay_RectangleRenderData *rectangle = &renderCommand->renderData.rectangle;
+                Clay_VertexBuffer__AddQuad(buffer, &state, box, rectangle->backgroundColor, rectangle->cornerRadius, filled, NULL);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                Clay_BorderRenderData *border = &renderCommand->renderData.border;
+                const float widths[4] = { (float)border->width.left, (float)border->width.top, (float)border->width.right, (float)border->width.bottom };
+                if (widths[0] > 0 || widths[1] > 0 || widths[2] > 0 || widths[3] > 0) {
+                    Clay_VertexBuffer__AddQuad(buffer, &state, box, border->color, border->cornerRadius, widths, NULL);
+                }
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                Clay_ImageRenderData *image = &renderCommand->renderData.image;
+                Clay_Color tint = image->backgroundColor;
+                if (tint.r == 0 && tint.g == 0 && tint.b == 0 && tint.a == 0) {
+                    tint = CLAY__INIT(Clay_Color) { 255, 255, 255, 255 };
+                }
+                Clay_VertexBuffer__AddQuad(buffer, &state, box, tint, image->cornerRadius, filled, image->imageData);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                Clay_VertexBuffer__AddRange(buffer, &state, NULL, i);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                Clay_VertexBuffer__PushScissor(&state, box);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                Clay_VertexBuffer__PopScissor(&state);
+                break;
+            }
+            default: break;
+        }
+    }
+    return state.fits;
+}
+
+#endif /* CLAY_VERTEX_BUFFER_IMPLEMENTATION_INCLUDED */
+#endif /* CLAY_VERTEX_BUFFER_IMPLEMENTATION */
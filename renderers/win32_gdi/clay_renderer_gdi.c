@@ -492,6 +492,9 @@ void Clay_Win32_Render(HWND hwnd, Clay_RenderCommandArray renderCommands, HFONT*
             //     break;
             // }
 
+        // Layers are only a caching hint, their contents are drawn as usual
+        case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+        case CLAY_RENDER_COMMAND_TYPE_LAYER_END: break;
         default:
             printf("Unhandled render command %d\r\n", renderCommand->commandType);
             break;
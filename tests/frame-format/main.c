@@ -0,0 +1,200 @@
+// Formats a seeded corpus of random conversions with Clay_FrameFormat and with the C library's snprintf, and compares the results.
+// Covers flags, widths and precisions given in the format or as * arguments, length modifiers, and doubles across their whole range,
+// including subnormal values, negative zero, infinities, NaN and values that are exactly halfway between two outputs.
+// Exits with a non zero status if any result differs.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CASE_COUNT 200000
+#define CASES_PER_FRAME 100
+#define MAX_OUTPUT 4096
+
+static uint64_t randomState = 12345;
+
+static uint64_t Random64(void) {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    return randomState;
+}
+
+static uint32_t Random(uint32_t range) {
+    return (uint32_t)(Random64() % range);
+}
+
+static double RandomDouble(void) {
+    double value;
+    uint64_t bits;
+    switch (Random(6)) {
+        // Any bit pattern, which covers subnormal values, infinities and NaN
+        case 0: bits = Random64(); memcpy(&value, &bits, sizeof(value)); return value;
+        // Decimal looking values, which often sit close to the rounding boundary of the precision they are printed with
+        case 1: return (double)((int64_t)Random(2000000) - 1000000) / 10000.0;
+        // Exact halves and quarters, which are ties
+        case 2: return (double)((int64_t)Random(4000) - 2000) / 8.0;
+        case 3: return (double)((int64_t)Random(2000) - 1000) * (Random(2) ? 1e-6 : 1e6) + (double)Random(1000) / 1000.0;
+        case 4: return Random(2) ? 0.0 : -0.0;
+        default: {
+            // Values within a few orders of magnitude of 1
+            bits = Random64() & 0x800fffffffffffffULL;
+            bits |= (uint64_t)(1023 - 30 + Random(60)) << 52;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+}
+
+typedef enum { ARGUMENT_INT, ARGUMENT_LONG, ARGUMENT_LONG_LONG, ARGUMENT_INTMAX, ARGUMENT_SIZE, ARGUMENT_PTRDIFF, ARGUMENT_DOUBLE, ARGUMENT_LONG_DOUBLE, ARGUMENT_STRING } ArgumentType;
+
+typedef struct {
+    char format[64];
+    ArgumentType type;
+    int32_t starCount;
+    int32_t stars[2];
+    int64_t integer;
+    double floating;
+    const char *string;
+} Case;
+
+static const char *strings[] = { "", "a", "clay", "layout engine" };
+
+static void GenerateCase(Case *testCase) {
+    static const char conversions[] = "diuxXofFcs";
+    char conversion = conversions[Random(sizeof(conversions) - 1)];
+    char *format = testCase->format;
+    int32_t length = 0;
+    format[length++] = '[';
+    format[length++] = '%';
+    bool numeric = conversion != 'c' && conversion != 's';
+    if (Random(2)) { format[length++] = '-'; }
+    if (numeric && Random(3) == 0) { format[length++] = '0'; }
+    if ((conversion == 'd' || conversion == 'i' || conversion == 'f' || conversion == 'F') && Random(3) == 0) { format[length++] = Random(2) ? '+' : ' '; }
+    if ((conversion == 'x' || conversion == 'X' || conversion == 'o' || conversion == 'f' || conversion == 'F') && Random(4) == 0) { format[length++] = '#'; }
+    testCase->starCount = 0;
+    switch (Random(4)) {
+        case 0: break;
+        case 1: length += sprintf(format + length, "%u", Random(30)); break;
+        case 2: format[length++] = '*'; testCase->stars[testCase->starCount++] = (int32_t)Random(60) - 20; break;
+        default: length += sprintf(format + length, "%u", 1 + Random(9)); break;
+    }
+    if (conversion != 'c' && Random(2)) {
+        format[length++] = '.';
+        uint32_t precisionType = Random(6);
+        if (precisionType == 0) {
+            format[length++] = '*';
+            testCase->stars[testCase->starCount++] = (int32_t)Random(30) - 5;
+        } else if (precisionType == 1 && (conversion == 'f' || conversion == 'F')) {
+            // Long enough to print the exact binary value of most doubles
+            length += sprintf(format + length, "%u", 300 + Random(900));
+        } else if (precisionType > 2) {
+            length += sprintf(format + length, "%u", Random(20));
+        }
+    }
+    if (conversion == 'f' || conversion == 'F') {
+        testCase->type = Random(8) == 0 ? ARGUMENT_LONG_DOUBLE : ARGUMENT_DOUBLE;
+        if (testCase->type == ARGUMENT_LONG_DOUBLE) { format[length++] = 'L'; }
+        testCase->floating = RandomDouble();
+    } else if (conversion == 's') {
+        testCase->type = ARGUMENT_STRING;
+        testCase->string = strings[Random(sizeof(strings) / sizeof(strings[0]))];
+    } else if (conversion == 'c') {
+        testCase->type = ARGUMENT_INT;
+        testCase->integer = 'a' + Random(26);
+    } else {
+        static const char *modifiers[] = { "", "hh", "h", "l", "ll", "j", "z", "t" };
+        static const ArgumentType modifierTypes[] = { ARGUMENT_INT, ARGUMENT_INT, ARGUMENT_INT, ARGUMENT_LONG, ARGUMENT_LONG_LONG, ARGUMENT_INTMAX, ARGUMENT_SIZE, ARGUMENT_PTRDIFF };
+        uint32_t modifier = Random(8);
+        length += sprintf(format + length, "%s", modifiers[modifier]);
+        testCase->type = modifierTypes[modifier];
+        uint64_t bits = Random64();
+        testCase->integer = (int64_t)(bits >> Random(64));
+        if (Random(8) == 0) { testCase->integer = 0; }
+    }
+    format[length++] = conversion;
+    format[length++] = ']';
+    format[length] = 0;
+}
+
+// Calls both formatters with the same arguments, cast to the type the format expects
+#define FORMAT_CASE(formatter, ...) do { \
+    switch (testCase->type) { \
+        case ARGUMENT_INT: formatter(__VA_ARGS__, (int)testCase->integer); break; \
+        case ARGUMENT_LONG: formatter(__VA_ARGS__, (long)testCase->integer); break; \
+        case ARGUMENT_LONG_LONG: formatter(__VA_ARGS__, (long long)testCase->integer); break; \
+        case ARGUMENT_INTMAX: formatter(__VA_ARGS__, (intmax_t)testCase->integer); break; \
+        case ARGUMENT_SIZE: formatter(__VA_ARGS__, (size_t)testCase->integer); break; \
+        case ARGUMENT_PTRDIFF: formatter(__VA_ARGS__, (ptrdiff_t)testCase->integer); break; \
+        case ARGUMENT_DOUBLE: formatter(__VA_ARGS__, testCase->floating); break; \
+        case ARGUMENT_LONG_DOUBLE: formatter(__VA_ARGS__, (long double)testCase->floating); break; \
+        case ARGUMENT_STRING: formatter(__VA_ARGS__, testCase->string); break; \
+    } \
+} while (0)
+
+#define EXPECTED(...) snprintf(expected, sizeof(expected), __VA_ARGS__)
+#define ACTUAL(...) actual = Clay_FrameFormat(__VA_ARGS__)
+
+static bool CheckCase(Case *testCase) {
+    char expected[MAX_OUTPUT];
+    Clay_String actual = CLAY__DEFAULT_STRUCT;
+    // The format isn't a literal, so the compiler can't check it against the arguments
+    const char *format = testCase->format;
+    if (testCase->starCount == 0) {
+        FORMAT_CASE(EXPECTED, format);
+        FORMAT_CASE(ACTUAL, format);
+    } else if (testCase->starCount == 1) {
+        FORMAT_CASE(EXPECTED, format, testCase->stars[0]);
+        FORMAT_CASE(ACTUAL, format, testCase->stars[0]);
+    } else {
+        FORMAT_CASE(EXPECTED, format, testCase->stars[0], testCase->stars[1]);
+        FORMAT_CASE(ACTUAL, format, testCase->stars[0], testCase->stars[1]);
+    }
+    if ((size_t)actual.length == strlen(expected) && memcmp(actual.chars, expected, (size_t)actual.length) == 0) {
+        return true;
+    }
+    printf("format \"%s\": expected %s, got %.*s\n", testCase->format, expected, (int)actual.length, actual.chars);
+    return false;
+}
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+int main(void) {
+    Clay_SetFrameStringCapacity(CASES_PER_FRAME * MAX_OUTPUT);
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+
+    int32_t failures = 0;
+    Case testCase;
+    for (int32_t frame = 0; frame < CASE_COUNT / CASES_PER_FRAME; ++frame) {
+        Clay_BeginLayout();
+        for (int32_t i = 0; i < CASES_PER_FRAME; ++i) {
+            GenerateCase(&testCase);
+            if (!CheckCase(&testCase) && ++failures >= 20) {
+                return 1;
+            }
+        }
+        Clay_EndLayout();
+    }
+
+    // The arguments after a * precision have to line up
+    Clay_BeginLayout();
+    char expected[MAX_OUTPUT];
+    snprintf(expected, sizeof(expected), "%.*f %d %s", 5, 29844.0033, 7, "end");
+    Clay_String result = Clay_FrameFormat("%.*f %d %s", 5, 29844.0033, 7, "end");
+    if ((size_t)result.length != strlen(expected) || memcmp(result.chars, expected, (size_t)result.length) != 0) {
+        printf("format \"%%.*f %%d %%s\": expected %s, got %.*s\n", expected, (int)result.length, result.chars);
+        failures++;
+    }
+    Clay_EndLayout();
+
+    printf("%d cases, %d failures\n", CASE_COUNT, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+// Lays out CONTEXT_COUNT contexts concurrently, one thread each, with the context variants of the API, and checks that every
+// frame matches the same contexts laid out one after another on the main thread. Exits with a non zero status on any difference.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CONTEXT_COUNT 8
+#define FRAME_COUNT 50
+#define ROW_COUNT 200
+
+static const char *words = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor incididunt ut labore";
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+// Two different measure functions, so that each context has to use its own
+static Clay_Dimensions MeasureTextNarrow(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.5f, .height = (float)config->fontSize };
+}
+
+static Clay_Dimensions MeasureTextWide(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.7f + *(float *)userData, .height = (float)config->fontSize + 2 };
+}
+
+typedef struct {
+    Clay_Context *context;
+    float extraWidth;
+    int32_t index;
+    uint64_t hashes[FRAME_COUNT];
+    bool currentContextChanged;
+} Instance;
+
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ ((const uint8_t *)data)[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t HashRenderCommands(Clay_RenderCommandArray renderCommands) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        hash = HashBytes(hash, &renderCommand->boundingBox, sizeof(renderCommand->boundingBox));
+        hash = HashBytes(hash, &renderCommand->id, sizeof(renderCommand->id));
+        hash = HashBytes(hash, &renderCommand->commandType, sizeof(renderCommand->commandType));
+        if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+            Clay_StringSlice text = renderCommand->renderData.text.stringContents;
+            hash = HashBytes(hash, text.chars, (size_t)text.length);
+        }
+    }
+    return hash;
+}
+
+static void LayoutFrame(Instance *instance, int32_t frame) {
+    Clay_SetLayoutDimensionsCtx(instance->context, (Clay_Dimensions) { 600.0f + (float)((frame * 37 + instance->index * 11) % 400), 800 });
+    Clay_SetPointerStateCtx(instance->context, (Clay_Vector2) { (float)(frame * 13 % 600), (float)(frame * 7 % 800) }, frame % 3 == 0);
+    Clay_UpdateScrollContainersCtx(instance->context, true, (Clay_Vector2) { 0, -3.0f * (float)(frame % 5) }, 0.016f);
+    Clay_BeginLayoutCtx(instance->context);
+    CLAY({ .id = CLAY_ID("Outer"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .padding = CLAY_PADDING_ALL(8), .childGap = 4 } }) {
+        CLAY({ .id = CLAY_ID("List"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 2 }, .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() } }) {
+            for (int32_t row = 0; row < ROW_COUNT; ++row) {
+                CLAY({ .id = CLAY_IDI("Row", row), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .childGap = 3 }, .backgroundColor = { 40, 40, 40, 255 } }) {
+                    CLAY({ .layout = { .sizing = { CLAY_SIZING_PERCENT(0.25f), CLAY_SIZING_FIXED(12) } }, .backgroundColor = { 90, 90, 90, 255 } }) {}
+                    CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0, (float)(60 + (row + instance->index) % 50)), CLAY_SIZING_FIT(0) } } }) {
+                        Clay_String text = { .length = 10 + (row * 7 + frame) % 80, .chars = words };
+                        CLAY_TEXT(text, CLAY_TEXT_CONFIG({ .fontSize = (uint16_t)(12 + instance->index % 3), .textColor = { 255, 255, 255, 255 } }));
+                    }
+                }
+            }
+        }
+        CLAY({ .id = CLAY_ID("Tooltip"), .floating = { .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID, .parentId = CLAY_IDI("Row", frame % ROW_COUNT).id, .offset = { 20, 4 } }, .layout = { .padding = CLAY_PADDING_ALL(4) }, .backgroundColor = { 0, 0, 0, 255 } }) {
+            CLAY_TEXT(CLAY_STRING("tooltip text"), CLAY_TEXT_CONFIG({ .fontSize = 12, .textColor = { 255, 255, 255, 255 } }));
+        }
+    }
+    Clay_RenderCommandArray renderCommands = Clay_EndLayoutCtx(instance->context);
+    instance->hashes[frame] = HashRenderCommands(renderCommands);
+    instance->hashes[frame] = HashBytes(instance->hashes[frame], &(bool) { Clay_PointerOverCtx(instance->context, CLAY_IDI("Row", 3)) }, sizeof(bool));
+}
+
+static void *RunInstance(void *data) {
+    Instance *instance = (Instance *)data;
+    Clay_Context *currentContext = Clay_GetCurrentContext();
+    for (int32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+        LayoutFrame(instance, frame);
+        instance->currentContextChanged |= Clay_GetCurrentContext() != currentContext;
+    }
+    return NULL;
+}
+
+static void InitializeInstances(Instance *instances) {
+    for (int32_t i = 0; i < CONTEXT_COUNT; ++i) {
+        uint64_t memorySize = Clay_MinMemorySize();
+        Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(memorySize, malloc(memorySize));
+        instances[i] = (Instance) { .context = Clay_Initialize(arena, (Clay_Dimensions) { 800, 800 }, (Clay_ErrorHandler) { HandleClayErrors }), .extraWidth = (float)i, .index = i };
+        Clay_SetMeasureTextFunction(i % 2 ? MeasureTextWide : MeasureTextNarrow, &instances[i].extraWidth);
+        Clay_SetDebugModeEnabled(i % 4 == 3);
+    }
+}
+
+int main(void) {
+    Clay_SetMaxElementCount(4096);
+    static Instance sequential[CONTEXT_COUNT], parallel[CONTEXT_COUNT];
+    InitializeInstances(sequential);
+    InitializeInstances(parallel);
+
+    Clay_Context *mainContext = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < CONTEXT_COUNT; ++i) {
+        RunInstance(&sequential[i]);
+    }
+    pthread_t threads[CONTEXT_COUNT];
+    for (int32_t i = 0; i < CONTEXT_COUNT; ++i) {
+        pthread_create(&threads[i], NULL, RunInstance, &parallel[i]);
+    }
+    for (int32_t i = 0; i < CONTEXT_COUNT; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int32_t failures = 0;
+    if (Clay_GetCurrentContext() != mainContext) {
+        printf("the current context of the main thread changed\n");
+        failures++;
+    }
+    for (int32_t i = 0; i < CONTEXT_COUNT; ++i) {
+        if (sequential[i].currentContextChanged || parallel[i].currentContextChanged) {
+            printf("context %d: a context variant changed the current context\n", i);
+            failures++;
+        }
+        for (int32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+            if (sequential[i].hashes[frame] != parallel[i].hashes[frame]) {
+                printf("context %d frame %d: concurrent layout differs from sequential layout\n", i, frame);
+                failures++;
+                break;
+            }
+        }
+    }
+    printf("%d contexts, %d frames each: %s\n", CONTEXT_COUNT, FRAME_COUNT, failures ? "FAILED" : "identical");
+    return failures ? 1 : 0;
+}
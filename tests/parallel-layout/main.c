@@ -0,0 +1,171 @@
+// Lays out the same large tree in two contexts, one with a parallel executor backed by a small pthread pool and one without, and checks
+// that every frame produces the same render commands. Jobs are kept small so that sizing and text wrapping are split into many jobs,
+// and the pool runs them out of order. Exits with a non zero status on any difference, or if the layout was never split into jobs.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THREAD_COUNT 4
+#define FRAME_COUNT 12
+#define ROW_COUNT 3000
+#define MINIMUM_JOB_ELEMENT_COUNT 64
+
+static const char *words = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor incididunt ut labore et dolore magna aliqua";
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+static Clay_Dimensions MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.55f, .height = (float)config->fontSize };
+}
+
+typedef struct {
+    int32_t thread;
+    int32_t jobCount;
+    void (*job)(int32_t jobIndex, void *jobData);
+    void *jobData;
+} Worker;
+
+// Each thread runs every THREAD_COUNT'th job, starting from the end, so jobs finish in a different order to the one they were created in
+static void *RunWorker(void *data) {
+    Worker *worker = (Worker *)data;
+    for (int32_t jobIndex = worker->jobCount - 1 - worker->thread; jobIndex >= 0; jobIndex -= THREAD_COUNT) {
+        worker->job(jobIndex, worker->jobData);
+    }
+    return NULL;
+}
+
+static int32_t jobsRun = 0;
+
+static void ParallelFor(int32_t jobCount, void (*job)(int32_t jobIndex, void *jobData), void *jobData, void *userData) {
+    pthread_t threads[THREAD_COUNT];
+    Worker workers[THREAD_COUNT];
+    for (int32_t i = 0; i < THREAD_COUNT; ++i) {
+        workers[i] = (Worker) { .thread = i, .jobCount = jobCount, .job = job, .jobData = jobData };
+        pthread_create(&threads[i], NULL, RunWorker, &workers[i]);
+    }
+    for (int32_t i = 0; i < THREAD_COUNT; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    jobsRun += jobCount;
+}
+
+static void DeclareRow(int32_t row, int32_t frame) {
+    Clay_String text = { .length = 8 + (row * 13 + frame * 5) % 110, .chars = words };
+    CLAY({ .id = CLAY_IDI("Row", row), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = CLAY_PADDING_ALL(3), .childGap = 4, .childAlignment = { .y = CLAY_ALIGN_Y_CENTER } }, .backgroundColor = { 30, 30, 30, 255 }, .border = { .color = { 80, 80, 80, 255 }, .width = { 1, 1, 1, 1, 1 } } }) {
+        CLAY({ .layout = { .sizing = { CLAY_SIZING_PERCENT(0.15f), CLAY_SIZING_FIXED(10) } }, .backgroundColor = { 90, 90, 90, 255 } }) {}
+        CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0, (float)(80 + row % 120)), CLAY_SIZING_FIT(0) } } }) {
+            CLAY_TEXT(text, CLAY_TEXT_CONFIG({ .fontSize = (uint16_t)(10 + row % 4), .textColor = { 255, 255, 255, 255 } }));
+        }
+        CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 1 } }) {
+            for (int32_t i = 0; i < 1 + row % 3; ++i) {
+                CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0, (float)(20 + i * 15)), CLAY_SIZING_FIXED(4) } }, .backgroundColor = { 120, 60, 60, 255 }, .cornerRadius = CLAY_CORNER_RADIUS(2) }) {}
+            }
+            CLAY_TEXT(CLAY_STRING("a b c d e f g h"), CLAY_TEXT_CONFIG({ .fontSize = 10, .textColor = { 200, 200, 200, 255 } }));
+        }
+        CLAY({ .layout = { .sizing = { CLAY_SIZING_FIXED((float)(16 + row % 5)) } }, .aspectRatio = { 1.5f }, .image = { .imageData = (void *)words } }) {}
+    }
+}
+
+static Clay_RenderCommandArray LayoutFrame(Clay_Context *context, int32_t frame) {
+    Clay_SetCurrentContext(context);
+    Clay_SetLayoutDimensions((Clay_Dimensions) { 500.0f + (float)(frame * 173 % 900), 800 });
+    Clay_BeginLayout();
+    CLAY({ .id = CLAY_ID("Outer"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .padding = CLAY_PADDING_ALL(8), .childGap = 4 } }) {
+        CLAY({ .id = CLAY_ID("List"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 2 }, .clip = { .vertical = true, .childOffset = { 0, -37.0f * (float)frame } } }) {
+            for (int32_t row = 0; row < ROW_COUNT; ++row) {
+                DeclareRow(row, frame);
+            }
+        }
+        CLAY({ .id = CLAY_ID("Tooltip"), .floating = { .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID, .parentId = CLAY_IDI("Row", frame * 7).id, .offset = { 20, 4 } }, .layout = { .padding = CLAY_PADDING_ALL(4) }, .backgroundColor = { 0, 0, 0, 255 } }) {
+            CLAY_TEXT(CLAY_STRING("tooltip text that wraps"), CLAY_TEXT_CONFIG({ .fontSize = 12, .textColor = { 255, 255, 255, 255 } }));
+        }
+    }
+    return Clay_EndLayout();
+}
+
+static bool ColorsEqual(Clay_Color a, Clay_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static bool CornerRadiiEqual(Clay_CornerRadius a, Clay_CornerRadius b) {
+    return a.topLeft == b.topLeft && a.topRight == b.topRight && a.bottomLeft == b.bottomLeft && a.bottomRight == b.bottomRight;
+}
+
+static bool RenderCommandsEqual(Clay_RenderCommand *a, Clay_RenderCommand *b) {
+    if (memcmp(&a->boundingBox, &b->boundingBox, sizeof(a->boundingBox)) != 0 || a->id != b->id || a->zIndex != b->zIndex || a->commandType != b->commandType || a->userData != b->userData) {
+        return false;
+    }
+    switch (a->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            return ColorsEqual(a->renderData.rectangle.backgroundColor, b->renderData.rectangle.backgroundColor) && CornerRadiiEqual(a->renderData.rectangle.cornerRadius, b->renderData.rectangle.cornerRadius);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            Clay_BorderRenderData *borderA = &a->renderData.border, *borderB = &b->renderData.border;
+            return ColorsEqual(borderA->color, borderB->color) && CornerRadiiEqual(borderA->cornerRadius, borderB->cornerRadius)
+                && borderA->width.left == borderB->width.left && borderA->width.right == borderB->width.right && borderA->width.top == borderB->width.top
+                && borderA->width.bottom == borderB->width.bottom && borderA->width.betweenChildren == borderB->width.betweenChildren;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextRenderData *textA = &a->renderData.text, *textB = &b->renderData.text;
+            return textA->stringContents.length == textB->stringContents.length && textA->stringContents.chars == textB->stringContents.chars && ColorsEqual(textA->textColor, textB->textColor)
+                && textA->fontId == textB->fontId && textA->fontSize == textB->fontSize && textA->letterSpacing == textB->letterSpacing && textA->lineHeight == textB->lineHeight;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            return ColorsEqual(a->renderData.image.backgroundColor, b->renderData.image.backgroundColor) && CornerRadiiEqual(a->renderData.image.cornerRadius, b->renderData.image.cornerRadius)
+                && a->renderData.image.imageData == b->renderData.image.imageData;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            return a->renderData.clip.horizontal == b->renderData.clip.horizontal && a->renderData.clip.vertical == b->renderData.clip.vertical;
+        }
+        default: return true;
+    }
+}
+
+int main(void) {
+    Clay_SetMaxElementCount(ROW_COUNT * 40);
+    Clay_SetMaxMeasureTextCacheWordCount(ROW_COUNT * 64);
+    Clay_Context *contexts[2];
+    for (int32_t i = 0; i < 2; ++i) {
+        uint64_t memorySize = Clay_MinMemorySize();
+        Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(memorySize, malloc(memorySize));
+        contexts[i] = Clay_Initialize(arena, (Clay_Dimensions) { 800, 800 }, (Clay_ErrorHandler) { HandleClayErrors });
+        Clay_SetMeasureTextFunction(MeasureText, NULL);
+        Clay_SetCullingEnabled(false);
+    }
+    Clay_Context *serial = contexts[0], *parallel = contexts[1];
+    Clay_SetParallelExecutor((Clay_ParallelExecutor) { .parallelForFunction = ParallelFor, .minimumJobElementCount = MINIMUM_JOB_ELEMENT_COUNT });
+
+    int32_t failures = 0;
+    int32_t commandCount = 0;
+    for (int32_t frame = 0; frame < FRAME_COUNT && failures == 0; ++frame) {
+        Clay_RenderCommandArray expected = LayoutFrame(serial, frame);
+        int32_t jobsBefore = jobsRun;
+        Clay_RenderCommandArray actual = LayoutFrame(parallel, frame);
+        if (jobsRun == jobsBefore) {
+            printf("frame %d: the layout was never split into jobs\n", frame);
+            failures++;
+        }
+        if (expected.length != actual.length) {
+            printf("frame %d: %d render commands in parallel, %d on a single thread\n", frame, actual.length, expected.length);
+            failures++;
+            continue;
+        }
+        for (int32_t i = 0; i < expected.length; ++i) {
+            if (!RenderCommandsEqual(&expected.internalArray[i], &actual.internalArray[i])) {
+                printf("frame %d: render command %d differs from a single threaded layout\n", frame, i);
+                failures++;
+                break;
+            }
+        }
+        commandCount += expected.length;
+    }
+    printf("%d frames, %d render commands, %d jobs: %s\n", FRAME_COUNT, commandCount, jobsRun, failures ? "FAILED" : "identical");
+    return failures ? 1 : 0;
+}
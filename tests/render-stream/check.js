@@ -0,0 +1,96 @@
+// Runs the render-stream test binary, which writes a stream to <path>.bin and the commands it holds to <path>.txt,
+// decodes the stream with renderers/stream/clay-render-stream.js and checks that every decoded field has the same bits.
+// Usage: node check.js <test binary>
+const childProcess = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const source = fs.readFileSync(path.join(__dirname, '../../renderers/stream/clay-render-stream.js'), 'utf8');
+// The decoder is a classic script for the browser, so evaluate it and take what the test needs from its scope
+const clay = new Function(source + `; return {
+    decodeClayRenderStream,
+    RECTANGLE: CLAY_RENDER_STREAM_COMMAND_TYPE_RECTANGLE, BORDER: CLAY_RENDER_STREAM_COMMAND_TYPE_BORDER, TEXT: CLAY_RENDER_STREAM_COMMAND_TYPE_TEXT,
+    IMAGE: CLAY_RENDER_STREAM_COMMAND_TYPE_IMAGE, CUSTOM: CLAY_RENDER_STREAM_COMMAND_TYPE_CUSTOM,
+    SCISSOR_START: CLAY_RENDER_STREAM_COMMAND_TYPE_SCISSOR_START, SCISSOR_END: CLAY_RENDER_STREAM_COMMAND_TYPE_SCISSOR_END,
+    LAYER_BEGIN: CLAY_RENDER_STREAM_COMMAND_TYPE_LAYER_BEGIN, LAYER_END: CLAY_RENDER_STREAM_COMMAND_TYPE_LAYER_END,
+};`)();
+
+const directory = fs.mkdtempSync(path.join(os.tmpdir(), 'clay-render-stream-'));
+const outputPath = path.join(directory, 'stream');
+childProcess.execFileSync(process.argv[2], [outputPath], { stdio: 'inherit' });
+
+const scratch = new DataView(new ArrayBuffer(4));
+// Numbers decoded in JavaScript are doubles, so one that isn't exactly a float is marked rather than rounded to the expected bits
+function floatBits(value) {
+    scratch.setFloat32(0, value, true);
+    let bits = scratch.getUint32(0, true).toString(16).padStart(8, '0');
+    return Math.fround(value) === value || Number.isNaN(value) ? bits : `${bits}(not a float: ${value})`;
+}
+function color(value) {
+    return [value.r, value.g, value.b, value.a].map(floatBits).join(' ');
+}
+function cornerRadius(value) {
+    return [value.topLeft, value.topRight, value.bottomLeft, value.bottomRight].map(floatBits).join(' ');
+}
+
+// Writes one line per command, in the same format as WriteExpected in main.c
+function formatCommand(command) {
+    let box = command.boundingBox;
+    let fields = [command.commandType, command.id, command.zIndex, command.userData, color({ r: box.x, g: box.y, b: box.width, a: box.height })];
+    let data = command.renderData;
+    switch (command.commandType) {
+        case clay.RECTANGLE: fields.push(color(data.backgroundColor), cornerRadius(data.cornerRadius)); break;
+        case clay.BORDER: {
+            let width = data.width;
+            fields.push(color(data.color), cornerRadius(data.cornerRadius), width.left, width.right, width.top, width.bottom, width.betweenChildren);
+            break;
+        }
+        case clay.TEXT: {
+            let bytes = Array.from(new TextEncoder().encode(data.stringContents), byte => byte.toString(16).padStart(2, '0')).join('');
+            fields.push(color(data.textColor), data.fontId, data.fontSize, data.letterSpacing, data.lineHeight, bytes);
+            break;
+        }
+        case clay.IMAGE: fields.push(color(data.backgroundColor), cornerRadius(data.cornerRadius), data.imageData); break;
+        case clay.CUSTOM: fields.push(color(data.backgroundColor), cornerRadius(data.cornerRadius), data.customData); break;
+        case clay.SCISSOR_START:
+        case clay.SCISSOR_END: fields.push(data.horizontal ? 1 : 0, data.vertical ? 1 : 0); break;
+        case clay.LAYER_BEGIN:
+        case clay.LAYER_END: fields.push(data.contentHash); break;
+    }
+    return fields.join(' ');
+}
+
+const stream = fs.readFileSync(outputPath + '.bin');
+const expected = fs.readFileSync(outputPath + '.txt', 'utf8').split('\n').filter(line => line.length > 0);
+fs.rmSync(directory, { recursive: true });
+
+let failures = 0;
+function fail(message) {
+    console.log(message);
+    failures++;
+}
+const commands = clay.decodeClayRenderStream(new DataView(stream.buffer, stream.byteOffset, stream.length));
+if (commands.length !== expected.length) {
+    fail(`decoded ${commands.length} render commands, expected ${expected.length}`);
+}
+for (let i = 0; i < Math.min(commands.length, expected.length) && failures < 10; i++) {
+    let actual = formatCommand(commands[i]);
+    if (actual !== expected[i]) {
+        fail(`render command ${i} differs\n  expected ${expected[i]}\n  decoded  ${actual}`);
+    }
+}
+// Every byte of the stream is needed, so every shorter stream is rejected
+for (let length = 0; length < stream.length && failures < 10; length++) {
+    let decoded = true;
+    try {
+        clay.decodeClayRenderStream(new DataView(stream.buffer, stream.byteOffset, length));
+    } catch (error) {
+        decoded = false;
+    }
+    if (decoded) {
+        fail(`a stream truncated to ${length} of ${stream.length} bytes was accepted`);
+    }
+}
+console.log(failures ? 'FAILED' : `${commands.length} render commands decoded unchanged in JavaScript`);
+process.exit(failures ? 1 : 0);
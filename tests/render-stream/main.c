@@ -0,0 +1,315 @@
+// Encodes render commands with clay_render_stream.h, decodes them again and checks that every field comes back with the same bits.
+// The commands come from layouts that produce every command type, and from a hand written list of edge cases: -0 and NaN values,
+// deltas that only round to the right value in float, more colors than the palette holds, and every corner radius mode.
+// Also checks that short buffers are reported without being written past, and that every truncated stream is rejected.
+// With a path argument, also writes the edge cases and one layout to <path>.bin, and their expected contents to <path>.txt,
+// which check.js compares against the JavaScript decoder. Exits with a non zero status on any difference.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+#define CLAY_RENDER_STREAM_IMPLEMENTATION
+#include "../../renderers/stream/clay_render_stream.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_COUNT 8
+#define ROW_COUNT 120
+#define EDGE_CASE_CAPACITY 1024
+
+static const char *words = "lorem ipsum dolor sit amet, consectetur adipiscing elit. \xc3\xa9t\xc3\xa9 \xe2\x82\xac uber alles";
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+static Clay_Dimensions MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.53f, .height = (float)config->fontSize * 1.17f };
+}
+
+static Clay_RenderCommandArray LayoutFrame(int32_t frame) {
+    Clay_SetLayoutDimensions((Clay_Dimensions) { 640.5f + (float)frame * 37.25f, 480 });
+    Clay_BeginLayout();
+    CLAY({ .id = CLAY_ID("Outer"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .padding = CLAY_PADDING_ALL(5) }, .backgroundColor = { 10, 20, 30, 255 } }) {
+        CLAY({ .id = CLAY_ID("Header"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(40.75f) }, .childGap = 3 }, .layer = { .cached = true }, .userData = (void *)(uintptr_t)0x1234 }) {
+            CLAY({ .layout = { .sizing = { CLAY_SIZING_PERCENT(0.33f), CLAY_SIZING_GROW(0) } }, .backgroundColor = { 0.5f, 100.25f, 300, 254.5f }, .cornerRadius = { 1, 2, 3, 4.5f } }) {}
+            CLAY({ .layout = { .sizing = { CLAY_SIZING_FIXED(32.5f), CLAY_SIZING_GROW(0) } }, .image = { .imageData = (void *)words }, .cornerRadius = CLAY_CORNER_RADIUS(4) }) {}
+            CLAY({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } }, .custom = { .customData = (void *)(uintptr_t)(frame + 1) }, .backgroundColor = { 1, 2, 3, 4 } }) {}
+        }
+        CLAY({ .id = CLAY_ID("List"), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 2 }, .clip = { .vertical = true, .childOffset = { 0, -13.5f * (float)frame } } }) {
+            for (int32_t row = 0; row < ROW_COUNT; ++row) {
+                Clay_String text = { .length = 5 + (row * 11 + frame) % 70, .chars = words };
+                CLAY({ .id = CLAY_IDI("Row", row), .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = { 4, 4, 2, 2 }, .childGap = 4 },
+                    .backgroundColor = { (float)(row % 200), (float)(row * 7 % 256), 40, 255 }, .border = { .color = { 255, 0, (float)(row % 3), 255 }, .width = { 1, 2, 0, (uint16_t)(row % 2), 1 } },
+                    .cornerRadius = { 0, (float)(row % 4), 0, 0 } }) {
+                    CLAY_TEXT(text, CLAY_TEXT_CONFIG({ .fontId = (uint16_t)(row % 3), .fontSize = (uint16_t)(12 + row % 5), .letterSpacing = (uint16_t)(row % 2), .lineHeight = (uint16_t)(row % 3 == 0 ? 20 : 0), .textColor = { 255, 255, 255, 255 } }));
+                }
+            }
+        }
+        CLAY({ .id = CLAY_ID("Tooltip"), .floating = { .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID, .parentId = CLAY_IDI("Row", frame).id, .offset = { 20.125f, -4 }, .zIndex = (int16_t)(-3 + frame) }, .layout = { .padding = CLAY_PADDING_ALL(4) }, .backgroundColor = { 0, 0, 0, 200 } }) {
+            CLAY_TEXT(CLAY_STRING("tooltip"), CLAY_TEXT_CONFIG({ .fontSize = 12, .textColor = { 255, 255, 0, 255 } }));
+        }
+    }
+    return Clay_EndLayout();
+}
+
+static Clay_RenderCommand EdgeCase(Clay_RenderCommandType commandType, float x, float y, float width, float height) {
+    Clay_RenderCommand renderCommand;
+    memset(&renderCommand, 0, sizeof(renderCommand));
+    renderCommand.commandType = commandType;
+    renderCommand.boundingBox = (Clay_BoundingBox) { x, y, width, height };
+    return renderCommand;
+}
+
+static Clay_RenderCommandArray EdgeCases(Clay_RenderCommand *storage) {
+    int32_t count = 0;
+    // Deltas of an integer that only give the value back after rounding to float, followed by values an integer can't reach
+    storage[count++] = EdgeCase(CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 0.25f, 1.5f, 3, 4);
+    storage[count++] = EdgeCase(CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 33554432.0f, 1e30f, -3, 4);
+    storage[count++] = EdgeCase(CLAY_RENDER_COMMAND_TYPE_RECTANGLE, -0.0f, NAN, INFINITY, -INFINITY);
+    storage[count++] = EdgeCase(CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 1e-45f, -0.0f, 16777217.0f, 0);
+    storage[count++] = EdgeCase(CLAY_RENDER_COMMAND_TYPE_NONE, 1e-45f, -0.0f, 16777217.0f, 0);
+    storage[count++] = EdgeCase(CLAY_RENDER_COMMAND_TYPE_NONE, 2147483647.0f, -2147483648.0f, 1073741823.0f, -1073741824.0f);
+    // Every corner radius mode, including radii that only differ in sign
+    Clay_CornerRadius radii[] = { { 0, 0, 0, 0 }, { -0.0f, -0.0f, -0.0f, -0.0f }, { 0, -0.0f, 0, 0 }, { 5, 5, 5, 5 }, { 1.5f, 1.5f, 1.5f, 1.5f }, { 1, 2, 3, 4 }, { NAN, NAN, NAN, NAN } };
+    for (int32_t i = 0; i < (int32_t)(sizeof(radii) / sizeof(radii[0])); ++i) {
+        Clay_RenderCommand renderCommand = EdgeCase(CLAY_RENDER_COMMAND_TYPE_BORDER, (float)i, 0, 10, 10);
+        renderCommand.renderData.border = (Clay_BorderRenderData) { .color = { 1, 2, 3, 4 }, .cornerRadius = radii[i], .width = { 1, 65535, 0, 300, 7 } };
+        storage[count++] = renderCommand;
+        renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_IMAGE;
+        renderCommand.renderData.image = (Clay_ImageRenderData) { .backgroundColor = { 0, 0, 0, 0 }, .cornerRadius = radii[i], .imageData = (void *)(uintptr_t)(i * 0x10001) };
+        storage[count++] = renderCommand;
+    }
+    // More distinct colors than the palette holds, then the first ones again, and colors that aren't whole bytes
+    for (int32_t i = 0; i < CLAY_RENDER_STREAM_PALETTE_CAPACITY + 40; ++i) {
+        Clay_RenderCommand renderCommand = EdgeCase(CLAY_RENDER_COMMAND_TYPE_RECTANGLE, (float)(i % 7), (float)i * 0.5f, 10, 10);
+        renderCommand.renderData.rectangle.backgroundColor = (Clay_Color) { (float)(i % 256), (float)(i / 256), 7, 255 };
+        renderCommand.id = (uint32_t)(i / 3) * 0x9e3779b9u;
+        renderCommand.zIndex = (int16_t)(i % 5 == 0 ? -32768 : i % 4);
+        renderCommand.userData = (void *)(uintptr_t)(i % 9 == 0 ? 0 : (uint64_t)i << 20);
+        storage[count++] = renderCommand;
+    }
+    Clay_Color colors[] = { { 0, 0, 0, 0 }, { -0.0f, 0, 0, 0 }, { 255.5f, 0, 0, 255 }, { -1, 0, 0, 255 }, { 256, 0, 0, 255 }, { NAN, 1, 2, 3 } };
+    for (int32_t i = 0; i < (int32_t)(sizeof(colors) / sizeof(colors[0])); ++i) {
+        Clay_RenderCommand renderCommand = EdgeCase(CLAY_RENDER_COMMAND_TYPE_CUSTOM, 0, 0, 1, 1);
+        renderCommand.renderData.custom = (Clay_CustomRenderData) { .backgroundColor = colors[i], .customData = (void *)(uintptr_t)0xffffffffu };
+        storage[count++] = renderCommand;
+    }
+    // Text, clip and layer payloads
+    Clay_RenderCommand text = EdgeCase(CLAY_RENDER_COMMAND_TYPE_TEXT, 1, 2, 3, 4);
+    text.renderData.text = (Clay_TextRenderData) { .stringContents = { .length = 0, .chars = words, .baseChars = words }, .textColor = { 1, 1, 1, 1 }, .fontId = 65535, .fontSize = 0, .letterSpacing = 128, .lineHeight = 16384 };
+    storage[count++] = text;
+    text.renderData.text.stringContents.length = (int32_t)strlen(words);
+    storage[count++] = text;
+    for (int32_t i = 0; i < 4; ++i) {
+        Clay_RenderCommand clip = EdgeCase(i % 2 ? CLAY_RENDER_COMMAND_TYPE_SCISSOR_END : CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, 5, 5, 50, 50);
+        clip.renderData.clip = (Clay_ClipRenderData) { .horizontal = i / 2 == 0, .vertical = i / 2 == 1 };
+        storage[count++] = clip;
+    }
+    Clay_RenderCommand layer = EdgeCase(CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN, 0, 0, 100, 100);
+    layer.renderData.layer.contentHash = 0xdeadbeefu;
+    storage[count++] = layer;
+    layer.commandType = CLAY_RENDER_COMMAND_TYPE_LAYER_END;
+    layer.renderData.layer.contentHash = 0;
+    storage[count++] = layer;
+    return (Clay_RenderCommandArray) { .capacity = count, .length = count, .internalArray = storage };
+}
+
+static bool SameBits(const void *first, const void *second, size_t size) {
+    return memcmp(first, second, size) == 0;
+}
+
+static bool RenderCommandsEqual(Clay_RenderCommand *a, Clay_RenderCommand *b) {
+    if (!SameBits(&a->boundingBox, &b->boundingBox, sizeof(a->boundingBox)) || a->id != b->id || a->zIndex != b->zIndex || a->commandType != b->commandType || a->userData != b->userData) {
+        return false;
+    }
+    Clay_RenderData *dataA = &a->renderData, *dataB = &b->renderData;
+    switch (a->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            return SameBits(&dataA->rectangle.backgroundColor, &dataB->rectangle.backgroundColor, sizeof(Clay_Color)) && SameBits(&dataA->rectangle.cornerRadius, &dataB->rectangle.cornerRadius, sizeof(Clay_CornerRadius));
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            Clay_BorderWidth *widthA = &dataA->border.width, *widthB = &dataB->border.width;
+            return SameBits(&dataA->border.color, &dataB->border.color, sizeof(Clay_Color)) && SameBits(&dataA->border.cornerRadius, &dataB->border.cornerRadius, sizeof(Clay_CornerRadius))
+                && widthA->left == widthB->left && widthA->right == widthB->right && widthA->top == widthB->top && widthA->bottom == widthB->bottom && widthA->betweenChildren == widthB->betweenChildren;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextRenderData *textA = &dataA->text, *textB = &dataB->text;
+            return SameBits(&textA->textColor, &textB->textColor, sizeof(Clay_Color)) && textA->fontId == textB->fontId && textA->fontSize == textB->fontSize
+                && textA->letterSpacing == textB->letterSpacing && textA->lineHeight == textB->lineHeight && textA->stringContents.length == textB->stringContents.length
+                && SameBits(textA->stringContents.chars, textB->stringContents.chars, (size_t)textA->stringContents.length);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            return SameBits(&dataA->image.backgroundColor, &dataB->image.backgroundColor, sizeof(Clay_Color)) && SameBits(&dataA->image.cornerRadius, &dataB->image.cornerRadius, sizeof(Clay_CornerRadius))
+                && dataA->image.imageData == dataB->image.imageData;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            return SameBits(&dataA->custom.backgroundColor, &dataB->custom.backgroundColor, sizeof(Clay_Color)) && SameBits(&dataA->custom.cornerRadius, &dataB->custom.cornerRadius, sizeof(Clay_CornerRadius))
+                && dataA->custom.customData == dataB->custom.customData;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            return dataA->clip.horizontal == dataB->clip.horizontal && dataA->clip.vertical == dataB->clip.vertical;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+        case CLAY_RENDER_COMMAND_TYPE_LAYER_END: {
+            return dataA->layer.contentHash == dataB->layer.contentHash;
+        }
+        default: return true;
+    }
+}
+
+// Encodes and decodes the commands, and returns the number of problems found
+static int32_t CheckRoundTrip(const char *name, Clay_RenderCommandArray renderCommands) {
+    int32_t size = Clay_RenderStream_Encode(renderCommands, NULL, 0);
+    // A buffer one byte short reports the full size, and nothing is written past its end
+    uint8_t *buffer = (uint8_t *)malloc((size_t)size + 16);
+    memset(buffer, 0xab, (size_t)size + 16);
+    if (Clay_RenderStream_Encode(renderCommands, buffer, size - 1) != size || buffer[size - 1] != 0xab) {
+        printf("%s: encoding into a short buffer wrote past its end\n", name);
+        return 1;
+    }
+    if (Clay_RenderStream_Encode(renderCommands, buffer, size) != size || buffer[size] != 0xab) {
+        printf("%s: encoding into a buffer of the reported size failed\n", name);
+        return 1;
+    }
+    int32_t problems = 0;
+    Clay_RenderCommandArray decoded = { .capacity = renderCommands.length, .internalArray = (Clay_RenderCommand *)malloc(sizeof(Clay_RenderCommand) * (size_t)(renderCommands.length + 1)) };
+    if (Clay_RenderStream_PeekCommandCount(buffer, size) != renderCommands.length || !Clay_RenderStream_Decode(buffer, size, &decoded) || decoded.length != renderCommands.length) {
+        printf("%s: the stream didn't decode\n", name);
+        problems++;
+    } else {
+        for (int32_t i = 0; i < renderCommands.length; ++i) {
+            if (!RenderCommandsEqual(&renderCommands.internalArray[i], &decoded.internalArray[i])) {
+                printf("%s: render command %d of type %d differs after decoding\n", name, i, renderCommands.internalArray[i].commandType);
+                problems++;
+                break;
+            }
+        }
+    }
+    // Every byte of the stream is needed, so every shorter stream is rejected
+    for (int32_t length = 0; length < size; ++length) {
+        if (Clay_RenderStream_Decode(buffer, length, &decoded)) {
+            printf("%s: a stream truncated to %d of %d bytes was accepted\n", name, length, size);
+            problems++;
+            break;
+        }
+    }
+    decoded.capacity = renderCommands.length - 1;
+    if (renderCommands.length > 0 && Clay_RenderStream_Decode(buffer, size, &decoded)) {
+        printf("%s: decoded into an array that is too small\n", name);
+        problems++;
+    }
+    free(decoded.internalArray);
+    free(buffer);
+    return problems;
+}
+
+static void WriteColor(FILE *file, Clay_Color color) {
+    uint32_t bits[4];
+    memcpy(bits, &color, sizeof(bits));
+    fprintf(file, " %08x %08x %08x %08x", bits[0], bits[1], bits[2], bits[3]);
+}
+
+static void WriteCornerRadius(FILE *file, Clay_CornerRadius cornerRadius) {
+    WriteColor(file, (Clay_Color) { cornerRadius.topLeft, cornerRadius.topRight, cornerRadius.bottomLeft, cornerRadius.bottomRight });
+}
+
+// Writes one line per command, in the same format as check.js
+static void WriteExpected(FILE *file, Clay_RenderCommandArray renderCommands) {
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        Clay_RenderData *renderData = &renderCommand->renderData;
+        fprintf(file, "%d %u %d %llu", renderCommand->commandType, renderCommand->id, renderCommand->zIndex, (unsigned long long)(uintptr_t)renderCommand->userData);
+        WriteColor(file, (Clay_Color) { renderCommand->boundingBox.x, renderCommand->boundingBox.y, renderCommand->boundingBox.width, renderCommand->boundingBox.height });
+        switch (renderCommand->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: WriteColor(file, renderData->rectangle.backgroundColor); WriteCornerRadius(file, renderData->rectangle.cornerRadius); break;
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                Clay_BorderWidth width = renderData->border.width;
+                WriteColor(file, renderData->border.color);
+                WriteCornerRadius(file, renderData->border.cornerRadius);
+                fprintf(file, " %u %u %u %u %u", width.left, width.right, width.top, width.bottom, width.betweenChildren);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_TextRenderData *text = &renderData->text;
+                WriteColor(file, text->textColor);
+                fprintf(file, " %u %u %u %u ", text->fontId, text->fontSize, text->letterSpacing, text->lineHeight);
+                for (int32_t j = 0; j < text->stringContents.length; ++j) {
+                    fprintf(file, "%02x", (uint8_t)text->stringContents.chars[j]);
+                }
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: WriteColor(file, renderData->image.backgroundColor); WriteCornerRadius(file, renderData->image.cornerRadius); fprintf(file, " %llu", (unsigned long long)(uintptr_t)renderData->image.imageData); break;
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: WriteColor(file, renderData->custom.backgroundColor); WriteCornerRadius(file, renderData->custom.cornerRadius); fprintf(file, " %llu", (unsigned long long)(uintptr_t)renderData->custom.customData); break;
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: fprintf(file, " %d %d", renderData->clip.horizontal, renderData->clip.vertical); break;
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN:
+            case CLAY_RENDER_COMMAND_TYPE_LAYER_END: fprintf(file, " %u", renderData->layer.contentHash); break;
+            default: break;
+        }
+        fprintf(file, "\n");
+    }
+}
+
+static bool WriteFiles(const char *path, Clay_RenderCommandArray renderCommands) {
+    char fileName[1024];
+    int32_t size = Clay_RenderStream_Encode(renderCommands, NULL, 0);
+    uint8_t *buffer = (uint8_t *)malloc((size_t)size);
+    Clay_RenderStream_Encode(renderCommands, buffer, size);
+    snprintf(fileName, sizeof(fileName), "%s.bin", path);
+    FILE *file = fopen(fileName, "wb");
+    if (!file) {
+        free(buffer);
+        return false;
+    }
+    fwrite(buffer, 1, (size_t)size, file);
+    fclose(file);
+    free(buffer);
+    snprintf(fileName, sizeof(fileName), "%s.txt", path);
+    file = fopen(fileName, "w");
+    if (!file) {
+        return false;
+    }
+    WriteExpected(file, renderCommands);
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint64_t memorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(memorySize, malloc(memorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 640, 480 }, (Clay_ErrorHandler) { HandleClayErrors });
+    Clay_SetMeasureTextFunction(MeasureText, NULL);
+
+    int32_t failures = 0;
+    static Clay_RenderCommand edgeCaseStorage[EDGE_CASE_CAPACITY];
+    Clay_RenderCommandArray edgeCases = EdgeCases(edgeCaseStorage);
+    failures += CheckRoundTrip("edge cases", edgeCases);
+    failures += CheckRoundTrip("empty frame", (Clay_RenderCommandArray) { .capacity = 0, .length = 0, .internalArray = edgeCaseStorage });
+    int32_t layoutBytes = 0, layoutCommands = 0;
+    for (int32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+        Clay_RenderCommandArray renderCommands = LayoutFrame(frame);
+        char name[32];
+        snprintf(name, sizeof(name), "frame %d", frame);
+        failures += CheckRoundTrip(name, renderCommands);
+        layoutBytes += Clay_RenderStream_Encode(renderCommands, NULL, 0);
+        layoutCommands += renderCommands.length;
+    }
+    printf("%d frames, %d render commands: %d bytes as Clay_RenderCommands, %d bytes encoded\n", FRAME_COUNT, layoutCommands, layoutCommands * (int32_t)sizeof(Clay_RenderCommand), layoutBytes);
+
+    if (argc > 1) {
+        Clay_RenderCommandArray frame = LayoutFrame(0);
+        Clay_RenderCommand *combined = (Clay_RenderCommand *)malloc(sizeof(Clay_RenderCommand) * (size_t)(edgeCases.length + frame.length));
+        memcpy(combined, edgeCases.internalArray, sizeof(Clay_RenderCommand) * (size_t)edgeCases.length);
+        memcpy(combined + edgeCases.length, frame.internalArray, sizeof(Clay_RenderCommand) * (size_t)frame.length);
+        if (!WriteFiles(argv[1], (Clay_RenderCommandArray) { .capacity = edgeCases.length + frame.length, .length = edgeCases.length + frame.length, .internalArray = combined })) {
+            printf("couldn't write %s.bin and %s.txt\n", argv[1], argv[1]);
+            failures++;
+        }
+        free(combined);
+    }
+    printf("%s\n", failures ? "FAILED" : "all render commands decoded unchanged");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,203 @@
+// Lays out a seeded corpus of random rows, and compares every child width with the grow and compress loops that clay used before
+// Clay__DistributeSpace. The old loops stopped with up to CLAY__EPSILON left to hand out and lost precision over many small steps,
+// so the widths are expected to differ by a small fraction of a pixel, but never by more than MAX_DIFFERENCE.
+// Exits with a non zero status if any width is further off.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ROW_COUNT 2000
+#define MAX_CHILD_COUNT 300
+#define MAX_DIFFERENCE 0.05f
+
+typedef enum { CHILD_FIXED, CHILD_FIT, CHILD_GROW } ChildType;
+
+typedef struct {
+    ChildType type;
+    float contentWidth, min, max;
+    bool clip;
+} Child;
+
+typedef struct {
+    float width, padding, childGap;
+    int32_t childCount;
+    Child children[MAX_CHILD_COUNT];
+} Row;
+
+static uint32_t randomState = 12345;
+
+static uint32_t Random(uint32_t range) {
+    randomState = randomState * 1664525u + 1013904223u;
+    return (randomState >> 8) % range;
+}
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+static void GenerateRow(Row *row) {
+    row->childCount = 1 + (Random(4) == 0 ? (int32_t)Random(MAX_CHILD_COUNT) : (int32_t)Random(16));
+    row->width = (float)(50 + Random(3000)) + (float)Random(4) * 0.25f;
+    row->padding = (float)Random(10);
+    row->childGap = (float)Random(6);
+    int32_t clipCount = 0;
+    for (int32_t i = 0; i < row->childCount; ++i) {
+        Child *child = &row->children[i];
+        uint32_t type = Random(20);
+        child->type = type < 3 ? CHILD_FIXED : type < 10 ? CHILD_FIT : CHILD_GROW;
+        child->contentWidth = (float)Random(150) + (float)Random(4) * 0.25f;
+        child->min = Random(2) ? (float)Random(40) : 0;
+        child->max = Random(3) == 0 ? child->min + (float)Random(120) + 1 : 0;
+        // Clay keeps up to 100 clip containers, and the ones from the previous row are only dropped a frame later
+        child->clip = Random(2) && clipCount++ < 45;
+    }
+}
+
+// Clay clamps the content width of each child to its min and max sizes before distributing space. Clip containers can
+// compress down to their min size, the others no further than their content.
+static void InitialWidths(Row *row, float *sizes, float *minSizes, float *maxSizes) {
+    for (int32_t i = 0; i < row->childCount; ++i) {
+        Child *child = &row->children[i];
+        float max = child->max > 0 ? child->max : CLAY__MAXFLOAT;
+        if (child->type == CHILD_FIXED) {
+            sizes[i] = minSizes[i] = maxSizes[i] = child->contentWidth;
+            continue;
+        }
+        sizes[i] = CLAY__MIN(CLAY__MAX(child->contentWidth, child->min), max);
+        minSizes[i] = child->clip ? CLAY__MIN(child->min, max) : sizes[i];
+        maxSizes[i] = max;
+    }
+}
+
+static void RemoveSwapback(int32_t *buffer, int32_t *length, int32_t index) {
+    buffer[index] = buffer[--*length];
+}
+
+// The grow and compress loops of Clay__SizeChildrenAlongAxis before they were replaced by Clay__DistributeSpace
+static void ReferenceDistribute(Row *row, float *sizes, float *minSizes, float *maxSizes) {
+    int32_t buffer[MAX_CHILD_COUNT];
+    int32_t length = 0, growContainerCount = 0;
+    float innerContentSize = 0;
+    for (int32_t i = 0; i < row->childCount; ++i) {
+        if (row->children[i].type != CHILD_FIXED) {
+            buffer[length++] = i;
+        }
+        growContainerCount += row->children[i].type == CHILD_GROW;
+        innerContentSize += sizes[i] + (i > 0 ? row->childGap : 0);
+    }
+    float sizeToDistribute = row->width - row->padding * 2 - innerContentSize;
+    if (sizeToDistribute < 0) {
+        while (sizeToDistribute < -CLAY__EPSILON && length > 0) {
+            float largest = 0, secondLargest = 0, widthToAdd = sizeToDistribute;
+            for (int32_t i = 0; i < length; i++) {
+                float childSize = sizes[buffer[i]];
+                if (Clay__FloatEqual(childSize, largest)) { continue; }
+                if (childSize > largest) {
+                    secondLargest = largest;
+                    largest = childSize;
+                }
+                if (childSize < largest) {
+                    secondLargest = CLAY__MAX(secondLargest, childSize);
+                    widthToAdd = secondLargest - largest;
+                }
+            }
+            widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / length);
+            for (int32_t i = 0; i < length; i++) {
+                float *childSize = &sizes[buffer[i]];
+                float previousWidth = *childSize;
+                if (Clay__FloatEqual(*childSize, largest)) {
+                    *childSize += widthToAdd;
+                    if (*childSize <= minSizes[buffer[i]]) {
+                        *childSize = minSizes[buffer[i]];
+                        RemoveSwapback(buffer, &length, i--);
+                    }
+                    sizeToDistribute -= (*childSize - previousWidth);
+                }
+            }
+        }
+    } else if (sizeToDistribute > 0 && growContainerCount > 0) {
+        for (int32_t i = 0; i < length; i++) {
+            if (row->children[buffer[i]].type != CHILD_GROW) {
+                RemoveSwapback(buffer, &length, i--);
+            }
+        }
+        while (sizeToDistribute > CLAY__EPSILON && length > 0) {
+            float smallest = CLAY__MAXFLOAT, secondSmallest = CLAY__MAXFLOAT, widthToAdd = sizeToDistribute;
+            for (int32_t i = 0; i < length; i++) {
+                float childSize = sizes[buffer[i]];
+                if (Clay__FloatEqual(childSize, smallest)) { continue; }
+                if (childSize < smallest) {
+                    secondSmallest = smallest;
+                    smallest = childSize;
+                }
+                if (childSize > smallest) {
+                    secondSmallest = CLAY__MIN(secondSmallest, childSize);
+                    widthToAdd = secondSmallest - smallest;
+                }
+            }
+            widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / length);
+            for (int32_t i = 0; i < length; i++) {
+                float *childSize = &sizes[buffer[i]];
+                float previousWidth = *childSize;
+                if (Clay__FloatEqual(*childSize, smallest)) {
+                    *childSize += widthToAdd;
+                    if (*childSize >= maxSizes[buffer[i]]) {
+                        *childSize = maxSizes[buffer[i]];
+                        RemoveSwapback(buffer, &length, i--);
+                    }
+                    sizeToDistribute -= (*childSize - previousWidth);
+                }
+            }
+        }
+    }
+}
+
+static void LayoutRow(Row *row) {
+    // Drops the clip containers that were not open in the previous row
+    Clay_UpdateScrollContainers(false, (Clay_Vector2) { 0, 0 }, 0);
+    Clay_BeginLayout();
+    CLAY({ .id = CLAY_ID("Row"), .layout = { .sizing = { CLAY_SIZING_FIXED(row->width), CLAY_SIZING_FIXED(20) }, .padding = { (uint16_t)row->padding, (uint16_t)row->padding }, .childGap = (uint16_t)row->childGap } }) {
+        for (int32_t i = 0; i < row->childCount; ++i) {
+            Child *child = &row->children[i];
+            Clay_SizingAxis width = child->type == CHILD_FIXED ? CLAY_SIZING_FIXED(child->contentWidth)
+                : child->type == CHILD_FIT ? CLAY_SIZING_FIT(child->min, child->max)
+                : CLAY_SIZING_GROW(child->min, child->max);
+            CLAY({ .id = CLAY_IDI("Child", i), .layout = { .sizing = { width, CLAY_SIZING_FIXED(10) } }, .clip = { .horizontal = child->clip } }) {
+                CLAY({ .layout = { .sizing = { CLAY_SIZING_FIXED(child->contentWidth), CLAY_SIZING_FIXED(10) } } }) {}
+            }
+        }
+    }
+    Clay_EndLayout();
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 4096, 4096 }, (Clay_ErrorHandler) { HandleClayErrors });
+
+    static Row row;
+    float sizes[MAX_CHILD_COUNT], minSizes[MAX_CHILD_COUNT], maxSizes[MAX_CHILD_COUNT];
+    float largestDifference = 0;
+    int32_t childCount = 0, failures = 0;
+    for (int32_t rowIndex = 0; rowIndex < ROW_COUNT; ++rowIndex) {
+        GenerateRow(&row);
+        LayoutRow(&row);
+        InitialWidths(&row, sizes, minSizes, maxSizes);
+        ReferenceDistribute(&row, sizes, minSizes, maxSizes);
+        for (int32_t i = 0; i < row.childCount; ++i) {
+            float width = Clay_GetElementData(CLAY_IDI("Child", i)).boundingBox.width;
+            float difference = fabsf(width - sizes[i]);
+            largestDifference = CLAY__MAX(largestDifference, difference);
+            if (difference > MAX_DIFFERENCE && failures++ < 10) {
+                printf("row %d child %d: width %f, the previous implementation gave %f\n", rowIndex, i, width, sizes[i]);
+            }
+        }
+        childCount += row.childCount;
+    }
+    printf("%d rows, %d children: largest difference from the previous implementation %.4fpx, %d over %.2fpx\n",
+        ROW_COUNT, childCount, largestDifference, failures, MAX_DIFFERENCE);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// Draws render commands with renderers/GLES3 into an offscreen framebuffer of a surfaceless EGL context, and checks pixels.
+// Covers rounded corners, border holes, a textured image, TEXT commands passed to the callback in order, and nested clip
+// elements, where the inner scissor is intersected with the outer one and the outer one is restored when the inner one ends.
+// Exits with 77, which CTest reports as skipped, when no EGL display or GLES 3 context is available.
+#include "../../renderers/GLES3/clay_renderer_GLES3.c"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <string.h>
+
+#define WIDTH 320
+#define HEIGHT 240
+#define SKIPPED 77
+
+static int32_t failures = 0;
+static uint8_t pixels[HEIGHT][WIDTH][4];
+
+static bool CreateContext(void) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL) : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL) || !eglBindAPI(EGL_OPENGL_ES_API)) {
+        return false;
+    }
+    EGLint contextAttributes[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_NONE };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+    return context != EGL_NO_CONTEXT && eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+}
+
+static Clay_RenderCommand *Add(Clay_RenderCommand *commands, int32_t *count, Clay_RenderCommandType commandType, float x, float y, float width, float height, Clay_Color color) {
+    Clay_RenderCommand *renderCommand = &commands[(*count)++];
+    memset(renderCommand, 0, sizeof(*renderCommand));
+    renderCommand->commandType = commandType;
+    renderCommand->boundingBox = (Clay_BoundingBox) { x, y, width, height };
+    renderCommand->renderData.rectangle.backgroundColor = color;
+    return renderCommand;
+}
+
+static void CheckPixel(const char *what, int x, int y, uint8_t r, uint8_t g, uint8_t b) {
+    // Rows are read bottom up
+    uint8_t *pixel = pixels[HEIGHT - 1 - y][x];
+    if (pixel[0] != r || pixel[1] != g || pixel[2] != b) {
+        printf("%s: pixel %d, %d is %d %d %d, expected %d %d %d\n", what, x, y, pixel[0], pixel[1], pixel[2], r, g, b);
+        failures++;
+    }
+}
+
+typedef struct {
+    int32_t calls;
+    uint32_t lastId;
+} TextCalls;
+
+// Stands in for a text renderer, and leaves GL state the renderer has to restore
+static void RenderText(Clay_RenderCommand *renderCommand, void *userData) {
+    TextCalls *textCalls = (TextCalls *)userData;
+    textCalls->calls++;
+    textCalls->lastId = renderCommand->id;
+    glUseProgram(0);
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+}
+
+int main(void) {
+    if (!CreateContext()) {
+        printf("no EGL display with OpenGL ES 3, skipping\n");
+        return SKIPPED;
+    }
+    GLuint framebuffer, renderbuffer;
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+    glViewport(0, 0, WIDTH, HEIGHT);
+
+    static const uint8_t cyan[4 * 4] = { 0, 255, 255, 255, 0, 255, 255, 255, 0, 255, 255, 255, 0, 255, 255, 255 };
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, cyan);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    TextCalls textCalls = { 0, 0 };
+    Clay_GLES3RendererData rendererData = { .renderCommandFunction = RenderText, .userData = &textCalls };
+    if (!Clay_GLES3_Initialize(&rendererData)) {
+        return 1;
+    }
+
+    Clay_RenderCommand commands[32];
+    int32_t count = 0;
+    Clay_Color red = { 255, 0, 0, 255 }, green = { 0, 255, 0, 255 }, blue = { 0, 0, 255, 255 }, yellow = { 255, 255, 0, 255 }, magenta = { 255, 0, 255, 255 };
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 10, 10, 100, 100, red)->renderData.rectangle.cornerRadius = (Clay_CornerRadius) { 20, 20, 20, 20 };
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_BORDER, 130, 10, 100, 100, green)->renderData.border.width = (Clay_BorderWidth) { 10, 10, 10, 10, 0 };
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_IMAGE, 250, 10, 40, 40, (Clay_Color) { 0 })->renderData.image.imageData = &texture;
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_TEXT, 250, 60, 40, 20, (Clay_Color) { 0 })->id = 1234;
+    // Drawn after the text callback has changed the GL state
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 250, 90, 40, 20, blue);
+    // An outer clip element, and an inner one that reaches outside it
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, 10, 130, 100, 100, (Clay_Color) { 0 });
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, 60, 130, 100, 100, (Clay_Color) { 0 });
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 0, 120, 300, 120, blue);
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0, (Clay_Color) { 0 });
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 0, 120, 40, 120, yellow);
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0, (Clay_Color) { 0 });
+    Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 200, 130, 20, 20, magenta);
+
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+    Clay_GLES3_Render(&rendererData, (Clay_RenderCommandArray) { .capacity = count, .length = count, .internalArray = commands }, WIDTH, HEIGHT, 1);
+    glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        printf("GL error %x\n", error);
+        failures++;
+    }
+
+    CheckPixel("rectangle", 60, 60, 255, 0, 0);
+    CheckPixel("rounded corner", 12, 12, 0, 0, 0);
+    CheckPixel("square part of a rounded rectangle", 12, 60, 255, 0, 0);
+    CheckPixel("border", 135, 60, 0, 255, 0);
+    CheckPixel("inside a border", 180, 60, 0, 0, 0);
+    CheckPixel("image", 270, 30, 0, 255, 255);
+    CheckPixel("after text", 270, 100, 0, 0, 255);
+    CheckPixel("inside both clip elements", 80, 180, 0, 0, 255);
+    CheckPixel("inside the inner clip element only", 130, 180, 0, 0, 0);
+    CheckPixel("outer clip element after the inner one ends", 20, 180, 255, 255, 0);
+    CheckPixel("outside the outer clip element", 5, 180, 0, 0, 0);
+    CheckPixel("after both clip elements end", 210, 140, 255, 0, 255);
+    if (textCalls.calls != 1 || textCalls.lastId != 1234) {
+        printf("text callback was called %d times\n", textCalls.calls);
+        failures++;
+    }
+
+    // A frame larger than the arrays allocated so far
+    count = 0;
+    for (int32_t i = 0; i < 30; ++i) {
+        Add(commands, &count, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, (float)(i * 10), 0, 10, 10, (Clay_Color) { 0, 0, (float)(i * 8), 255 });
+    }
+    glClear(GL_COLOR_BUFFER_BIT);
+    Clay_GLES3_Render(&rendererData, (Clay_RenderCommandArray) { .capacity = count, .length = count, .internalArray = commands }, WIDTH, HEIGHT, 1);
+    glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    CheckPixel("last rectangle of a larger frame", 295, 5, 0, 0, 232);
+
+    Clay_GLES3_Shutdown(&rendererData);
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,264 @@
+// Builds vertex buffers from hand written render commands and from a layout, and checks the vertices, indices and draw ranges.
+// Covers quad contents, how draw ranges split on images, scissors and text, nested scissors that are intersected and restored,
+// nesting deeper than the scissor stack, and arrays that are too small. Built twice by CMake, with and without CLAY_DISABLE_SIMD.
+// Exits with a non zero status if anything differs.
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+// Small enough that the test can nest past it
+#define CLAY_VERTEX_BUFFER_MAX_SCISSOR_DEPTH 4
+#define CLAY_VERTEX_BUFFER_IMPLEMENTATION
+#include "../../renderers/vertex/clay_vertex_buffer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_COMMANDS 64
+#define MAX_OUTPUT 256
+
+static int32_t failures = 0;
+
+#define CHECK(condition, ...) do { if (!(condition)) { printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } } while (0)
+
+typedef struct {
+    Clay_RenderCommand commands[MAX_COMMANDS];
+    int32_t count;
+} CommandList;
+
+static Clay_RenderCommand *Add(CommandList *list, Clay_RenderCommandType commandType, float x, float y, float width, float height) {
+    Clay_RenderCommand *renderCommand = &list->commands[list->count++];
+    memset(renderCommand, 0, sizeof(*renderCommand));
+    renderCommand->commandType = commandType;
+    renderCommand->boundingBox = (Clay_BoundingBox) { x, y, width, height };
+    return renderCommand;
+}
+
+static void AddRectangle(CommandList *list, float x, float y, float width, float height) {
+    Add(list, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, x, y, width, height)->renderData.rectangle.backgroundColor = (Clay_Color) { 255, 255, 255, 255 };
+}
+
+static Clay_RenderCommandArray Commands(CommandList *list) {
+    return (Clay_RenderCommandArray) { .capacity = list->count, .length = list->count, .internalArray = list->commands };
+}
+
+static Clay_Vertex vertices[MAX_OUTPUT];
+static uint32_t indices[MAX_OUTPUT];
+static Clay_VertexDrawRange drawRanges[MAX_OUTPUT];
+
+static Clay_VertexBuffer Build(Clay_RenderCommandArray renderCommands) {
+    Clay_VertexBuffer buffer = { vertices, MAX_OUTPUT, 0, indices, MAX_OUTPUT, 0, drawRanges, MAX_OUTPUT, 0 };
+    CHECK(Clay_VertexBuffer_Build(&buffer, renderCommands), "build failed with room to spare");
+    return buffer;
+}
+
+static bool SameBox(Clay_BoundingBox a, Clay_BoundingBox b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+static void CheckScissor(Clay_VertexDrawRange *range, int32_t index, bool enabled, Clay_BoundingBox expected) {
+    CHECK(range->scissorEnabled == enabled, "range %d: scissor %s, expected %s", index, range->scissorEnabled ? "enabled" : "disabled", enabled ? "enabled" : "disabled");
+    if (enabled && range->scissorEnabled) {
+        CHECK(SameBox(range->scissor, expected), "range %d: scissor { %g, %g, %g, %g }, expected { %g, %g, %g, %g }", index,
+            range->scissor.x, range->scissor.y, range->scissor.width, range->scissor.height, expected.x, expected.y, expected.width, expected.height);
+    }
+}
+
+static void TestQuad(void) {
+    CommandList list = { .count = 0 };
+    Clay_RenderCommand *renderCommand = Add(&list, CLAY_RENDER_COMMAND_TYPE_RECTANGLE, 10, 20, 30, 40);
+    renderCommand->renderData.rectangle = (Clay_RectangleRenderData) { .backgroundColor = { 255, 127.6f, -5, 300 }, .cornerRadius = { .topLeft = 1, .topRight = 100, .bottomLeft = 3, .bottomRight = 4 } };
+    Clay_VertexBuffer buffer = Build(Commands(&list));
+    CHECK(buffer.vertexCount == 4 && buffer.indexCount == 6 && buffer.drawRangeCount == 1, "got %d vertices, %d indices, %d ranges", buffer.vertexCount, buffer.indexCount, buffer.drawRangeCount);
+    // Top left, top right, bottom right, bottom left
+    static const float expected[4][6] = { { 10, 20, 0, 0, -15, -20 }, { 40, 20, 1, 0, 15, -20 }, { 40, 60, 1, 1, 15, 20 }, { 10, 60, 0, 1, -15, 20 } };
+    for (int32_t i = 0; i < 4; ++i) {
+        Clay_Vertex *vertex = &buffer.vertices[i];
+        const float *e = expected[i];
+        CHECK(vertex->x == e[0] && vertex->y == e[1] && vertex->u == e[2] && vertex->v == e[3] && vertex->localX == e[4] && vertex->localY == e[5],
+            "vertex %d: %g %g %g %g %g %g", i, vertex->x, vertex->y, vertex->u, vertex->v, vertex->localX, vertex->localY);
+        CHECK(vertex->halfWidth == 15 && vertex->halfHeight == 20, "vertex %d: half size %g %g", i, vertex->halfWidth, vertex->halfHeight);
+        // Radii are clamped to half the smaller side and stored clockwise from the top left
+        CHECK(vertex->cornerRadius[0] == 1 && vertex->cornerRadius[1] == 15 && vertex->cornerRadius[2] == 4 && vertex->cornerRadius[3] == 3,
+            "vertex %d: radii %g %g %g %g", i, vertex->cornerRadius[0], vertex->cornerRadius[1], vertex->cornerRadius[2], vertex->cornerRadius[3]);
+        CHECK(vertex->borderWidth[0] == 0 && vertex->borderWidth[1] == 0 && vertex->borderWidth[2] == 0 && vertex->borderWidth[3] == 0, "vertex %d: filled quads have no border", i);
+        CHECK(vertex->color[0] == 255 && vertex->color[1] == 128 && vertex->color[2] == 0 && vertex->color[3] == 255,
+            "vertex %d: color %d %d %d %d", i, vertex->color[0], vertex->color[1], vertex->color[2], vertex->color[3]);
+    }
+    static const uint32_t expectedIndices[6] = { 0, 1, 2, 0, 2, 3 };
+    CHECK(memcmp(buffer.indices, expectedIndices, sizeof(expectedIndices)) == 0, "unexpected indices");
+    Clay_VertexDrawRange *range = &buffer.drawRanges[0];
+    CHECK(range->indexStart == 0 && range->indexCount == 6 && range->imageData == NULL && range->renderCommandIndex == -1 && !range->scissorEnabled, "unexpected draw range");
+}
+
+static void TestDrawRanges(void) {
+    static int imageA, imageB;
+    CommandList list = { .count = 0 };
+    AddRectangle(&list, 0, 0, 10, 10);
+    AddRectangle(&list, 10, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_IMAGE, 0, 10, 10, 10)->renderData.image.imageData = &imageA;
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_IMAGE, 10, 10, 10, 10)->renderData.image = (Clay_ImageRenderData) { .backgroundColor = { 1, 2, 3, 4 }, .imageData = &imageA };
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_IMAGE, 20, 10, 10, 10)->renderData.image.imageData = &imageB;
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_TEXT, 0, 20, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_BORDER, 0, 30, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_BORDER, 0, 30, 10, 10)->renderData.border = (Clay_BorderRenderData) { .color = { 9, 9, 9, 9 }, .width = { .left = 1, .right = 2, .top = 3, .bottom = 4, .betweenChildren = 5 } };
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_CUSTOM, 0, 40, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_LAYER_BEGIN, 0, 0, 0, 0);
+    AddRectangle(&list, 0, 50, 10, 10);
+    Clay_VertexBuffer buffer = Build(Commands(&list));
+
+    // { indexStart, indexCount, image, renderCommandIndex }
+    struct { uint32_t indexStart, indexCount; void *imageData; int32_t renderCommandIndex; } expected[] = {
+        { 0, 12, NULL, -1 }, { 12, 12, &imageA, -1 }, { 24, 6, &imageB, -1 }, { 30, 0, NULL, 5 }, { 30, 6, NULL, -1 }, { 36, 0, NULL, 8 }, { 36, 6, NULL, -1 },
+    };
+    int32_t expectedCount = (int32_t)(sizeof(expected) / sizeof(expected[0]));
+    CHECK(buffer.drawRangeCount == expectedCount, "got %d draw ranges, expected %d", buffer.drawRangeCount, expectedCount);
+    for (int32_t i = 0; i < buffer.drawRangeCount && i < expectedCount; ++i) {
+        Clay_VertexDrawRange *range = &buffer.drawRanges[i];
+        CHECK(range->indexStart == expected[i].indexStart && range->indexCount == expected[i].indexCount && range->imageData == expected[i].imageData && range->renderCommandIndex == expected[i].renderCommandIndex,
+            "range %d: %u %u %p %d", i, range->indexStart, range->indexCount, range->imageData, range->renderCommandIndex);
+    }
+    // An image with no tint is drawn white, a tinted one keeps its color
+    CHECK(buffer.vertices[8].color[0] == 255 && buffer.vertices[8].color[3] == 255, "untinted image isn't white");
+    CHECK(buffer.vertices[12].color[0] == 1 && buffer.vertices[12].color[3] == 4, "tinted image lost its tint");
+    // The border without any width is skipped, the other one stores left, top, right, bottom
+    Clay_Vertex *border = &buffer.vertices[20];
+    CHECK(border->borderWidth[0] == 1 && border->borderWidth[1] == 3 && border->borderWidth[2] == 2 && border->borderWidth[3] == 4,
+        "border widths %g %g %g %g", border->borderWidth[0], border->borderWidth[1], border->borderWidth[2], border->borderWidth[3]);
+}
+
+static void TestNestedScissors(void) {
+    CommandList list = { .count = 0 };
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, 0, 0, 100, 100);
+    AddRectangle(&list, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, 50, 60, 100, 100);
+    AddRectangle(&list, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, 200, 200, 10, 10);
+    AddRectangle(&list, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0);
+    AddRectangle(&list, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0);
+    AddRectangle(&list, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0);
+    AddRectangle(&list, 0, 0, 10, 10);
+    // An unmatched end leaves the scissor disabled
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0);
+    AddRectangle(&list, 0, 0, 10, 10);
+    Clay_VertexBuffer buffer = Build(Commands(&list));
+
+    CHECK(buffer.drawRangeCount == 6, "got %d draw ranges, expected 6", buffer.drawRangeCount);
+    Clay_BoundingBox outer = { 0, 0, 100, 100 }, inner = { 50, 60, 50, 40 }, empty = { 200, 200, 0, 0 };
+    CheckScissor(&buffer.drawRanges[0], 0, true, outer);
+    CheckScissor(&buffer.drawRanges[1], 1, true, inner);
+    // A scissor that doesn't overlap the enclosing one clips everything
+    CHECK(buffer.drawRanges[2].scissorEnabled && buffer.drawRanges[2].scissor.width == 0 && buffer.drawRanges[2].scissor.height == 0, "disjoint scissors don't intersect to nothing");
+    CheckScissor(&buffer.drawRanges[3], 3, true, inner);
+    CheckScissor(&buffer.drawRanges[4], 4, true, outer);
+    // The last two rectangles share a range, as neither is clipped
+    CheckScissor(&buffer.drawRanges[5], 5, false, empty);
+    CHECK(buffer.drawRanges[5].indexCount == 12, "unclipped rectangles weren't merged");
+}
+
+static void TestScissorDepthLimit(void) {
+    CommandList list = { .count = 0 };
+    // Each level is one unit smaller on every side, six levels deep with room for four on the stack
+    for (int32_t i = 0; i < 6; ++i) {
+        Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_START, (float)i, (float)i, 100 - 2 * (float)i, 100 - 2 * (float)i);
+    }
+    AddRectangle(&list, 0, 0, 10, 10);
+    for (int32_t i = 6; i > 0; --i) {
+        Add(&list, CLAY_RENDER_COMMAND_TYPE_SCISSOR_END, 0, 0, 0, 0);
+        AddRectangle(&list, 0, 0, 10, 10);
+    }
+    Clay_VertexBuffer buffer = Build(Commands(&list));
+    CHECK(buffer.drawRangeCount == 5, "got %d draw ranges, expected 5", buffer.drawRangeCount);
+    // Levels past the stack keep the deepest scissor until the depth is back within it, after that each end restores exactly
+    Clay_BoundingBox deepest = { 5, 5, 90, 90 };
+    CheckScissor(&buffer.drawRanges[0], 0, true, deepest);
+    CHECK(buffer.drawRanges[0].indexCount == 18, "levels past the stack changed the scissor");
+    for (int32_t level = 2; level >= 0; --level) {
+        int32_t index = 3 - level;
+        CheckScissor(&buffer.drawRanges[index], index, true, (Clay_BoundingBox) { (float)level, (float)level, 100 - 2 * (float)level, 100 - 2 * (float)level });
+    }
+    CheckScissor(&buffer.drawRanges[4], 4, false, deepest);
+}
+
+void HandleClayErrors(Clay_ErrorData errorData) {
+    printf("%s\n", errorData.errorText.chars);
+}
+
+// Clip containers nested in a layout, where the inner one is scrolled partly outside the outer one
+static void TestLayoutScissors(void) {
+    Clay_BeginLayout();
+    CLAY({ .id = CLAY_ID("Outer"), .layout = { .sizing = { CLAY_SIZING_FIXED(200), CLAY_SIZING_FIXED(150) }, .padding = CLAY_PADDING_ALL(10) }, .clip = { .vertical = true, .childOffset = { 0, -20 } } }) {
+        CLAY({ .id = CLAY_ID("Inner"), .layout = { .sizing = { CLAY_SIZING_FIXED(120), CLAY_SIZING_FIXED(100) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }, .clip = { .horizontal = true, .childOffset = { -30, 0 } } }) {
+            CLAY({ .id = CLAY_ID("InnerBox"), .layout = { .sizing = { CLAY_SIZING_FIXED(300), CLAY_SIZING_FIXED(30) } }, .backgroundColor = { 255, 0, 0, 255 } }) {}
+        }
+        CLAY({ .id = CLAY_ID("OuterBox"), .layout = { .sizing = { CLAY_SIZING_FIXED(40), CLAY_SIZING_FIXED(300) } }, .backgroundColor = { 0, 255, 0, 255 } }) {}
+    }
+    CLAY({ .id = CLAY_ID("After"), .layout = { .sizing = { CLAY_SIZING_FIXED(10), CLAY_SIZING_FIXED(10) } }, .backgroundColor = { 0, 0, 255, 255 } }) {}
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+    Clay_VertexBuffer buffer = Build(renderCommands);
+
+    Clay_BoundingBox outer = Clay_GetElementData(CLAY_ID("Outer")).boundingBox;
+    Clay_BoundingBox inner = Clay_GetElementData(CLAY_ID("Inner")).boundingBox;
+    Clay_BoundingBox both = Clay_VertexBuffer__Intersect(outer, inner);
+    CHECK(!SameBox(both, inner), "the inner clip container should reach outside the outer one");
+    Clay_BoundingBox expected[] = { both, outer, { 0, 0, 0, 0 } };
+    bool expectedEnabled[] = { true, true, false };
+    CHECK(buffer.drawRangeCount == 3, "got %d draw ranges, expected 3", buffer.drawRangeCount);
+    for (int32_t i = 0; i < buffer.drawRangeCount && i < 3; ++i) {
+        CheckScissor(&buffer.drawRanges[i], i, expectedEnabled[i], expected[i]);
+    }
+}
+
+static void TestCapacity(void) {
+    CommandList list = { .count = 0 };
+    static int image;
+    AddRectangle(&list, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_TEXT, 0, 0, 10, 10);
+    Add(&list, CLAY_RENDER_COMMAND_TYPE_IMAGE, 0, 0, 10, 10)->renderData.image.imageData = &image;
+    AddRectangle(&list, 0, 0, 10, 10);
+    AddRectangle(&list, 5, 0, 10, 10);
+    Clay_VertexBuffer reference = Build(Commands(&list));
+    int32_t vertexCount = reference.vertexCount, indexCount = reference.indexCount, drawRangeCount = reference.drawRangeCount;
+    Clay_Vertex expectedVertices[MAX_OUTPUT];
+    uint32_t expectedIndices[MAX_OUTPUT];
+    Clay_VertexDrawRange expectedRanges[MAX_OUTPUT];
+    memcpy(expectedVertices, vertices, sizeof(Clay_Vertex) * (size_t)vertexCount);
+    memcpy(expectedIndices, indices, sizeof(uint32_t) * (size_t)indexCount);
+    memcpy(expectedRanges, drawRanges, sizeof(Clay_VertexDrawRange) * (size_t)drawRangeCount);
+
+    // Each array one element short in turn, then all of them empty. Nothing may be written past the capacity.
+    for (int32_t shortArray = 0; shortArray < 4; ++shortArray) {
+        memset(vertices, 0xab, sizeof(vertices));
+        memset(indices, 0xab, sizeof(indices));
+        memset(drawRanges, 0xab, sizeof(drawRanges));
+        Clay_VertexBuffer buffer = { vertices, shortArray == 0 ? vertexCount - 1 : shortArray == 3 ? 0 : vertexCount, 0,
+            indices, shortArray == 1 ? indexCount - 1 : shortArray == 3 ? 0 : indexCount, 0, drawRanges, shortArray == 2 ? drawRangeCount - 1 : shortArray == 3 ? 0 : drawRangeCount, 0 };
+        CHECK(!Clay_VertexBuffer_Build(&buffer, Commands(&list)), "case %d: build succeeded with a short array", shortArray);
+        CHECK(buffer.vertexCount == vertexCount && buffer.indexCount == indexCount && buffer.drawRangeCount == drawRangeCount,
+            "case %d: required sizes %d %d %d, expected %d %d %d", shortArray, buffer.vertexCount, buffer.indexCount, buffer.drawRangeCount, vertexCount, indexCount, drawRangeCount);
+        uint8_t *vertexBytes = (uint8_t *)&vertices[buffer.vertexCapacity], *indexBytes = (uint8_t *)&indices[buffer.indexCapacity], *rangeBytes = (uint8_t *)&drawRanges[buffer.drawRangeCapacity];
+        CHECK(vertexBytes[0] == 0xab && indexBytes[0] == 0xab && rangeBytes[0] == 0xab, "case %d: wrote past the end of an array", shortArray);
+    }
+
+    Clay_VertexBuffer exact = { vertices, vertexCount, 0, indices, indexCount, 0, drawRanges, drawRangeCount, 0 };
+    CHECK(Clay_VertexBuffer_Build(&exact, Commands(&list)), "build failed with arrays of exactly the required size");
+    CHECK(memcmp(vertices, expectedVertices, sizeof(Clay_Vertex) * (size_t)vertexCount) == 0 && memcmp(indices, expectedIndices, sizeof(uint32_t) * (size_t)indexCount) == 0
+        && memcmp(drawRanges, expectedRanges, sizeof(Clay_VertexDrawRange) * (size_t)drawRangeCount) == 0, "output differs when built into arrays of exactly the required size");
+}
+
+int main(void) {
+    uint64_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1024, 768 }, (Clay_ErrorHandler) { HandleClayErrors });
+
+    TestQuad();
+    TestDrawRanges();
+    TestNestedScissors();
+    TestScissorDepthLimit();
+    TestLayoutScissors();
+    TestCapacity();
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}